@@ -6,8 +6,10 @@
 #include "skyline/loader/loader.h"
 #include "skyline/common.h"
 #include "skyline/os.h"
+#include "skyline/nce.h"
 #include "skyline/jvm.h"
 #include "skyline/input.h"
+#include "skyline/gpu.h"
 
 bool Halt;
 jobject Surface;
@@ -15,7 +17,11 @@ uint FaultCount;
 skyline::GroupMutex JniMtx;
 skyline::u16 fps;
 skyline::u32 frametime;
+skyline::u32 dequeueWaitTime;
 std::weak_ptr<skyline::input::Input> inputWeak;
+std::weak_ptr<skyline::kernel::SvcProfiler> svcProfilerWeak;
+std::weak_ptr<skyline::gpu::GPU> gpuWeak;
+std::weak_ptr<skyline::kernel::AffinityManager> affinityWeak;
 
 void signalHandler(int signal) {
     syslog(LOG_ERR, "Halting program due to signal: %s", strsignal(signal));
@@ -31,6 +37,7 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     FaultCount = 0;
     fps = 0;
     frametime = 0;
+    dequeueWaitTime = 0;
 
     std::signal(SIGTERM, signalHandler);
     std::signal(SIGSEGV, signalHandler);
@@ -53,6 +60,9 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     try {
         skyline::kernel::OS os(jvmManager, logger, settings, std::string(appFilesPath));
         inputWeak = os.state.input;
+        svcProfilerWeak = os.state.nce->svcProfiler;
+        gpuWeak = os.state.gpu;
+        affinityWeak = os.affinity;
         jvmManager->InitializeControllers();
         env->ReleaseStringUTFChars(appFilesPathJstring, appFilesPath);
 
@@ -68,6 +78,9 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     }
 
     inputWeak.reset();
+    svcProfilerWeak.reset();
+    gpuWeak.reset();
+    affinityWeak.reset();
 
     logger->Info("Emulation has ended");
 
@@ -100,6 +113,69 @@ extern "C" JNIEXPORT jfloat Java_emu_skyline_EmulationActivity_getFrametime(JNIE
     return static_cast<float>(frametime) / 100;
 }
 
+extern "C" JNIEXPORT jfloat Java_emu_skyline_EmulationActivity_getDequeueWaitTime(JNIEnv *, jobject) {
+    return static_cast<float>(dequeueWaitTime) / 100;
+}
+
+extern "C" JNIEXPORT jlongArray Java_emu_skyline_EmulationActivity_getFrameStatistics(JNIEnv *env, jobject) {
+    auto gpu = gpuWeak.lock();
+    if (!gpu)
+        return env->NewLongArray(0);
+
+    auto statistics = gpu->GetFrameStatistics();
+    std::array<jlong, 6> values{
+        static_cast<jlong>(statistics.vsyncCount),
+        static_cast<jlong>(statistics.missedVsyncs),
+        static_cast<jlong>(statistics.maxVsyncLateness),
+        static_cast<jlong>(statistics.frameCount),
+        static_cast<jlong>(statistics.averageFrametime),
+        static_cast<jlong>(statistics.maxFrametime),
+    };
+
+    auto array = env->NewLongArray(static_cast<jsize>(values.size()));
+    env->SetLongArrayRegion(array, 0, static_cast<jsize>(values.size()), values.data());
+    return array;
+}
+
+extern "C" JNIEXPORT jlongArray Java_emu_skyline_EmulationActivity_getThreadMigrations(JNIEnv *env, jobject) {
+    auto affinity = affinityWeak.lock();
+    if (!affinity)
+        return env->NewLongArray(0);
+
+    auto counts = affinity->GetMigrationCounts();
+    std::vector<jlong> values;
+    values.reserve(counts.size() * 2);
+    for (const auto &[tid, count] : counts) {
+        values.push_back(tid);
+        values.push_back(static_cast<jlong>(count));
+    }
+
+    auto array = env->NewLongArray(static_cast<jsize>(values.size()));
+    env->SetLongArrayRegion(array, 0, static_cast<jsize>(values.size()), values.data());
+    return array;
+}
+
+extern "C" JNIEXPORT jlongArray Java_emu_skyline_EmulationActivity_getSvcStatistics(JNIEnv *env, jobject) {
+    constexpr size_t SvcStride = 2 + skyline::constant::SvcLatencyBuckets; // The amount of values written for every SVC: Calls, Total Time and the Histogram
+
+    auto svcProfiler = svcProfilerWeak.lock();
+    if (!svcProfiler)
+        return env->NewLongArray(0);
+
+    auto statistics = svcProfiler->Collect();
+    std::vector<jlong> values(statistics.size() * SvcStride);
+    for (size_t svc{}; svc < statistics.size(); svc++) {
+        auto value = values.begin() + static_cast<ssize_t>(svc * SvcStride);
+        *value++ = static_cast<jlong>(statistics[svc].calls);
+        *value++ = static_cast<jlong>(statistics[svc].totalTime);
+        std::copy(statistics[svc].histogram.begin(), statistics[svc].histogram.end(), value);
+    }
+
+    auto array = env->NewLongArray(static_cast<jsize>(values.size()));
+    env->SetLongArrayRegion(array, 0, static_cast<jsize>(values.size()), values.data());
+    return array;
+}
+
 extern "C" JNIEXPORT void JNICALL Java_emu_skyline_EmulationActivity_setController(JNIEnv *, jobject, jint index, jint type, jint partnerIndex) {
     auto input = inputWeak.lock();
     std::lock_guard guard(input->npad.mutex);
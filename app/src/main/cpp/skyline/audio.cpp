@@ -19,8 +19,13 @@ namespace skyline::audio {
     std::shared_ptr<AudioTrack> Audio::OpenTrack(u8 channelCount, u32 sampleRate, const std::function<void()> &releaseCallback) {
         std::lock_guard trackGuard(trackLock);
 
+        auto slot{std::find(trackSlots.begin(), trackSlots.end(), nullptr)};
+        if (slot == trackSlots.end())
+            throw exception("Cannot open more than {} audio tracks", constant::MaxTrackCount);
+
         auto track{std::make_shared<AudioTrack>(channelCount, sampleRate, releaseCallback)};
         audioTracks.push_back(track);
+        slot->store(track.get(), std::memory_order_release);
 
         return track;
     }
@@ -28,6 +33,17 @@ namespace skyline::audio {
     void Audio::CloseTrack(std::shared_ptr<AudioTrack> &track) {
         std::lock_guard trackGuard(trackLock);
 
+        auto slot{std::find(trackSlots.begin(), trackSlots.end(), track.get())};
+        if (slot != trackSlots.end()) {
+            slot->store(nullptr, std::memory_order_seq_cst);
+
+            // A callback which started before the slot was cleared might still be mixing the track, it's only safe to free it once that callback is done
+            auto sequence{mixSequence.load(std::memory_order_seq_cst)};
+            if (sequence & 1)
+                while (mixSequence.load(std::memory_order_acquire) == sequence)
+                    std::this_thread::yield();
+        }
+
         audioTracks.erase(std::remove(audioTracks.begin(), audioTracks.end(), track), audioTracks.end());
         track.reset();
     }
@@ -35,30 +51,36 @@ namespace skyline::audio {
     oboe::DataCallbackResult Audio::onAudioReady(oboe::AudioStream *audioStream, void *audioData, int32_t numFrames) {
         auto destBuffer{static_cast<i16 *>(audioData)};
         auto streamSamples{static_cast<size_t>(numFrames) * audioStream->getChannelCount()};
-        size_t writtenSamples{};
 
-        {
-            std::lock_guard trackGuard(trackLock);
+        mixSequence.fetch_add(1, std::memory_order_seq_cst);
+
+        std::memset(destBuffer, 0, streamSamples * sizeof(i16));
 
-            for (auto &track : audioTracks) {
-                if (track->playbackState == AudioOutState::Stopped)
-                    continue;
+        for (auto &slot : trackSlots) {
+            auto track{slot.load(std::memory_order_seq_cst)};
+            if (!track || track->playbackState == AudioOutState::Stopped)
+                continue;
 
-                std::lock_guard bufferGuard(track->bufferLock);
+            size_t trackSamples{};
+            while (trackSamples < streamSamples) {
+                auto readSamples{track->samples.Read(trackBuffer.data(), static_cast<ssize_t>(std::min(trackBuffer.size(), streamSamples - trackSamples)))};
+                if (!readSamples)
+                    break;
 
-                auto trackSamples = track->samples.Read(destBuffer, streamSamples, [](i16 *source, i16 *destination) {
-                    *destination = Saturate<i16, i32>(static_cast<u32>(*destination) + static_cast<u32>(*source));
-                }, writtenSamples);
+                MixSamples(destBuffer + trackSamples, trackBuffer.data(), readSamples);
+                trackSamples += readSamples;
+            }
 
-                writtenSamples = std::max(trackSamples, writtenSamples);
+            track->sampleCounter += trackSamples;
 
-                track->sampleCounter += trackSamples;
+            // If a guest thread is appending to the track then released buffers are checked during the next callback rather than blocking on it
+            if (track->bufferLock.try_lock()) {
                 track->CheckReleasedBuffers();
+                track->bufferLock.unlock();
             }
         }
 
-        if (streamSamples > writtenSamples)
-            memset(destBuffer + writtenSamples, 0, (streamSamples - writtenSamples) * sizeof(i16));
+        mixSequence.fetch_add(1, std::memory_order_release);
 
         return oboe::DataCallbackResult::Continue;
     }
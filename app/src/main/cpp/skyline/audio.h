@@ -10,6 +10,12 @@
 #include <audio/track.h>
 #include "common.h"
 
+namespace skyline {
+    namespace constant {
+        constexpr u8 MaxTrackCount{32}; //!< The maximum amount of audio tracks that can be open at once
+    }
+}
+
 namespace skyline::audio {
     /**
      * @brief The Audio class is used to mix audio from all tracks
@@ -18,8 +24,11 @@ namespace skyline::audio {
       private:
         oboe::AudioStreamBuilder builder; //!< The audio stream builder, used to open
         oboe::ManagedStream outputStream; //!< The output oboe audio stream
-        std::vector<std::shared_ptr<AudioTrack>> audioTracks; //!< A vector of shared_ptr to every open audio track
-        Mutex trackLock; //!< This mutex is used to ensure that audioTracks isn't modified while it is being used
+        std::vector<std::shared_ptr<AudioTrack>> audioTracks; //!< A vector of shared_ptr to every open audio track, this is only accessed by OpenTrack and CloseTrack
+        std::mutex trackLock; //!< This mutex is used to serialize modifications to audioTracks and trackSlots, it's never locked by the audio callback
+        std::array<std::atomic<AudioTrack *>, constant::MaxTrackCount> trackSlots{}; //!< A lock-free snapshot of every open track which is read by the audio callback, empty slots are nullptr
+        std::atomic<u64> mixSequence{}; //!< A counter which is incremented at the start and end of every audio callback, it's odd while a callback is running
+        std::array<i16, constant::MixBufferSize * constant::ChannelCount> trackBuffer{}; //!< A buffer for samples of a single track before they're mixed into the output, this is only used by the audio callback
 
       public:
         Audio(const DeviceState &state);
@@ -36,6 +45,7 @@ namespace skyline::audio {
         /**
          * @brief Closes a track and frees its data
          * @param track The track to close
+         * @note This waits for an audio callback that might be mixing the track to finish
          */
         void CloseTrack(std::shared_ptr<AudioTrack> &track);
 
@@ -4,150 +4,74 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <span>
 #include <common.h>
 
 namespace skyline::audio {
     /**
-     * @brief This class is used to abstract an array into a circular buffer
+     * @brief This class is used to abstract an array into a lock-free single-producer single-consumer circular buffer
      * @tparam Type The type of elements stored in the buffer
      * @tparam Size The maximum size of the circular buffer
+     * @note Only a single thread may read from the buffer and only a single thread may append to it at a time, this allows reading from a real-time thread without it ever waiting on the writer
      */
     template<typename Type, size_t Size>
     class CircularBuffer {
       private:
         std::array<Type, Size> array{}; //!< The internal array holding the circular buffer
-        Type *start{array.begin()}; //!< The start/oldest element of the internal array
-        Type *end{array.begin()}; //!< The end/newest element of the internal array
-        bool empty{true}; //!< This boolean is used to differentiate between the buffer being full or empty
-        Mutex mtx; //!< The mutex ensures that the buffer operations don't overlap
+        std::atomic<size_t> readIndex{}; //!< The total amount of elements that have been read from the buffer, this is only modified by the reader
+        std::atomic<size_t> writeIndex{}; //!< The total amount of elements that have been appended to the buffer, this is only modified by the writer
 
       public:
         /**
          * @brief This reads data from this buffer into the specified buffer
          * @param address The address to write buffer data into
          * @param maxSize The maximum amount of data to write in units of Type
-         * @param copyFunction If this is specified, then this is called rather than memcpy
          * @return The amount of data written into the input buffer in units of Type
          */
-        inline size_t Read(Type *address, ssize_t maxSize, void copyFunction(Type *, Type *) = {}, ssize_t copyOffset = -1) {
-            std::lock_guard guard(mtx);
-
-            if (empty)
+        inline size_t Read(Type *address, ssize_t maxSize) {
+            auto read{readIndex.load(std::memory_order_relaxed)};
+            auto size{std::min(writeIndex.load(std::memory_order_acquire) - read, static_cast<size_t>(maxSize))};
+            if (!size)
                 return 0;
 
-            ssize_t size{}, sizeBegin{}, sizeEnd{};
-
-            if (start < end) {
-                sizeEnd = std::min(end - start, maxSize);
-
-                size = sizeEnd;
-            } else {
-                sizeEnd = std::min(array.end() - start, maxSize);
-                sizeBegin = std::min(end - array.begin(), maxSize - sizeEnd);
-
-                size = sizeBegin + sizeEnd;
-            }
-
-            if (copyFunction && copyOffset) {
-                auto sourceEnd = start + ((copyOffset != -1) ? copyOffset : sizeEnd);
-
-                for (auto source = start, destination = address; source < sourceEnd; source++, destination++)
-                    copyFunction(source, destination);
-
-                if (copyOffset != -1) {
-                    std::memcpy(address + copyOffset, start + copyOffset, (sizeEnd - copyOffset) * sizeof(Type));
-                    copyOffset -= sizeEnd;
-                }
-            } else {
-                std::memcpy(address, start, sizeEnd * sizeof(Type));
-            }
-
-            address += sizeEnd;
-
-            if (sizeBegin) {
-                if (copyFunction && copyOffset) {
-                    auto sourceEnd = array.begin() + ((copyOffset != -1) ? copyOffset : sizeBegin);
-
-                    for (auto source = array.begin(), destination = address; source < sourceEnd; source++, destination++)
-                        copyFunction(source, destination);
-
-                    if (copyOffset != -1)
-                        std::memcpy(array.begin() + copyOffset, address + copyOffset, (sizeBegin - copyOffset) * sizeof(Type));
-                } else {
-                    std::memcpy(address, array.begin(), sizeBegin * sizeof(Type));
-                }
-
-                start = array.begin() + sizeBegin;
-            } else {
-                start += sizeEnd;
-            }
+            auto offset{read % Size};
+            auto sizeEnd{std::min(size, Size - offset)};
+            std::memcpy(address, array.data() + offset, sizeEnd * sizeof(Type));
+            std::memcpy(address + sizeEnd, array.data(), (size - sizeEnd) * sizeof(Type));
 
-            if (start == end)
-                empty = true;
-
-            return static_cast<size_t>(size);
+            readIndex.store(read + size, std::memory_order_release); // The elements are only handed back to the writer after they have been copied out
+            return size;
         }
 
         /**
          * @brief This appends data from the specified buffer into this buffer
          * @param address The address of the buffer
          * @param size The size of the buffer in units of Type
+         * @return The amount of data that was appended in units of Type, this is less than the size if the buffer is full as data that hasn't been read can't be overwritten
          */
-        inline void Append(Type *address, ssize_t size) {
-            std::lock_guard guard(mtx);
-
-            while (size) {
-                if (start <= end && end != array.end()) {
-                    auto sizeEnd = std::min(array.end() - end, size);
-                    std::memcpy(end, address, sizeEnd * sizeof(Type));
-
-                    address += sizeEnd;
-                    size -= sizeEnd;
-
-                    end += sizeEnd;
-                } else {
-                    auto sizePreStart = (end == array.end()) ? std::min(start - array.begin(), size) : std::min(start - end, size);
-                    auto sizePostStart = std::min(array.end() - start, size - sizePreStart);
-
-                    if (sizePreStart)
-                        std::memcpy((end == array.end()) ? array.begin() : end, address, sizePreStart * sizeof(Type));
-
-                    if (end == array.end())
-                        end = array.begin() + sizePreStart;
-                    else
-                        end += sizePreStart;
-
-                    address += sizePreStart;
-                    size -= sizePreStart;
-
-                    if (sizePostStart)
-                        std::memcpy(end, address, sizePostStart * sizeof(Type));
-
-                    if (start == array.end())
-                        start = array.begin() + sizePostStart;
-                    else
-                        start += sizePostStart;
-
-                    if (end == array.end())
-                        end = array.begin() + sizePostStart;
-                    else
-                        end += sizePostStart;
+        inline size_t Append(const Type *address, ssize_t size) {
+            auto write{writeIndex.load(std::memory_order_relaxed)};
+            auto appendSize{std::min(Size - (write - readIndex.load(std::memory_order_acquire)), static_cast<size_t>(size))};
+            if (!appendSize)
+                return 0;
 
-                    address += sizePostStart;
-                    size -= sizePostStart;
-                }
+            auto offset{write % Size};
+            auto sizeEnd{std::min(appendSize, Size - offset)};
+            std::memcpy(array.data() + offset, address, sizeEnd * sizeof(Type));
+            std::memcpy(array.data(), address + sizeEnd, (appendSize - sizeEnd) * sizeof(Type));
 
-                empty = false;
-            }
+            writeIndex.store(write + appendSize, std::memory_order_release); // The elements are only visible to the reader after they have been copied in
+            return appendSize;
         }
 
         /**
          * @brief This appends data from a span to the buffer
          * @param data A span containing the data to be appended
+         * @return The amount of data that was appended in units of Type
          */
-        inline void Append(std::span<Type> data) {
-            Append(data.data(), data.size());
+        inline size_t Append(std::span<Type> data) {
+            return Append(data.data(), static_cast<ssize_t>(data.size()));
         }
     };
 }
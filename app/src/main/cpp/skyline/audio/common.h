@@ -3,6 +3,9 @@
 
 #pragma once
 
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 #include <oboe/Oboe.h>
 #include "circular_buffer.h"
 
@@ -58,5 +61,24 @@ namespace skyline {
         inline Out Saturate(In value) {
             return static_cast<Out>(std::clamp(static_cast<Intermediate>(value), static_cast<Intermediate>(std::numeric_limits<Out>::min()), static_cast<Intermediate>(std::numeric_limits<Out>::max())));
         }
+
+        /**
+         * @brief Mixes samples into a buffer by adding them with saturation
+         * @param destination The buffer to mix the samples into
+         * @param source The samples to mix
+         * @param count The amount of samples to mix
+         */
+        inline void MixSamples(i16 *destination, const i16 *source, size_t count) {
+            size_t index{};
+            #ifdef __ARM_NEON
+            for (; index + 16 <= count; index += 16) {
+                vst1q_s16(destination + index, vqaddq_s16(vld1q_s16(destination + index), vld1q_s16(source + index)));
+                vst1q_s16(destination + index + 8, vqaddq_s16(vld1q_s16(destination + index + 8), vld1q_s16(source + index + 8)));
+            }
+            #endif
+
+            for (; index < count; index++)
+                destination[index] = Saturate<i16, i32>(static_cast<i32>(destination[index]) + static_cast<i32>(source[index]));
+        }
     }
 }
@@ -45,16 +45,18 @@ namespace skyline::audio {
     }
 
     void AudioTrack::AppendBuffer(u64 tag, std::span<i16> buffer) {
+        std::lock_guard guard(bufferLock);
+
+        // Samples which don't fit into the buffer are dropped, the final sample is based on the appended samples so the buffer is still released
+        auto appended{samples.Append(buffer)};
+
         BufferIdentifier identifier{
             .released = false,
             .tag = tag,
-            .finalSample = identifiers.empty() ? (buffer.size()) : (buffer.size() + identifiers.front().finalSample)
+            .finalSample = identifiers.empty() ? appended : (appended + identifiers.front().finalSample)
         };
 
-        std::lock_guard guard(bufferLock);
-
         identifiers.push_front(identifier);
-        samples.Append(buffer);
     }
 
     void AudioTrack::CheckReleasedBuffers() {
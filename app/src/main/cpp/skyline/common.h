@@ -16,6 +16,12 @@
 #include <string>
 #include <sstream>
 #include <memory>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <chrono>
 #include <syslog.h>
 #include <sys/mman.h>
 #include <fmt/format.h>
@@ -86,12 +92,16 @@ namespace skyline {
          * @return The current time in nanoseconds
          */
         inline u64 GetTimeNs() {
+            #ifdef __aarch64__
             static u64 frequency{};
             if (!frequency)
                 asm("MRS %0, CNTFRQ_EL0" : "=r"(frequency));
             u64 ticks;
             asm("MRS %0, CNTVCT_EL0" : "=r"(ticks));
             return ((ticks / frequency) * constant::NsInSecond) + (((ticks % frequency) * constant::NsInSecond + (frequency / 2)) / frequency);
+            #else
+            return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+            #endif
         }
 
         /**
@@ -99,9 +109,13 @@ namespace skyline {
          * @return The current time in ticks
          */
         inline u64 GetTimeTicks() {
+            #ifdef __aarch64__
             u64 ticks;
             asm("MRS %0, CNTVCT_EL0" : "=r"(ticks));
             return ticks;
+            #else
+            return static_cast<u64>(std::chrono::steady_clock::now().time_since_epoch().count());
+            #endif
         }
 
         /**
@@ -132,6 +146,19 @@ namespace skyline {
             return value & ~(multiple - 1);
         }
 
+        /**
+         * @brief Divides a value by a divisor and rounds the result up
+         * @param value The value to divide
+         * @param divisor The divisor to divide the value by
+         * @tparam TypeVal The type of the value
+         * @tparam TypeDiv The type of the divisor
+         * @return The quotient rounded up to the nearest integer
+         */
+        template<typename TypeVal, typename TypeDiv>
+        constexpr inline TypeVal DivideCeil(TypeVal value, TypeDiv divisor) {
+            return (value + divisor - 1) / divisor;
+        }
+
         /**
          * @param value The value to check for alignment
          * @param multiple The multiple to check alignment with
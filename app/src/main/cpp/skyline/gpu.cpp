@@ -12,22 +12,88 @@ extern skyline::u16 fps;
 extern skyline::u32 frametime;
 
 namespace skyline::gpu {
-    GPU::GPU(const DeviceState &state) : state(state), memoryManager(state), gpfifo(state), fermi2D(std::make_shared<engine::Engine>(state)), keplerMemory(std::make_shared<engine::Engine>(state)), maxwell3D(std::make_shared<engine::Maxwell3D>(state)), maxwellCompute(std::make_shared<engine::Engine>(state)), maxwellDma(std::make_shared<engine::Engine>(state)), window(ANativeWindow_fromSurface(state.jvm->GetEnv(), Surface)), vsyncEvent(std::make_shared<kernel::type::KEvent>(state)), bufferEvent(std::make_shared<kernel::type::KEvent>(state)) {
+    GPU::GPU(const DeviceState &state) : state(state), memoryManager(state), textureWorkers(std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U) - 1, constant::MaxTextureWorkers)), textureCache(state), gpfifo(state), fermi2D(std::make_shared<engine::Engine>(state)), keplerMemory(std::make_shared<engine::Engine>(state)), maxwell3D(std::make_shared<engine::Maxwell3D>(state)), maxwellCompute(std::make_shared<engine::Engine>(state)), maxwellDma(std::make_shared<engine::Engine>(state)), window(ANativeWindow_fromSurface(state.jvm->GetEnv(), Surface)), vsyncEvent(std::make_shared<kernel::type::KEvent>(state)), bufferEvent(std::make_shared<kernel::type::KEvent>(state)) {
         ANativeWindow_acquire(window);
         resolution.width = static_cast<u32>(ANativeWindow_getWidth(window));
         resolution.height = static_cast<u32>(ANativeWindow_getHeight(window));
         format = ANativeWindow_getFormat(window);
-        vsyncEvent->Signal();
+
+        vsyncThread = std::thread(&GPU::VsyncLoop, this);
     }
 
     GPU::~GPU() {
+        vsyncExit = true;
+        if (vsyncThread.joinable())
+            vsyncThread.join();
+
         ANativeWindow_release(window);
     }
 
-    void GPU::Loop() {
-        gpfifo.Run();
-        vsyncEvent->Signal();
+    void GPU::VsyncLoop() {
+        pthread_setname_np(pthread_self(), "Vsync");
+
+        timespec time{};
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        u64 deadline{(static_cast<u64>(time.tv_sec) * constant::NsInSecond) + static_cast<u64>(time.tv_nsec)};
+
+        while (!vsyncExit) {
+            deadline += constant::VsyncPeriod;
+            timespec deadlineTime{
+                .tv_sec = static_cast<time_t>(deadline / constant::NsInSecond),
+                .tv_nsec = static_cast<long>(deadline % constant::NsInSecond),
+            };
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadlineTime, nullptr) == EINTR);
+
+            clock_gettime(CLOCK_MONOTONIC, &time);
+            u64 now{(static_cast<u64>(time.tv_sec) * constant::NsInSecond) + static_cast<u64>(time.tv_nsec)};
+            u64 lateness{now > deadline ? now - deadline : 0};
+
+            {
+                std::lock_guard guard(vsyncMutex);
+                vsyncCount++;
+
+                statistics.vsyncCount = vsyncCount;
+                statistics.maxVsyncLateness = std::max(statistics.maxVsyncLateness, lateness);
+
+                // Vsyncs which were missed entirely are dropped rather than signalled in a burst, this keeps the deadlines aligned to the original phase
+                if (lateness >= constant::VsyncPeriod) {
+                    u64 missed{lateness / constant::VsyncPeriod};
+                    statistics.missedVsyncs += missed;
+                    deadline += missed * constant::VsyncPeriod;
+                }
+            }
+
+            vsyncCondition.notify_all();
+            vsyncEvent->Signal();
+        }
+    }
 
+    GPU::FrameStatistics GPU::GetFrameStatistics() {
+        std::lock_guard guard(vsyncMutex);
+        return statistics;
+    }
+
+    void GPU::QueuePresentation(const std::shared_ptr<PresentationTexture> &texture, u32 swapInterval) {
+        std::lock_guard guard(presentationMutex);
+        texture->swapInterval = swapInterval; // This is stored under the lock as the presentation thread reads it from the front of the queue
+        presentationQueue.push(texture);
+    }
+
+    void GPU::WaitForSwapInterval() {
+        std::unique_lock presentationLock(presentationMutex);
+        if (presentationQueue.empty())
+            return;
+
+        // A frame is held back until as many vsyncs as its swap interval have passed since the previous frame was presented
+        auto swapInterval = presentationQueue.front()->swapInterval;
+        presentationLock.unlock();
+        if (swapInterval) {
+            std::unique_lock lock(vsyncMutex);
+            vsyncCondition.wait(lock, [&] { return vsyncCount >= lastPresentVsync + swapInterval; });
+        }
+    }
+
+    void GPU::Loop() {
         if (surfaceUpdate) {
             if (Surface == nullptr)
                 return;
@@ -42,9 +108,11 @@ namespace skyline::gpu {
             return;
         }
 
+        std::unique_lock presentationLock(presentationMutex);
         if (!presentationQueue.empty()) {
-            auto &texture = presentationQueue.front();
+            auto texture = presentationQueue.front();
             presentationQueue.pop();
+            presentationLock.unlock();
 
             auto textureFormat = texture->GetAndroidFormat();
             if (resolution != texture->dimensions || textureFormat != format) {
@@ -56,18 +124,27 @@ namespace skyline::gpu {
             ANativeWindow_Buffer windowBuffer;
             ARect rect;
 
-            ANativeWindow_lock(window, &windowBuffer, &rect);
-            std::memcpy(windowBuffer.bits, texture->backing.data(), texture->backing.size());
-            ANativeWindow_unlockAndPost(window);
+            if (!ANativeWindow_lock(window, &windowBuffer, &rect)) {
+                // The texture is written into the window buffer with its stride, it's only converted into its backing beforehand with dirty tracking
+                texture->CopyToLinear(reinterpret_cast<u8 *>(windowBuffer.bits), static_cast<size_t>(windowBuffer.stride) * texture->format.bpb);
+                ANativeWindow_unlockAndPost(window);
+            }
 
-            vsyncEvent->Signal();
             texture->releaseCallback();
 
+            std::lock_guard guard(vsyncMutex);
+            lastPresentVsync = vsyncCount;
+            statistics.frameCount++;
+
             if (frameTimestamp) {
                 auto now = util::GetTimeNs();
+                auto delta = now - frameTimestamp;
+
+                frametime = static_cast<u32>(delta / 10000); // frametime / 100 is the real ms value, this is to retain the first two decimals
+                fps = static_cast<u16>(constant::NsInSecond / delta);
 
-                frametime = static_cast<u32>((now - frameTimestamp) / 10000); // frametime / 100 is the real ms value, this is to retain the first two decimals
-                fps = static_cast<u16>(constant::NsInSecond / (now - frameTimestamp));
+                statistics.averageFrametime = statistics.averageFrametime ? ((statistics.averageFrametime * 15) + delta) / 16 : delta;
+                statistics.maxFrametime = std::max(statistics.maxFrametime, delta);
 
                 frameTimestamp = now;
             } else {
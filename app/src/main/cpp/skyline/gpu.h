@@ -8,13 +8,24 @@
 #include <kernel/ipc.h>
 #include <kernel/types/KEvent.h>
 #include <services/nvdrv/devices/nvmap.h>
+#include "thread_pool.h"
 #include "gpu/texture.h"
+#include "gpu/texture_cache.h"
 #include "gpu/memory_manager.h"
 #include "gpu/gpfifo.h"
 #include "gpu/syncpoint.h"
 #include "gpu/engines/engine.h"
 #include "gpu/engines/maxwell_3d.h"
 
+namespace skyline {
+    namespace constant {
+        constexpr size_t MaxTextureWorkers = 3; //!< The maximum amount of worker threads used for texture conversion in addition to the calling thread
+        constexpr u64 DisplayRefreshRate = 60; //!< The refresh rate of the display in Hz
+        constexpr u64 VsyncPeriod = NsInSecond / DisplayRefreshRate; //!< The time between two vsyncs in nanoseconds
+        constexpr u64 DequeueBufferTimeout = NsInSecond; //!< The maximum time a synchronous DequeueBuffer waits for a buffer to be freed in nanoseconds
+    }
+}
+
 namespace skyline::gpu {
     /**
      * @brief This is used to converge all of the interfaces to the GPU and send the results to a GPU API
@@ -26,21 +37,51 @@ namespace skyline::gpu {
         const DeviceState &state; //!< The state of the device
         bool surfaceUpdate{}; //!< If the surface needs to be updated
         u64 frameTimestamp{}; //!< The timestamp of the last frame being shown
+        std::thread vsyncThread; //!< The thread which signals vsyncEvent at the refresh rate of the display
+        std::atomic<bool> vsyncExit{}; //!< If the vsync thread should exit
+        std::mutex vsyncMutex; //!< Synchronizes the vsync counter and the frame statistics
+        std::condition_variable vsyncCondition; //!< This is notified on every vsync so presentation can wait for the swap interval of a frame
+        u64 vsyncCount{}; //!< The amount of vsyncs that have occurred
+        u64 lastPresentVsync{}; //!< The value of vsyncCount when the last frame was presented
+        std::mutex presentationMutex; //!< Synchronizes the presentation queue as textures are pushed by guest threads and popped by the presentation thread
+        std::queue<std::shared_ptr<PresentationTexture>> presentationQueue; //!< A queue of all the PresentationTextures to be posted to the display, this is guarded by presentationMutex
+
+      public:
+        /**
+         * @brief Statistics about the pacing of vsyncs and presented frames
+         */
+        struct FrameStatistics {
+            u64 vsyncCount; //!< The amount of vsyncs that have occurred
+            u64 missedVsyncs; //!< The amount of vsyncs that were skipped as the vsync thread woke up more than a period late
+            u64 maxVsyncLateness; //!< The largest delay in nanoseconds between a vsync and the vsync thread waking up for it
+            u64 frameCount; //!< The amount of frames that have been presented
+            u64 averageFrametime; //!< A moving average of the time between presented frames in nanoseconds
+            u64 maxFrametime; //!< The largest time between two presented frames in nanoseconds
+        };
+
+      private:
+        FrameStatistics statistics{}; //!< The frame statistics, this is guarded by vsyncMutex
+
+        /**
+         * @brief The entry point of the vsync thread, this sleeps until every vsync with an absolute deadline so the error of a wakeup doesn't accumulate
+         */
+        void VsyncLoop();
 
       public:
-        std::queue<std::shared_ptr<PresentationTexture>> presentationQueue; //!< A queue of all the PresentationTextures to be posted to the display
         texture::Dimensions resolution{}; //!< The resolution of the surface
         i32 format{}; //!< The format of the display window
-        std::shared_ptr<kernel::type::KEvent> vsyncEvent; //!< This KEvent is triggered every time a frame is drawn
+        std::shared_ptr<kernel::type::KEvent> vsyncEvent; //!< This KEvent is triggered on every vsync of the display
         std::shared_ptr<kernel::type::KEvent> bufferEvent; //!< This KEvent is triggered every time a buffer is freed
         vmm::MemoryManager memoryManager; //!< The GPU Virtual Memory Manager
+        ThreadPool textureWorkers; //!< A pool of threads that large texture conversions are split across
+        TextureCache textureCache; //!< A cache of all guest textures so they are only converted once
         std::shared_ptr<engine::Engine> fermi2D;
         std::shared_ptr<engine::Maxwell3D> maxwell3D;
         std::shared_ptr<engine::Engine> maxwellCompute;
         std::shared_ptr<engine::Engine> maxwellDma;
         std::shared_ptr<engine::Engine> keplerMemory;
-        gpfifo::GPFIFO gpfifo;
         std::array<Syncpoint, constant::MaxHwSyncpointCount> syncpoints{};
+        gpfifo::GPFIFO gpfifo; //!< This is declared after everything it uses so that the GPFIFO thread is joined before they're destroyed
 
         /**
          * @param window The ANativeWindow to render to
@@ -52,9 +93,26 @@ namespace skyline::gpu {
          */
         ~GPU();
 
+        /**
+         * @brief Queues a texture to be presented after the textures that were queued before it
+         * @param swapInterval The amount of vsyncs that need to pass after the previous frame before this texture is presented
+         */
+        void QueuePresentation(const std::shared_ptr<PresentationTexture> &texture, u32 swapInterval);
+
+        /**
+         * @brief This waits until the swap interval of the next frame in the presentation queue has passed
+         * @note This must be called without holding JniMtx as it can block for multiple vsyncs
+         */
+        void WaitForSwapInterval();
+
         /**
          * @brief The loop that executes routine GPU functions
          */
         void Loop();
+
+        /**
+         * @return A snapshot of the frame statistics
+         */
+        FrameStatistics GetFrameStatistics();
     };
 }
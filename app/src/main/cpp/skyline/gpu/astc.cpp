@@ -0,0 +1,810 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <atomic>
+#include "astc.h"
+
+namespace skyline::gpu::texture::astc {
+    namespace {
+        constexpr u8 BlockSize{16}; //!< The size of a single block in bytes
+        constexpr u8 MaxBlockDimension{12}; //!< The largest width or height of a 2D block in texels
+        constexpr u8 MaxTexels{MaxBlockDimension * MaxBlockDimension};
+        constexpr u8 MaxWeights{64}; //!< The maximum amount of weights in a block including both planes
+        constexpr u8 MaxColorValues{18}; //!< The maximum amount of color endpoint values in a block
+        constexpr u16 PartitionSeeds{1024}; //!< The amount of partition patterns for each partition count
+        constexpr u32 ErrorColor{0xFFFF00FF}; //!< The color of texels in blocks which can't be decoded, this is opaque magenta
+
+        /**
+         * @brief A range of values encoded with ISE (Integer Sequence Encoding), every value is made of low bits and optionally a trit or quint above them
+         */
+        struct IseRange {
+            u8 bits;
+            bool trit;
+            bool quint;
+
+            /**
+             * @return The amount of bits that a sequence of values in this range takes up
+             */
+            constexpr u32 GetSequenceBits(u32 count) const {
+                return (count * bits) + (trit ? ((8 * count) + 4) / 5 : 0) + (quint ? ((7 * count) + 2) / 3 : 0);
+            }
+        };
+
+        /**
+         * @brief All ISE ranges in increasing order of precision, these are 2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 40, 48, 64, 80, 96, 128, 160, 192 and 256 levels
+         */
+        constexpr std::array<IseRange, 21> IseRanges{{
+            {1, false, false}, {0, true, false}, {2, false, false}, {0, false, true}, {1, true, false}, {3, false, false}, {1, false, true},
+            {2, true, false}, {4, false, false}, {2, false, true}, {3, true, false}, {5, false, false}, {3, false, true}, {4, true, false},
+            {6, false, false}, {4, false, true}, {5, true, false}, {7, false, false}, {5, false, true}, {6, true, false}, {8, false, false},
+        }};
+
+        constexpr u8 MinColorRange{4}; //!< The index of the least precise range that color endpoints can use, this is 6 levels
+
+        /**
+         * @brief The values of every trit block, 5 trits are packed into 8 bits
+         */
+        constexpr std::array<std::array<u8, 5>, 256> TritBlocks{[] {
+            std::array<std::array<u8, 5>, 256> blocks{};
+            for (u32 packed{}; packed < blocks.size(); packed++) {
+                auto Bit = [packed](u32 bit) { return (packed >> bit) & 1; };
+                u32 c;
+                auto &trits{blocks[packed]};
+                if (((packed >> 2) & 0b111) == 0b111) {
+                    c = (((packed >> 5) & 0b111) << 2) | (packed & 0b11);
+                    trits[4] = 2;
+                    trits[3] = 2;
+                } else {
+                    c = packed & 0b11111;
+                    if (((packed >> 5) & 0b11) == 0b11) {
+                        trits[4] = 2;
+                        trits[3] = static_cast<u8>(Bit(7));
+                    } else {
+                        trits[4] = static_cast<u8>(Bit(7));
+                        trits[3] = static_cast<u8>((packed >> 5) & 0b11);
+                    }
+                }
+
+                auto CBit = [c](u32 bit) { return (c >> bit) & 1; };
+                if ((c & 0b11) == 0b11) {
+                    trits[2] = 2;
+                    trits[1] = static_cast<u8>(CBit(4));
+                    trits[0] = static_cast<u8>((CBit(3) << 1) | (CBit(2) & ~CBit(3) & 1));
+                } else if (((c >> 2) & 0b11) == 0b11) {
+                    trits[2] = 2;
+                    trits[1] = 2;
+                    trits[0] = static_cast<u8>(c & 0b11);
+                } else {
+                    trits[2] = static_cast<u8>(CBit(4));
+                    trits[1] = static_cast<u8>((c >> 2) & 0b11);
+                    trits[0] = static_cast<u8>((CBit(1) << 1) | (CBit(0) & ~CBit(1) & 1));
+                }
+            }
+            return blocks;
+        }()};
+
+        /**
+         * @brief The values of every quint block, 3 quints are packed into 7 bits
+         */
+        constexpr std::array<std::array<u8, 3>, 128> QuintBlocks{[] {
+            std::array<std::array<u8, 3>, 128> blocks{};
+            for (u32 packed{}; packed < blocks.size(); packed++) {
+                auto Bit = [packed](u32 bit) { return (packed >> bit) & 1; };
+                auto &quints{blocks[packed]};
+                if (((packed >> 1) & 0b11) == 0b11 && ((packed >> 5) & 0b11) == 0) {
+                    quints[2] = static_cast<u8>((Bit(0) << 2) | ((Bit(4) & ~Bit(0) & 1) << 1) | (Bit(3) & ~Bit(0) & 1));
+                    quints[1] = 4;
+                    quints[0] = 4;
+                } else {
+                    u32 c;
+                    if (((packed >> 1) & 0b11) == 0b11) {
+                        quints[2] = 4;
+                        c = (((packed >> 3) & 0b11) << 3) | ((~(packed >> 5) & 0b11) << 1) | Bit(0);
+                    } else {
+                        quints[2] = static_cast<u8>((packed >> 5) & 0b11);
+                        c = packed & 0b11111;
+                    }
+
+                    if ((c & 0b111) == 0b101) {
+                        quints[1] = 4;
+                        quints[0] = static_cast<u8>((c >> 3) & 0b11);
+                    } else {
+                        quints[1] = static_cast<u8>((c >> 3) & 0b11);
+                        quints[0] = static_cast<u8>(c & 0b111);
+                    }
+                }
+            }
+            return blocks;
+        }()};
+
+        /**
+         * @brief Unquantizes a color endpoint value which is encoded as its low bits with the trit or quint above them into [0, 255]
+         */
+        constexpr u8 UnquantizeColor(u32 value, IseRange range) {
+            u32 bits{value & ((1U << range.bits) - 1)}, digit{value >> range.bits};
+            if (!range.trit && !range.quint) {
+                // The value is expanded by replicating its bits
+                u32 result{};
+                for (i32 shift{8 - range.bits}; shift > -range.bits; shift -= range.bits)
+                    result |= (shift >= 0) ? (bits << shift) : (bits >> -shift);
+                return static_cast<u8>(result);
+            }
+
+            auto Bit = [bits](u32 bit) { return (bits >> bit) & 1; };
+            u32 a{Bit(0) ? 0x1FFU : 0U}, b{Bit(1)}, c{Bit(2)}, d{Bit(3)}, e{Bit(4)}, f{Bit(5)};
+            u32 scale{}, offset{};
+            if (range.trit) {
+                switch (range.bits) {
+                    case 1:
+                        scale = 204;
+                        break;
+                    case 2:
+                        scale = 93;
+                        offset = (b << 8) | (b << 4) | (b << 2) | (b << 1);
+                        break;
+                    case 3:
+                        scale = 44;
+                        offset = (c << 8) | (b << 7) | (c << 3) | (b << 2) | (c << 1) | b;
+                        break;
+                    case 4:
+                        scale = 22;
+                        offset = (d << 8) | (c << 7) | (b << 6) | (d << 2) | (c << 1) | b;
+                        break;
+                    case 5:
+                        scale = 11;
+                        offset = (e << 8) | (d << 7) | (c << 6) | (b << 5) | (e << 1) | d;
+                        break;
+                    case 6:
+                        scale = 5;
+                        offset = (f << 8) | (e << 7) | (d << 6) | (c << 5) | (b << 4) | f;
+                        break;
+                }
+            } else {
+                switch (range.bits) {
+                    case 1:
+                        scale = 113;
+                        break;
+                    case 2:
+                        scale = 54;
+                        offset = (b << 8) | (b << 3) | (b << 2);
+                        break;
+                    case 3:
+                        scale = 26;
+                        offset = (c << 8) | (b << 7) | (c << 2) | (b << 1) | c;
+                        break;
+                    case 4:
+                        scale = 13;
+                        offset = (d << 8) | (c << 7) | (b << 6) | (d << 1) | c;
+                        break;
+                    case 5:
+                        scale = 6;
+                        offset = (e << 8) | (d << 7) | (c << 6) | (b << 5) | e;
+                        break;
+                }
+            }
+
+            u32 result{((digit * scale) + offset) ^ a};
+            return static_cast<u8>((a & 0x80) | (result >> 2));
+        }
+
+        /**
+         * @brief Unquantizes a weight which is encoded as its low bits with the trit or quint above them into [0, 64]
+         */
+        constexpr u8 UnquantizeWeight(u32 value, IseRange range) {
+            u32 bits{value & ((1U << range.bits) - 1)}, digit{value >> range.bits};
+            u32 result;
+            if (!range.trit && !range.quint) {
+                result = 0;
+                for (i32 shift{6 - range.bits}; shift > -range.bits; shift -= range.bits)
+                    result |= (shift >= 0) ? (bits << shift) : (bits >> -shift);
+            } else if (range.bits == 0) {
+                result = range.trit ? std::array<u8, 3>{0, 32, 63}[digit] : std::array<u8, 5>{0, 16, 32, 47, 63}[digit];
+            } else {
+                auto Bit = [bits](u32 bit) { return (bits >> bit) & 1; };
+                u32 a{Bit(0) ? 0x7FU : 0U}, b{Bit(1)}, c{Bit(2)};
+                u32 scale{}, offset{};
+                if (range.trit) {
+                    if (range.bits == 1) {
+                        scale = 50;
+                    } else if (range.bits == 2) {
+                        scale = 23;
+                        offset = (b << 6) | (b << 2) | b;
+                    } else {
+                        scale = 11;
+                        offset = (c << 6) | (b << 5) | (c << 1) | b;
+                    }
+                } else {
+                    if (range.bits == 1) {
+                        scale = 28;
+                    } else {
+                        scale = 13;
+                        offset = (b << 6) | (b << 1);
+                    }
+                }
+                result = ((digit * scale) + offset) ^ a;
+                result = (a & 0x20) | (result >> 2);
+            }
+            return static_cast<u8>(result + (result > 32));
+        }
+
+        /**
+         * @brief The unquantized values of every color endpoint range indexed by the encoded value
+         */
+        constexpr std::array<std::array<u8, 256>, IseRanges.size()> ColorTables{[] {
+            std::array<std::array<u8, 256>, IseRanges.size()> tables{};
+            for (size_t range{}; range < IseRanges.size(); range++)
+                for (u32 value{}; value < (IseRanges[range].trit ? (3U << IseRanges[range].bits) : (IseRanges[range].quint ? (5U << IseRanges[range].bits) : (1U << IseRanges[range].bits))); value++)
+                    tables[range][value] = UnquantizeColor(value, IseRanges[range]);
+            return tables;
+        }()};
+
+        /**
+         * @brief This reads bit fields out of a 128-bit block with the bits past a limit reading as zero
+         */
+        class BlockBits {
+          private:
+            u64 low; //!< Bits 0 to 63 of the block
+            u64 high; //!< Bits 64 to 127 of the block
+
+            static constexpr u64 Reverse(u64 value) {
+                value = ((value >> 1) & 0x5555555555555555) | ((value & 0x5555555555555555) << 1);
+                value = ((value >> 2) & 0x3333333333333333) | ((value & 0x3333333333333333) << 2);
+                value = ((value >> 4) & 0x0F0F0F0F0F0F0F0F) | ((value & 0x0F0F0F0F0F0F0F0F) << 4);
+                value = ((value >> 8) & 0x00FF00FF00FF00FF) | ((value & 0x00FF00FF00FF00FF) << 8);
+                value = ((value >> 16) & 0x0000FFFF0000FFFF) | ((value & 0x0000FFFF0000FFFF) << 16);
+                return (value >> 32) | (value << 32);
+            }
+
+          public:
+            BlockBits(u64 low, u64 high) : low(low), high(high) {}
+
+            BlockBits(const u8 *block) {
+                std::memcpy(&low, block, sizeof(u64));
+                std::memcpy(&high, block + sizeof(u64), sizeof(u64));
+            }
+
+            /**
+             * @return A copy of the block with the order of all of its bits reversed, the weights are stored from the top of the block downwards
+             */
+            BlockBits Reversed() const {
+                return BlockBits(Reverse(high), Reverse(low));
+            }
+
+            /**
+             * @param offset The offset of the first bit to read
+             * @param count The amount of bits to read, this must be at most 32
+             * @param limit The offset of the first bit which reads as zero
+             */
+            u32 Get(u32 offset, u32 count, u32 limit = 128) const {
+                if (!count || offset >= limit)
+                    return 0;
+                count = std::min(count, limit - offset);
+
+                u64 value;
+                if (offset >= 64)
+                    value = high >> (offset - 64);
+                else if (offset == 0)
+                    value = low;
+                else
+                    value = (low >> offset) | (high << (64 - offset));
+                return static_cast<u32>(value & ((1ULL << count) - 1));
+            }
+        };
+
+        /**
+         * @brief Decodes a sequence of ISE values, every value is written as its low bits with the trit or quint above them
+         * @param offset The offset of the sequence in the block
+         * @param limit The offset of the end of the sequence, bits past it read as zero
+         */
+        void DecodeIse(const BlockBits &bits, u32 offset, u32 limit, IseRange range, u32 count, u8 *output) {
+            if (range.trit) {
+                for (u32 index{}; index < count; index += 5) {
+                    std::array<u32, 5> values;
+                    u32 packed{};
+                    constexpr std::array<u8, 5> TritBits{2, 2, 1, 2, 1}; // The bits of the packed trits which follow each value
+                    for (u32 value{}, packedShift{}; value < 5; value++) {
+                        values[value] = bits.Get(offset, range.bits, limit);
+                        offset += range.bits;
+                        packed |= bits.Get(offset, TritBits[value], limit) << packedShift;
+                        offset += TritBits[value];
+                        packedShift += TritBits[value];
+                    }
+
+                    const auto &trits{TritBlocks[packed]};
+                    for (u32 value{}; value < 5 && index + value < count; value++)
+                        output[index + value] = static_cast<u8>((trits[value] << range.bits) | values[value]);
+                }
+            } else if (range.quint) {
+                for (u32 index{}; index < count; index += 3) {
+                    std::array<u32, 3> values;
+                    u32 packed{};
+                    constexpr std::array<u8, 3> QuintBits{3, 2, 2}; // The bits of the packed quints which follow each value
+                    for (u32 value{}, packedShift{}; value < 3; value++) {
+                        values[value] = bits.Get(offset, range.bits, limit);
+                        offset += range.bits;
+                        packed |= bits.Get(offset, QuintBits[value], limit) << packedShift;
+                        offset += QuintBits[value];
+                        packedShift += QuintBits[value];
+                    }
+
+                    const auto &quints{QuintBlocks[packed]};
+                    for (u32 value{}; value < 3 && index + value < count; value++)
+                        output[index + value] = static_cast<u8>((quints[value] << range.bits) | values[value]);
+                }
+            } else {
+                for (u32 index{}; index < count; index++, offset += range.bits)
+                    output[index] = static_cast<u8>(bits.Get(offset, range.bits, limit));
+            }
+        }
+
+        /**
+         * @brief The contribution of the weight grid to a single texel, the weight of a texel is bilinearly interpolated from up to 4 weights of the grid
+         */
+        struct InfillTexel {
+            std::array<u8, 4> indices; //!< The indices of the grid weights, this is 0 for grid weights with no contribution so they're always in bounds
+            std::array<u8, 4> factors; //!< The factors of the grid weights which add up to 16
+        };
+
+        using InfillTable = std::array<InfillTexel, MaxTexels>; //!< The infill of every texel of a block for a single weight grid size
+        using PartitionTable = std::array<u8, MaxTexels>; //!< The partition of every texel of a block for a single partition pattern
+
+        /**
+         * @return The partition of a texel in a partition pattern, this is the hash-based function from the specification
+         */
+        u8 SelectPartition(u32 seed, u32 x, u32 y, u32 partitionCount, bool smallBlock) {
+            if (smallBlock) {
+                x <<= 1;
+                y <<= 1;
+            }
+
+            seed += (partitionCount - 1) * PartitionSeeds;
+
+            u32 random{seed};
+            random ^= random >> 15;
+            random -= random << 17;
+            random += random << 7;
+            random += random << 4;
+            random ^= random >> 5;
+            random += random << 16;
+            random ^= random >> 7;
+            random ^= random >> 3;
+            random ^= random << 6;
+            random ^= random >> 17;
+
+            std::array<u32, 8> seeds;
+            for (u32 index{}; index < seeds.size(); index++) {
+                seeds[index] = (random >> (index * 4)) & 0xF;
+                seeds[index] *= seeds[index];
+            }
+
+            u32 shift1, shift2;
+            if (seed & 1) {
+                shift1 = (seed & 2) ? 4 : 5;
+                shift2 = (partitionCount == 3) ? 6 : 5;
+            } else {
+                shift1 = (partitionCount == 3) ? 6 : 5;
+                shift2 = (seed & 2) ? 4 : 5;
+            }
+            for (u32 index{}; index < seeds.size(); index++)
+                seeds[index] >>= (index & 1) ? shift2 : shift1;
+
+            // The Z-axis seeds are omitted as the Z coordinate of 2D blocks is always 0
+            std::array<u32, 4> values{
+                ((seeds[0] * x) + (seeds[1] * y) + (random >> 14)) & 0x3F,
+                ((seeds[2] * x) + (seeds[3] * y) + (random >> 10)) & 0x3F,
+                ((seeds[4] * x) + (seeds[5] * y) + (random >> 6)) & 0x3F,
+                ((seeds[6] * x) + (seeds[7] * y) + (random >> 2)) & 0x3F,
+            };
+            if (partitionCount < 4)
+                values[3] = 0;
+            if (partitionCount < 3)
+                values[2] = 0;
+
+            if (values[0] >= values[1] && values[0] >= values[2] && values[0] >= values[3])
+                return 0;
+            else if (values[1] >= values[2] && values[1] >= values[3])
+                return 1;
+            else if (values[2] >= values[3])
+                return 2;
+            return 3;
+        }
+
+        /**
+         * @brief This caches the tables which only depend on the block footprint so they're only computed once rather than for every block
+         * @details Tables are computed lazily as most titles only use a small fraction of the partition patterns and weight grid sizes, they're published atomically so concurrent decoders can share them without locking
+         */
+        class FootprintTables {
+          private:
+            u8 width;
+            u8 height;
+            std::array<std::atomic<const InfillTable *>, (MaxBlockDimension + 1) * (MaxBlockDimension + 1)> infillTables{}; //!< The infill tables of every weight grid size, indexed by the width and height of the grid
+            std::array<std::atomic<const PartitionTable *>, 3 * PartitionSeeds> partitionTables{}; //!< The partition tables of every pattern, indexed by the partition count and seed
+
+            template<typename Type, typename Function>
+            static const Type &GetOrCreate(std::atomic<const Type *> &slot, Function create) {
+                auto table{slot.load(std::memory_order_acquire)};
+                if (!table) {
+                    auto created{new Type(create())};
+                    if (slot.compare_exchange_strong(table, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                        table = created;
+                    else
+                        delete created; // Another thread published the same table first
+                }
+                return *table;
+            }
+
+          public:
+            FootprintTables(u8 width, u8 height) : width(width), height(height) {}
+
+            ~FootprintTables() {
+                for (auto &table : infillTables)
+                    delete table.load(std::memory_order_relaxed);
+                for (auto &table : partitionTables)
+                    delete table.load(std::memory_order_relaxed);
+            }
+
+            const InfillTable &GetInfill(u8 gridWidth, u8 gridHeight) {
+                return GetOrCreate(infillTables[(gridWidth * (MaxBlockDimension + 1)) + gridHeight], [&] {
+                    InfillTable table{};
+                    u32 scaleX{(1024 + (width / 2U)) / (width - 1U)}, scaleY{(1024 + (height / 2U)) / (height - 1U)};
+                    for (u32 y{}; y < height; y++) {
+                        for (u32 x{}; x < width; x++) {
+                            u32 gridX{(((scaleX * x) * (gridWidth - 1U)) + 32) >> 6}, gridY{(((scaleY * y) * (gridHeight - 1U)) + 32) >> 6};
+                            u32 fractionX{gridX & 0xF}, fractionY{gridY & 0xF};
+                            u32 index{(gridX >> 4) + ((gridY >> 4) * gridWidth)};
+
+                            u32 factor11{((fractionX * fractionY) + 8) >> 4};
+                            std::array<u32, 4> factors{16 - fractionX - fractionY + factor11, fractionX - factor11, fractionY - factor11, factor11};
+                            std::array<u32, 4> indices{index, index + 1, index + gridWidth, index + gridWidth + 1};
+
+                            auto &texel{table[(y * width) + x]};
+                            for (size_t corner{}; corner < factors.size(); corner++) {
+                                texel.factors[corner] = static_cast<u8>(factors[corner]);
+                                texel.indices[corner] = static_cast<u8>(factors[corner] ? indices[corner] : 0);
+                            }
+                        }
+                    }
+                    return table;
+                });
+            }
+
+            const PartitionTable &GetPartitions(u32 partitionCount, u32 seed) {
+                return GetOrCreate(partitionTables[((partitionCount - 2) * PartitionSeeds) + seed], [&] {
+                    PartitionTable table{};
+                    bool smallBlock{width * height < 31};
+                    for (u32 y{}; y < height; y++)
+                        for (u32 x{}; x < width; x++)
+                            table[(y * width) + x] = SelectPartition(seed, x, y, partitionCount, smallBlock);
+                    return table;
+                });
+            }
+        };
+
+        /**
+         * @brief The two RGBA endpoints of a partition
+         */
+        using Endpoints = std::array<std::array<i32, 4>, 2>;
+
+        /**
+         * @brief Transfers the top bit of a into b and turns a into a signed 6-bit value, this is used by the base+offset endpoint modes
+         */
+        inline void BitTransferSigned(i32 &a, i32 &b) {
+            b = (b >> 1) | (a & 0x80);
+            a = (a >> 1) & 0x3F;
+            if (a & 0x20)
+                a -= 0x40;
+        }
+
+        /**
+         * @brief Moves the red and green channels towards the blue channel, this is the inverse of the blue contraction done by encoders to increase precision
+         */
+        inline std::array<i32, 4> BlueContract(i32 red, i32 green, i32 blue, i32 alpha) {
+            return {(red + blue) >> 1, (green + blue) >> 1, blue, alpha};
+        }
+
+        /**
+         * @brief Decodes the endpoints of a partition from its color endpoint values
+         * @param mode The CEM (Color Endpoint Mode) of the partition
+         * @return If the endpoints could be decoded, HDR modes aren't supported by the LDR profile
+         */
+        bool DecodeEndpoints(u32 mode, const u8 *values, Endpoints &endpoints) {
+            std::array<i32, 8> v;
+            for (u32 index{}; index < ((mode >> 2) + 1) * 2; index++)
+                v[index] = values[index];
+
+            switch (mode) {
+                case 0: // Luminance, direct
+                    endpoints = {{{v[0], v[0], v[0], 0xFF}, {v[1], v[1], v[1], 0xFF}}};
+                    break;
+                case 1: { // Luminance, base+offset
+                    i32 l0{(v[0] >> 2) | (v[1] & 0xC0)};
+                    i32 l1{std::min(l0 + (v[1] & 0x3F), 0xFF)};
+                    endpoints = {{{l0, l0, l0, 0xFF}, {l1, l1, l1, 0xFF}}};
+                    break;
+                }
+                case 4: // Luminance and alpha, direct
+                    endpoints = {{{v[0], v[0], v[0], v[2]}, {v[1], v[1], v[1], v[3]}}};
+                    break;
+                case 5: // Luminance and alpha, base+offset
+                    BitTransferSigned(v[1], v[0]);
+                    BitTransferSigned(v[3], v[2]);
+                    endpoints = {{{v[0], v[0], v[0], v[2]}, {v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]}}};
+                    break;
+                case 6: // RGB, base+scale
+                    endpoints = {{{(v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 0xFF}, {v[0], v[1], v[2], 0xFF}}};
+                    break;
+                case 8: // RGB, direct
+                    if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+                        endpoints = {{{v[0], v[2], v[4], 0xFF}, {v[1], v[3], v[5], 0xFF}}};
+                    else
+                        endpoints = {BlueContract(v[1], v[3], v[5], 0xFF), BlueContract(v[0], v[2], v[4], 0xFF)};
+                    break;
+                case 9: // RGB, base+offset
+                    BitTransferSigned(v[1], v[0]);
+                    BitTransferSigned(v[3], v[2]);
+                    BitTransferSigned(v[5], v[4]);
+                    if (v[1] + v[3] + v[5] >= 0)
+                        endpoints = {{{v[0], v[2], v[4], 0xFF}, {v[0] + v[1], v[2] + v[3], v[4] + v[5], 0xFF}}};
+                    else
+                        endpoints = {BlueContract(v[0] + v[1], v[2] + v[3], v[4] + v[5], 0xFF), BlueContract(v[0], v[2], v[4], 0xFF)};
+                    break;
+                case 10: // RGB, base+scale plus two alpha values
+                    endpoints = {{{(v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]}, {v[0], v[1], v[2], v[5]}}};
+                    break;
+                case 12: // RGBA, direct
+                    if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+                        endpoints = {{{v[0], v[2], v[4], v[6]}, {v[1], v[3], v[5], v[7]}}};
+                    else
+                        endpoints = {BlueContract(v[1], v[3], v[5], v[7]), BlueContract(v[0], v[2], v[4], v[6])};
+                    break;
+                case 13: // RGBA, base+offset
+                    BitTransferSigned(v[1], v[0]);
+                    BitTransferSigned(v[3], v[2]);
+                    BitTransferSigned(v[5], v[4]);
+                    BitTransferSigned(v[7], v[6]);
+                    if (v[1] + v[3] + v[5] >= 0)
+                        endpoints = {{{v[0], v[2], v[4], v[6]}, {v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]}}};
+                    else
+                        endpoints = {BlueContract(v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]), BlueContract(v[0], v[2], v[4], v[6])};
+                    break;
+                default:
+                    return false;
+            }
+
+            for (auto &endpoint : endpoints)
+                for (auto &component : endpoint)
+                    component = std::clamp(component, 0, 0xFF);
+            return true;
+        }
+
+        /**
+         * @brief Decodes a single block into texels
+         * @param texels The texels of the block in row-major order, this must have space for a block of the footprint of the tables
+         */
+        void DecodeBlock(const u8 *block, u32 *texels, u8 width, u8 height, FootprintTables &tables) {
+            BlockBits bits(block);
+            u32 texelCount{static_cast<u32>(width) * height};
+            auto Error = [&] {
+                std::fill_n(texels, texelCount, ErrorColor);
+            };
+
+            if (bits.Get(0, 9) == 0x1FC) {
+                // Void-extent blocks are a single constant color, HDR ones aren't supported by the LDR profile
+                if (bits.Get(9, 1))
+                    return Error();
+                u32 color{(bits.Get(64 + 8, 8)) | (bits.Get(80 + 8, 8) << 8) | (bits.Get(96 + 8, 8) << 16) | (bits.Get(112 + 8, 8) << 24)};
+                std::fill_n(texels, texelCount, color);
+                return;
+            }
+
+            // The block mode determines the size of the weight grid, the range of the weights and if there's a second plane of weights
+            u32 blockMode{bits.Get(0, 11)};
+            u32 gridWidth, gridHeight, range;
+            bool highPrecision{static_cast<bool>((blockMode >> 9) & 1)}, dualPlane{static_cast<bool>((blockMode >> 10) & 1)};
+            u32 a{(blockMode >> 5) & 0b11}, b{(blockMode >> 7) & 0b11};
+            if (blockMode & 0b11) {
+                range = ((blockMode >> 4) & 1) | ((blockMode & 0b11) << 1);
+                switch ((blockMode >> 2) & 0b11) {
+                    case 0:
+                        gridWidth = b + 4;
+                        gridHeight = a + 2;
+                        break;
+                    case 1:
+                        gridWidth = b + 8;
+                        gridHeight = a + 2;
+                        break;
+                    case 2:
+                        gridWidth = a + 2;
+                        gridHeight = b + 8;
+                        break;
+                    default:
+                        if (b & 0b10) {
+                            gridWidth = (b & 1) + 2;
+                            gridHeight = a + 2;
+                        } else {
+                            gridWidth = a + 2;
+                            gridHeight = (b & 1) + 6;
+                        }
+                        break;
+                }
+            } else {
+                range = ((blockMode >> 4) & 1) | (((blockMode >> 2) & 0b11) << 1);
+                switch (b) {
+                    case 0:
+                        gridWidth = 12;
+                        gridHeight = a + 2;
+                        break;
+                    case 1:
+                        gridWidth = a + 2;
+                        gridHeight = 12;
+                        break;
+                    case 2:
+                        gridWidth = a + 6;
+                        gridHeight = ((blockMode >> 9) & 0b11) + 6;
+                        highPrecision = false;
+                        dualPlane = false;
+                        break;
+                    default:
+                        if (a == 0) {
+                            gridWidth = 6;
+                            gridHeight = 10;
+                        } else if (a == 1) {
+                            gridWidth = 10;
+                            gridHeight = 6;
+                        } else {
+                            return Error();
+                        }
+                        break;
+                }
+            }
+            if (range < 2)
+                return Error();
+
+            u32 weightCount{gridWidth * gridHeight * (dualPlane ? 2 : 1)};
+            auto weightRange{IseRanges[(range - 2) + (highPrecision ? 6 : 0)]};
+            u32 weightBits{weightRange.GetSequenceBits(weightCount)};
+            if (gridWidth > width || gridHeight > height || weightCount > MaxWeights || weightBits < 24 || weightBits > 96)
+                return Error();
+
+            u32 partitionCount{bits.Get(11, 2) + 1};
+            if (dualPlane && partitionCount == 4)
+                return Error();
+
+            // The color endpoint modes of the partitions, modes that differ between partitions have additional bits stored below the weights
+            std::array<u32, 4> modes;
+            u32 colorOffset, partitionSeed{}, colorLimit{128 - weightBits};
+            if (partitionCount == 1) {
+                modes[0] = bits.Get(13, 4);
+                colorOffset = 17;
+            } else {
+                partitionSeed = bits.Get(13, 10);
+                colorOffset = 29;
+
+                u32 modeBits{bits.Get(23, 6)};
+                if (modeBits & 0b11) {
+                    u32 extraBits{(3 * partitionCount) - 4};
+                    colorLimit -= extraBits;
+                    modeBits |= bits.Get(colorLimit, extraBits) << 6;
+
+                    u32 baseClass{(modeBits & 0b11) - 1};
+                    for (u32 partition{}; partition < partitionCount; partition++) {
+                        u32 modeClass{baseClass + ((modeBits >> (2 + partition)) & 1)};
+                        u32 modeIndex{(modeBits >> (2 + partitionCount + (partition * 2))) & 0b11};
+                        modes[partition] = (modeClass << 2) | modeIndex;
+                    }
+                } else {
+                    modes.fill(modeBits >> 2);
+                }
+            }
+
+            u32 planeChannel{4}; // The channel that uses the weights of the second plane, this is out of range if there is no second plane
+            if (dualPlane) {
+                colorLimit -= 2;
+                planeChannel = bits.Get(colorLimit, 2);
+            }
+
+            u32 colorValueCount{};
+            for (u32 partition{}; partition < partitionCount; partition++)
+                colorValueCount += ((modes[partition] >> 2) + 1) * 2;
+            if (colorValueCount > MaxColorValues || colorLimit <= colorOffset)
+                return Error();
+
+            // The color endpoints use the most precise range that fits into the bits between the header and the weights
+            u32 colorBits{colorLimit - colorOffset};
+            i32 colorRange{static_cast<i32>(IseRanges.size()) - 1};
+            while (colorRange >= 0 && IseRanges[colorRange].GetSequenceBits(colorValueCount) > colorBits)
+                colorRange--;
+            if (colorRange < MinColorRange)
+                return Error();
+
+            std::array<u8, MaxColorValues> colorValues;
+            DecodeIse(bits, colorOffset, colorLimit, IseRanges[colorRange], colorValueCount, colorValues.data());
+            for (u32 index{}; index < colorValueCount; index++)
+                colorValues[index] = ColorTables[colorRange][colorValues[index]];
+
+            std::array<Endpoints, 4> endpoints;
+            for (u32 partition{}, valueOffset{}; partition < partitionCount; partition++) {
+                if (!DecodeEndpoints(modes[partition], colorValues.data() + valueOffset, endpoints[partition]))
+                    return Error();
+                valueOffset += ((modes[partition] >> 2) + 1) * 2;
+            }
+
+            // The weights are stored in reverse from the top of the block
+            std::array<u8, MaxWeights> weights;
+            DecodeIse(bits.Reversed(), 0, weightBits, weightRange, weightCount, weights.data());
+            for (u32 index{}; index < weightCount; index++)
+                weights[index] = UnquantizeWeight(weights[index], weightRange);
+
+            // The weights are infilled from the grid to every texel of the block, the weights of both planes are interleaved
+            std::array<std::array<u8, MaxTexels>, 2> texelWeights;
+            u32 planeCount{dualPlane ? 2U : 1U};
+            if (gridWidth == width && gridHeight == height) {
+                for (u32 texel{}; texel < texelCount; texel++)
+                    for (u32 plane{}; plane < planeCount; plane++)
+                        texelWeights[plane][texel] = weights[(texel * planeCount) + plane];
+            } else {
+                const auto &infill{tables.GetInfill(static_cast<u8>(gridWidth), static_cast<u8>(gridHeight))};
+                for (u32 texel{}; texel < texelCount; texel++) {
+                    const auto &entry{infill[texel]};
+                    for (u32 plane{}; plane < planeCount; plane++) {
+                        u32 sum{8};
+                        for (size_t corner{}; corner < entry.indices.size(); corner++)
+                            sum += weights[(entry.indices[corner] * planeCount) + plane] * entry.factors[corner];
+                        texelWeights[plane][texel] = static_cast<u8>(sum >> 4);
+                    }
+                }
+            }
+
+            const PartitionTable *partitions{partitionCount > 1 ? &tables.GetPartitions(partitionCount, partitionSeed) : nullptr};
+            for (u32 texel{}; texel < texelCount; texel++) {
+                const auto &endpoint{endpoints[partitions ? (*partitions)[texel] : 0]};
+                u32 color{};
+                for (u32 channel{}; channel < 4; channel++) {
+                    // Endpoints are expanded to 16 bits before interpolation and the top 8 bits of the result are used
+                    u32 weight{texelWeights[channel == planeChannel][texel]};
+                    u32 value{((endpoint[0][channel] * 257U * (64 - weight)) + (endpoint[1][channel] * 257U * weight) + 32) >> 6};
+                    color |= (value >> 8) << (channel * 8);
+                }
+                texels[texel] = color;
+            }
+        }
+    }
+
+    template<u8 BlockWidth, u8 BlockHeight>
+    void Decode(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        static FootprintTables tables(BlockWidth, BlockHeight);
+
+        if (!outputPitch)
+            outputPitch = static_cast<size_t>(width) * sizeof(u32);
+
+        std::array<u32, BlockWidth * BlockHeight> texels;
+        for (u32 y{}; y < height; y += BlockHeight) {
+            auto outputRow = output + (y * outputPitch);
+            u32 lines{std::min<u32>(BlockHeight, height - y)};
+
+            for (u32 x{}; x < width; x += BlockWidth, input += BlockSize) {
+                DecodeBlock(input, texels.data(), BlockWidth, BlockHeight, tables);
+
+                auto outputBlock = outputRow + (x * sizeof(u32));
+                u32 columns{std::min<u32>(BlockWidth, width - x)};
+                for (u32 line{}; line < lines; line++)
+                    std::memcpy(outputBlock + (line * outputPitch), texels.data() + (line * BlockWidth), columns * sizeof(u32));
+            }
+        }
+    }
+
+    template void Decode<4, 4>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<5, 4>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<5, 5>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<6, 5>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<6, 6>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<8, 5>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<8, 6>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<8, 8>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<10, 5>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<10, 6>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<10, 8>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<10, 10>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<12, 10>(const u8 *, u8 *, u32, u32, size_t);
+    template void Decode<12, 12>(const u8 *, u8 *, u32, u32, size_t);
+}
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+/**
+ * @brief This namespace holds a decoder for the LDR profile of ASTC (Adaptive Scalable Texture Compression) which decodes linear 2D blocks into RGBA8888 texels
+ * @note Reference on ASTC: https://www.khronos.org/registry/DataFormat/specs/1.3/dataformat.1.3.html#ASTC
+ */
+namespace skyline::gpu::texture::astc {
+    /**
+     * @brief Decodes an ASTC surface, blocks which are invalid or use HDR endpoints are decoded as the error color (magenta)
+     * @tparam BlockWidth The width of a block in texels
+     * @tparam BlockHeight The height of a block in texels
+     * @param input The linear surface of blocks with rows of ceil(width / BlockWidth) blocks
+     * @param output The RGBA8888 surface
+     * @param width The width of the surface in texels
+     * @param height The height of the surface in texels
+     * @param outputPitch The distance between lines of the output in bytes, this is the width of the surface in bytes if it's 0
+     * @note This is thread-safe so a surface can be decoded by multiple threads at once in ranges of block rows
+     */
+    template<u8 BlockWidth, u8 BlockHeight>
+    void Decode(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+}
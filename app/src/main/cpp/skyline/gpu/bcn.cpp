@@ -0,0 +1,524 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <cmath>
+#include "bcn.h"
+
+namespace skyline::gpu::texture::bcn {
+    namespace {
+        constexpr u8 BlockWidth{4}; //!< The width of a block in texels
+        constexpr u8 BlockHeight{4}; //!< The height of a block in texels
+
+        using Texels = std::array<u32, BlockWidth * BlockHeight>; //!< The RGBA8888 texels of a block in row-major order
+
+        constexpr u32 PackRgba(u32 red, u32 green, u32 blue, u32 alpha) {
+            return red | (green << 8) | (blue << 16) | (alpha << 24);
+        }
+
+        /**
+         * @brief This reads bit fields out of a 128-bit block starting from the least significant bit of the first byte
+         */
+        class BitReader {
+          private:
+            u64 low; //!< The lower 64 bits of the block which haven't been read yet
+            u64 high; //!< The upper 64 bits of the block which haven't been read yet
+
+          public:
+            BitReader(const u8 *block) {
+                std::memcpy(&low, block, sizeof(u64));
+                std::memcpy(&high, block + sizeof(u64), sizeof(u64));
+            }
+
+            /**
+             * @param count The amount of bits to read, this must be less than 32
+             */
+            inline u32 Read(u8 count) {
+                if (!count)
+                    return 0;
+                auto value = static_cast<u32>(low & ((1ULL << count) - 1));
+                low = (low >> count) | (high << (64 - count));
+                high >>= count;
+                return value;
+            }
+
+            /**
+             * @brief Reads a bit field which is stored with its most significant bit first
+             */
+            inline u32 ReadReversed(u8 count) {
+                u32 value{};
+                for (u8 bit{}; bit < count; bit++)
+                    value = (value << 1) | Read(1);
+                return value;
+            }
+        };
+
+        /**
+         * @brief Decodes the color block shared by BC1, BC2 and BC3
+         * @param allowTransparent If the 3-color mode with transparent black is used when the first endpoint isn't larger than the second, this is only the case for BC1
+         */
+        void DecodeColorBlock(const u8 *block, Texels &texels, bool allowTransparent) {
+            u16 color0{static_cast<u16>(block[0] | (block[1] << 8))}, color1{static_cast<u16>(block[2] | (block[3] << 8))};
+            u32 indices{block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<u32>(block[7]) << 24)};
+
+            auto Expand = [](u16 color, u32 &red, u32 &green, u32 &blue) {
+                red = (color >> 11) & 0x1F;
+                green = (color >> 5) & 0x3F;
+                blue = color & 0x1F;
+                red = (red << 3) | (red >> 2);
+                green = (green << 2) | (green >> 4);
+                blue = (blue << 3) | (blue >> 2);
+            };
+
+            u32 r0, g0, b0, r1, g1, b1;
+            Expand(color0, r0, g0, b0);
+            Expand(color1, r1, g1, b1);
+
+            std::array<u32, 4> palette{PackRgba(r0, g0, b0, 0xFF), PackRgba(r1, g1, b1, 0xFF)};
+            if (color0 > color1 || !allowTransparent) {
+                palette[2] = PackRgba(((2 * r0) + r1) / 3, ((2 * g0) + g1) / 3, ((2 * b0) + b1) / 3, 0xFF);
+                palette[3] = PackRgba((r0 + (2 * r1)) / 3, (g0 + (2 * g1)) / 3, (b0 + (2 * b1)) / 3, 0xFF);
+            } else {
+                palette[2] = PackRgba((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 0xFF);
+                palette[3] = 0;
+            }
+
+            for (auto &texel : texels) {
+                texel = palette[indices & 0b11];
+                indices >>= 2;
+            }
+        }
+
+        /**
+         * @brief Decodes the interpolated single-channel block shared by BC3, BC4 and BC5
+         * @param shift The bit offset of the channel that the values are written into, the other channels are left untouched
+         */
+        void DecodeValueBlock(const u8 *block, Texels &texels, u8 shift) {
+            u32 value0{block[0]}, value1{block[1]};
+            u64 indices{};
+            std::memcpy(&indices, block + 2, 6);
+
+            std::array<u32, 8> palette{value0, value1};
+            if (value0 > value1) {
+                for (u32 index{1}; index < 7; index++)
+                    palette[index + 1] = (((7 - index) * value0) + (index * value1)) / 7;
+            } else {
+                for (u32 index{1}; index < 5; index++)
+                    palette[index + 1] = (((5 - index) * value0) + (index * value1)) / 5;
+                palette[6] = 0;
+                palette[7] = 0xFF;
+            }
+
+            for (auto &texel : texels) {
+                texel = (texel & ~(0xFFU << shift)) | (palette[indices & 0b111] << shift);
+                indices >>= 3;
+            }
+        }
+
+        /**
+         * @brief Decodes every block of a surface and writes the texels which are inside of the surface to the output
+         * @tparam BlockSize The size of a single block in bytes
+         * @tparam DecodeBlock A function which decodes a single block into texels
+         */
+        template<size_t BlockSize, void (*DecodeBlock)(const u8 *, Texels &)>
+        void DecodeSurface(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+            if (!outputPitch)
+                outputPitch = static_cast<size_t>(width) * sizeof(u32);
+
+            Texels texels;
+            for (u32 y{}; y < height; y += BlockHeight) {
+                auto outputRow = output + (y * outputPitch);
+                u32 lines{std::min<u32>(BlockHeight, height - y)};
+
+                for (u32 x{}; x < width; x += BlockWidth, input += BlockSize) {
+                    DecodeBlock(input, texels);
+
+                    auto outputBlock = outputRow + (x * sizeof(u32));
+                    u32 columns{std::min<u32>(BlockWidth, width - x)};
+                    for (u32 line{}; line < lines; line++)
+                        std::memcpy(outputBlock + (line * outputPitch), texels.data() + (line * BlockWidth), columns * sizeof(u32));
+                }
+            }
+        }
+
+        void DecodeBc1Block(const u8 *block, Texels &texels) {
+            DecodeColorBlock(block, texels, true);
+        }
+
+        void DecodeBc2Block(const u8 *block, Texels &texels) {
+            DecodeColorBlock(block + 8, texels, false);
+
+            u64 alpha;
+            std::memcpy(&alpha, block, sizeof(u64));
+            for (auto &texel : texels) {
+                texel = (texel & 0xFFFFFF) | (static_cast<u32>((alpha & 0xF) * 0x11) << 24);
+                alpha >>= 4;
+            }
+        }
+
+        void DecodeBc3Block(const u8 *block, Texels &texels) {
+            DecodeColorBlock(block + 8, texels, false);
+            DecodeValueBlock(block, texels, 24);
+        }
+
+        void DecodeBc4Block(const u8 *block, Texels &texels) {
+            texels.fill(PackRgba(0, 0, 0, 0xFF));
+            DecodeValueBlock(block, texels, 0);
+        }
+
+        void DecodeBc5Block(const u8 *block, Texels &texels) {
+            texels.fill(PackRgba(0, 0, 0, 0xFF));
+            DecodeValueBlock(block, texels, 0);
+            DecodeValueBlock(block + 8, texels, 8);
+        }
+
+        /**
+         * @brief The subsets of the texels for every 2-subset partition, bit N is the subset of texel N
+         */
+        constexpr std::array<u16, 64> Partitions2{
+            0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+            0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+            0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+            0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+        };
+
+        /**
+         * @brief The subsets of the texels for every 3-subset partition, every texel is 2 bits with texel 0 being the least significant
+         */
+        constexpr std::array<u32, 64> Partitions3{
+            0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050, 0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+            0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500, 0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+            0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50, 0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+            0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000, 0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+        };
+
+        /**
+         * @brief The anchor texel of the second subset for every 2-subset partition, anchor texels have one less index bit as the most significant bit is implicitly 0
+         */
+        constexpr std::array<u8, 64> Anchors2{
+            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+            15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+            15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+            6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+        };
+
+        /**
+         * @brief The anchor texel of the second subset for every 3-subset partition
+         */
+        constexpr std::array<u8, 64> Anchors3Second{
+            3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+            3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+            8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+            3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+        };
+
+        /**
+         * @brief The anchor texel of the third subset for every 3-subset partition
+         */
+        constexpr std::array<u8, 64> Anchors3Third{
+            15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+            15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+            15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+            15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+        };
+
+        constexpr std::array<u8, 4> Weights2{0, 21, 43, 64}; //!< The interpolation weights for 2-bit indices
+        constexpr std::array<u8, 8> Weights3{0, 9, 18, 27, 37, 46, 55, 64}; //!< The interpolation weights for 3-bit indices
+        constexpr std::array<u8, 16> Weights4{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64}; //!< The interpolation weights for 4-bit indices
+
+        constexpr const u8 *GetWeights(u8 indexBits) {
+            return (indexBits == 2) ? Weights2.data() : ((indexBits == 3) ? Weights3.data() : Weights4.data());
+        }
+
+        constexpr u32 Interpolate(u32 endpoint0, u32 endpoint1, u32 weight) {
+            return (((64 - weight) * endpoint0) + (weight * endpoint1) + 32) >> 6;
+        }
+
+        /**
+         * @return The subset of a texel in a partition
+         */
+        inline u8 GetSubset(u8 subsetCount, u8 partition, u8 texel) {
+            if (subsetCount == 2)
+                return static_cast<u8>((Partitions2[partition] >> texel) & 0b1);
+            else if (subsetCount == 3)
+                return static_cast<u8>((Partitions3[partition] >> (texel * 2)) & 0b11);
+            return 0;
+        }
+
+        /**
+         * @return If a texel is the anchor texel of any subset in a partition
+         */
+        inline bool IsAnchor(u8 subsetCount, u8 partition, u8 texel) {
+            if (texel == 0)
+                return true;
+            else if (subsetCount == 2)
+                return texel == Anchors2[partition];
+            else if (subsetCount == 3)
+                return texel == Anchors3Second[partition] || texel == Anchors3Third[partition];
+            return false;
+        }
+
+        /**
+         * @brief The layout of a single BC7 mode
+         */
+        struct Bc7Mode {
+            u8 subsetCount;
+            u8 partitionBits;
+            u8 rotationBits;
+            u8 indexSelectionBits;
+            u8 colorBits; //!< The bits per color channel of an endpoint, excluding the P-bit
+            u8 alphaBits; //!< The bits of the alpha channel of an endpoint, excluding the P-bit
+            bool endpointPBits; //!< If every endpoint has a unique P-bit
+            bool sharedPBits; //!< If both endpoints of a subset share a P-bit
+            u8 indexBits;
+            u8 secondaryIndexBits; //!< The bits of the second set of indices, these are used for alpha or color depending on the index selection bit
+        };
+
+        constexpr std::array<Bc7Mode, 8> Bc7Modes{{
+            {3, 4, 0, 0, 4, 0, true, false, 3, 0},
+            {2, 6, 0, 0, 6, 0, false, true, 3, 0},
+            {3, 6, 0, 0, 5, 0, false, false, 2, 0},
+            {2, 6, 0, 0, 7, 0, true, false, 2, 0},
+            {1, 0, 2, 1, 5, 6, false, false, 2, 3},
+            {1, 0, 2, 0, 7, 8, false, false, 2, 2},
+            {1, 0, 0, 0, 7, 7, true, false, 4, 0},
+            {2, 6, 0, 0, 5, 5, true, false, 2, 0},
+        }};
+
+        void DecodeBc7Block(const u8 *block, Texels &texels) {
+            BitReader bits(block);
+
+            u8 modeIndex{};
+            while (modeIndex < Bc7Modes.size() && !bits.Read(1))
+                modeIndex++;
+            if (modeIndex == Bc7Modes.size()) {
+                texels.fill(0); // Reserved modes are decoded as transparent black
+                return;
+            }
+            const auto &mode{Bc7Modes[modeIndex]};
+
+            auto partition{static_cast<u8>(bits.Read(mode.partitionBits))};
+            auto rotation{bits.Read(mode.rotationBits)};
+            auto indexSelection{bits.Read(mode.indexSelectionBits)};
+
+            std::array<std::array<std::array<u32, 4>, 2>, 3> endpoints{}; // Indexed by subset, endpoint and channel
+            for (u8 channel{}; channel < 3; channel++)
+                for (u8 subset{}; subset < mode.subsetCount; subset++)
+                    for (auto &endpoint : endpoints[subset])
+                        endpoint[channel] = bits.Read(mode.colorBits);
+            if (mode.alphaBits)
+                for (u8 subset{}; subset < mode.subsetCount; subset++)
+                    for (auto &endpoint : endpoints[subset])
+                        endpoint[3] = bits.Read(mode.alphaBits);
+
+            bool hasPBits{mode.endpointPBits || mode.sharedPBits};
+            if (hasPBits) {
+                for (u8 subset{}; subset < mode.subsetCount; subset++) {
+                    u32 sharedPBit{mode.sharedPBits ? bits.Read(1) : 0};
+                    for (auto &endpoint : endpoints[subset]) {
+                        u32 pBit{mode.endpointPBits ? bits.Read(1) : sharedPBit};
+                        for (auto &component : endpoint)
+                            component = (component << 1) | pBit;
+                    }
+                }
+            }
+
+            // The endpoints are expanded to 8 bits by replicating their most significant bits into the low bits
+            u8 colorPrecision{static_cast<u8>(mode.colorBits + hasPBits)}, alphaPrecision{static_cast<u8>(mode.alphaBits ? (mode.alphaBits + hasPBits) : 0)};
+            for (u8 subset{}; subset < mode.subsetCount; subset++) {
+                for (auto &endpoint : endpoints[subset]) {
+                    for (u8 channel{}; channel < 3; channel++) {
+                        endpoint[channel] <<= 8 - colorPrecision;
+                        endpoint[channel] |= endpoint[channel] >> colorPrecision;
+                    }
+                    if (alphaPrecision) {
+                        endpoint[3] <<= 8 - alphaPrecision;
+                        endpoint[3] |= endpoint[3] >> alphaPrecision;
+                    } else {
+                        endpoint[3] = 0xFF;
+                    }
+                }
+            }
+
+            std::array<u8, 16> indices, secondaryIndices{};
+            for (u8 texel{}; texel < indices.size(); texel++)
+                indices[texel] = static_cast<u8>(bits.Read(mode.indexBits - IsAnchor(mode.subsetCount, partition, texel)));
+            if (mode.secondaryIndexBits)
+                for (u8 texel{}; texel < secondaryIndices.size(); texel++)
+                    secondaryIndices[texel] = static_cast<u8>(bits.Read(mode.secondaryIndexBits - (texel == 0)));
+
+            // Modes with two sets of indices use the first set for color and the second one for alpha unless the index selection bit swaps them
+            const auto &colorIndices{indexSelection ? secondaryIndices : indices};
+            const auto &alphaIndices{(mode.secondaryIndexBits && !indexSelection) ? secondaryIndices : indices};
+            auto colorWeights{GetWeights(indexSelection ? mode.secondaryIndexBits : mode.indexBits)};
+            auto alphaWeights{GetWeights((mode.secondaryIndexBits && !indexSelection) ? mode.secondaryIndexBits : mode.indexBits)};
+
+            for (u8 texel{}; texel < texels.size(); texel++) {
+                const auto &subset{endpoints[GetSubset(mode.subsetCount, partition, texel)]};
+                std::array<u32, 4> color;
+                for (u8 channel{}; channel < 3; channel++)
+                    color[channel] = Interpolate(subset[0][channel], subset[1][channel], colorWeights[colorIndices[texel]]);
+                color[3] = Interpolate(subset[0][3], subset[1][3], alphaWeights[alphaIndices[texel]]);
+
+                if (rotation)
+                    std::swap(color[3], color[rotation - 1]); // The rotation swaps alpha with red, green or blue
+
+                texels[texel] = PackRgba(color[0], color[1], color[2], color[3]);
+            }
+        }
+
+        /**
+         * @brief The fields of a BC6H block header, W and X are the endpoints of the first subset while Y and Z are the endpoints of the second subset
+         */
+        enum Bc6Field : u8 {
+            RW, GW, BW, RX, GX, BX, RY, GY, BY, RZ, GZ, BZ, D,
+        };
+
+        /**
+         * @brief A run of bits in a BC6H block header that belongs to a single field
+         */
+        struct Bc6Segment {
+            u8 field;
+            u8 shift; //!< The position of the first bit of the run in the field
+            u8 count; //!< The amount of bits in the run
+            bool reversed{}; //!< If the run is stored with its most significant bit first
+        };
+
+        /**
+         * @brief The layout of a single BC6H mode
+         */
+        struct Bc6Mode {
+            u8 code; //!< The value of the mode bits
+            u8 subsetCount;
+            bool transformed; //!< If every endpoint except for the first one is stored as a signed delta from it
+            u8 endpointBits; //!< The precision of the endpoints
+            std::array<u8, 3> deltaBits; //!< The bits of every channel of the deltas
+            u8 segmentCount;
+            std::array<Bc6Segment, 24> segments; //!< The layout of the header after the mode bits
+        };
+
+        constexpr std::array<Bc6Mode, 14> Bc6Modes{{
+            {0b00, 2, true, 10, {5, 5, 5}, 20, {{{GY, 4, 1}, {BY, 4, 1}, {BZ, 4, 1}, {RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+            {0b01, 2, true, 7, {6, 6, 6}, 24, {{{GY, 5, 1}, {GZ, 4, 1}, {GZ, 5, 1}, {RW, 0, 7}, {BZ, 0, 1}, {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 7}, {BY, 5, 1}, {BZ, 2, 1}, {GY, 4, 1}, {BW, 0, 7}, {BZ, 3, 1}, {BZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 6}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 6}, {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}, {D, 0, 5}}}},
+            {0b00010, 2, true, 11, {5, 4, 4}, 19, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 5}, {RW, 10, 1}, {GY, 0, 4}, {GX, 0, 4}, {GW, 10, 1}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 4}, {BW, 10, 1}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+            {0b00110, 2, true, 11, {4, 5, 4}, 21, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 10, 1}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5}, {GW, 10, 1}, {GZ, 0, 4}, {BX, 0, 4}, {BW, 10, 1}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 4}, {BZ, 0, 1}, {BZ, 2, 1}, {RZ, 0, 4}, {GY, 4, 1}, {BZ, 3, 1}, {D, 0, 5}}}},
+            {0b01010, 2, true, 11, {4, 4, 5}, 21, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 10, 1}, {BY, 4, 1}, {GY, 0, 4}, {GX, 0, 4}, {GW, 10, 1}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BW, 10, 1}, {BY, 0, 4}, {RY, 0, 4}, {BZ, 1, 1}, {BZ, 2, 1}, {RZ, 0, 4}, {BZ, 4, 1}, {BZ, 3, 1}, {D, 0, 5}}}},
+            {0b01110, 2, true, 9, {5, 5, 5}, 20, {{{RW, 0, 9}, {BY, 4, 1}, {GW, 0, 9}, {GY, 4, 1}, {BW, 0, 9}, {BZ, 4, 1}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+            {0b10010, 2, true, 8, {6, 5, 5}, 20, {{{RW, 0, 8}, {GZ, 4, 1}, {BY, 4, 1}, {GW, 0, 8}, {BZ, 2, 1}, {GY, 4, 1}, {BW, 0, 8}, {BZ, 3, 1}, {BZ, 4, 1}, {RX, 0, 6}, {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}, {D, 0, 5}}}},
+            {0b10110, 2, true, 8, {5, 6, 5}, 22, {{{RW, 0, 8}, {BZ, 0, 1}, {BY, 4, 1}, {GW, 0, 8}, {GY, 5, 1}, {GY, 4, 1}, {BW, 0, 8}, {GZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 5}, {BZ, 1, 1}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+            {0b11010, 2, true, 8, {5, 5, 6}, 22, {{{RW, 0, 8}, {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 8}, {BY, 5, 1}, {GY, 4, 1}, {BW, 0, 8}, {BZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 5}, {GZ, 4, 1}, {GY, 0, 4}, {GX, 0, 5}, {BZ, 0, 1}, {GZ, 0, 4}, {BX, 0, 6}, {BY, 0, 4}, {RY, 0, 5}, {BZ, 2, 1}, {RZ, 0, 5}, {BZ, 3, 1}, {D, 0, 5}}}},
+            {0b11110, 2, false, 6, {6, 6, 6}, 24, {{{RW, 0, 6}, {GZ, 4, 1}, {BZ, 0, 1}, {BZ, 1, 1}, {BY, 4, 1}, {GW, 0, 6}, {GY, 5, 1}, {BY, 5, 1}, {BZ, 2, 1}, {GY, 4, 1}, {BW, 0, 6}, {GZ, 5, 1}, {BZ, 3, 1}, {BZ, 5, 1}, {BZ, 4, 1}, {RX, 0, 6}, {GY, 0, 4}, {GX, 0, 6}, {GZ, 0, 4}, {BX, 0, 6}, {BY, 0, 4}, {RY, 0, 6}, {RZ, 0, 6}, {D, 0, 5}}}},
+            {0b00011, 1, false, 10, {10, 10, 10}, 6, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 10}, {GX, 0, 10}, {BX, 0, 10}}}},
+            {0b00111, 1, true, 11, {9, 9, 9}, 9, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 9}, {RW, 10, 1}, {GX, 0, 9}, {GW, 10, 1}, {BX, 0, 9}, {BW, 10, 1}}}},
+            {0b01011, 1, true, 12, {8, 8, 8}, 9, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 8}, {RW, 10, 2, true}, {GX, 0, 8}, {GW, 10, 2, true}, {BX, 0, 8}, {BW, 10, 2, true}}}},
+            {0b01111, 1, true, 16, {4, 4, 4}, 9, {{{RW, 0, 10}, {GW, 0, 10}, {BW, 0, 10}, {RX, 0, 4}, {RW, 10, 6, true}, {GX, 0, 4}, {GW, 10, 6, true}, {BX, 0, 4}, {BW, 10, 6, true}}}},
+        }};
+
+        /**
+         * @brief Converts an unsigned half-precision float into a UNORM8 value, values outside of [0, 1] are clamped
+         * @note Unquantized BC6H values are always finite so only the first 0x7C00 values need to be handled, these are looked up from a table
+         */
+        inline u8 HalfToUnorm8(u32 half) {
+            static const std::array<u8, 0x7C00> table{[] {
+                std::array<u8, 0x7C00> table{};
+                for (u32 value{}; value < table.size(); value++) {
+                    u32 exponent{value >> 10}, mantissa{value & 0x3FF};
+                    float result{exponent ? std::ldexp(static_cast<float>(mantissa | 0x400), static_cast<int>(exponent) - 25) : std::ldexp(static_cast<float>(mantissa), -24)};
+                    table[value] = static_cast<u8>((std::min(result, 1.0f) * 255.0f) + 0.5f);
+                }
+                return table;
+            }()};
+            return table[half];
+        }
+
+        void DecodeBc6hBlock(const u8 *block, Texels &texels) {
+            BitReader bits(block);
+
+            auto code{static_cast<u8>(bits.Read(2))};
+            if (code > 1)
+                code |= bits.Read(3) << 2;
+
+            auto mode{std::find_if(Bc6Modes.begin(), Bc6Modes.end(), [code](const Bc6Mode &mode) { return mode.code == code; })};
+            if (mode == Bc6Modes.end()) {
+                texels.fill(PackRgba(0, 0, 0, 0xFF)); // Reserved modes are decoded as opaque black
+                return;
+            }
+
+            std::array<u32, D + 1> fields{};
+            for (u8 index{}; index < mode->segmentCount; index++) {
+                const auto &segment{mode->segments[index]};
+                fields[segment.field] |= (segment.reversed ? bits.ReadReversed(segment.count) : bits.Read(segment.count)) << segment.shift;
+            }
+
+            // Endpoints are indexed by endpoint (W, X, Y, Z) and channel
+            u8 endpointCount{static_cast<u8>(mode->subsetCount * 2)};
+            u32 endpointMask{(1U << mode->endpointBits) - 1};
+            std::array<std::array<u32, 3>, 4> endpoints;
+            for (u8 channel{}; channel < 3; channel++) {
+                for (u8 endpoint{}; endpoint < endpointCount; endpoint++) {
+                    auto value{fields[(endpoint * 3) + channel]};
+                    if (mode->transformed && endpoint) {
+                        // The delta is sign-extended and added to the first endpoint with the result wrapping around at the precision of the endpoints
+                        u8 deltaBits{mode->deltaBits[channel]};
+                        auto delta{static_cast<i32>(value << (32 - deltaBits)) >> (32 - deltaBits)};
+                        value = static_cast<u32>(static_cast<i32>(fields[channel]) + delta) & endpointMask;
+                    }
+
+                    // The endpoint is unquantized into 16 bits while keeping 0 and the maximum value exact
+                    if (mode->endpointBits >= 15)
+                        endpoints[endpoint][channel] = value;
+                    else if (value == 0)
+                        endpoints[endpoint][channel] = 0;
+                    else if (value == endpointMask)
+                        endpoints[endpoint][channel] = 0xFFFF;
+                    else
+                        endpoints[endpoint][channel] = ((value << 16) + 0x8000) >> mode->endpointBits;
+                }
+            }
+
+            auto partition{static_cast<u8>(fields[D])};
+            u8 indexBits{static_cast<u8>((mode->subsetCount == 2) ? 3 : 4)};
+            auto weights{GetWeights(indexBits)};
+
+            for (u8 texel{}; texel < texels.size(); texel++) {
+                auto index{bits.Read(indexBits - IsAnchor(mode->subsetCount, partition, texel))};
+                u8 subset{GetSubset(mode->subsetCount, partition, texel)};
+
+                std::array<u32, 3> color;
+                for (u8 channel{}; channel < 3; channel++) {
+                    auto value{Interpolate(endpoints[subset * 2][channel], endpoints[(subset * 2) + 1][channel], weights[index])};
+                    color[channel] = HalfToUnorm8((value * 31) >> 6); // The interpolated value is scaled into the range of finite half-precision floats
+                }
+
+                texels[texel] = PackRgba(color[0], color[1], color[2], 0xFF);
+            }
+        }
+    }
+
+    void DecodeBc1(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        DecodeSurface<8, DecodeBc1Block>(input, output, width, height, outputPitch);
+    }
+
+    void DecodeBc2(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        DecodeSurface<16, DecodeBc2Block>(input, output, width, height, outputPitch);
+    }
+
+    void DecodeBc3(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        DecodeSurface<16, DecodeBc3Block>(input, output, width, height, outputPitch);
+    }
+
+    void DecodeBc4(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        DecodeSurface<8, DecodeBc4Block>(input, output, width, height, outputPitch);
+    }
+
+    void DecodeBc5(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        DecodeSurface<16, DecodeBc5Block>(input, output, width, height, outputPitch);
+    }
+
+    void DecodeBc6h(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        DecodeSurface<16, DecodeBc6hBlock>(input, output, width, height, outputPitch);
+    }
+
+    void DecodeBc7(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch) {
+        DecodeSurface<16, DecodeBc7Block>(input, output, width, height, outputPitch);
+    }
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+/**
+ * @brief This namespace holds decoders for the BCn (Block Compression) texture formats which decode linear 4x4 blocks into RGBA8888 texels
+ * @note All decoders share the signature of texture::Format::DecodeFunction, the input is a tightly packed linear surface of blocks with rows of ceil(width / 4) blocks
+ * @note Reference on BC1-BC5: https://docs.microsoft.com/en-us/windows/win32/direct3d10/d3d10-graphics-programming-guide-resources-block-compression
+ * @note Reference on BC6H and BC7: https://docs.microsoft.com/en-us/windows/win32/direct3d11/bc6h-format and https://docs.microsoft.com/en-us/windows/win32/direct3d11/bc7-format
+ */
+namespace skyline::gpu::texture::bcn {
+    /**
+     * @brief Decodes a BC1 surface, blocks which use the 3-color mode have transparent black as their fourth color
+     * @param input The linear surface of blocks
+     * @param output The RGBA8888 surface
+     * @param width The width of the surface in texels
+     * @param height The height of the surface in texels
+     * @param outputPitch The distance between lines of the output in bytes, this is the width of the surface in bytes if it's 0
+     */
+    void DecodeBc1(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+
+    /**
+     * @brief Decodes a BC2 surface which has explicit 4-bit alpha
+     */
+    void DecodeBc2(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+
+    /**
+     * @brief Decodes a BC3 surface which has interpolated alpha
+     */
+    void DecodeBc3(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+
+    /**
+     * @brief Decodes a single-channel BC4 surface, the value is written into the red channel
+     */
+    void DecodeBc4(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+
+    /**
+     * @brief Decodes a two-channel BC5 surface, the values are written into the red and green channels
+     */
+    void DecodeBc5(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+
+    /**
+     * @brief Decodes an unsigned BC6H surface, the HDR values are clamped to [0, 1]
+     */
+    void DecodeBc6h(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+
+    /**
+     * @brief Decodes a BC7 surface
+     */
+    void DecodeBc7(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+}
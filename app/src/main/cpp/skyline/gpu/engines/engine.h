@@ -29,6 +29,33 @@ namespace skyline::gpu {
         bool lastCall; //!< If this is the last call in the pushbuffer entry to this specific macro
     };
 
+    /**
+     * @brief This enumerates the ways the method address changes over a batch of method calls
+     */
+    enum class IncrementMode : u8 {
+        Increment, //!< The method address is incremented after every argument
+        NonIncrement, //!< The method address stays the same for every argument
+        IncrementOnce, //!< The method address is only incremented after the first argument
+    };
+
+    /**
+     * @param method The method address of the first argument in the batch
+     * @param index The index of the argument in the batch
+     * @param mode The increment mode of the batch
+     * @return The method address of the argument at the specified index in the batch
+     */
+    constexpr u16 GetBatchMethodAddress(u16 method, size_t index, IncrementMode mode) {
+        switch (mode) {
+            case IncrementMode::Increment:
+                return static_cast<u16>(method + index);
+            case IncrementMode::NonIncrement:
+                return method;
+            case IncrementMode::IncrementOnce:
+                return static_cast<u16>(method + (index ? 1 : 0));
+        }
+        return method;
+    }
+
     namespace engine {
         /**
         * @brief The Engine class provides an interface that can be used to communicate with the GPU's internal engines
@@ -48,6 +75,19 @@ namespace skyline::gpu {
             virtual void CallMethod(MethodParams params) {
                 state.logger->Warn("Called method in unimplemented engine: 0x{:X} args: 0x{:X}", params.method, params.argument);
             };
+
+            /**
+            * @brief Calls an engine method with a batch of arguments, this is equivalent to calling CallMethod for every argument
+            * @param method The method address of the first argument
+            * @param arguments The arguments of the method calls, the last of which is the last call in the pushbuffer entry
+            * @param subChannel The subchannel the methods were called on
+            * @param mode The way the method address changes over the batch
+            * @note Engines should override this to handle runs of arguments at once where possible
+            */
+            virtual void CallMethodBatch(u16 method, std::span<const u32> arguments, u32 subChannel, IncrementMode mode) {
+                for (size_t index{}; index < arguments.size(); index++)
+                    CallMethod(MethodParams{GetBatchMethodAddress(method, index, mode), arguments[index], subChannel, index == arguments.size() - 1});
+            }
         };
     }
 }
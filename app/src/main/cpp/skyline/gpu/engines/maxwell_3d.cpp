@@ -5,11 +5,88 @@
 #include <gpu/syncpoint.h>
 #include "maxwell_3d.h"
 
+#define MAXWELL3D_SIZE(field) (sizeof(skyline::gpu::engine::Maxwell3D::Registers::field) / sizeof(u32))
+
 namespace skyline::gpu::engine {
-    Maxwell3D::Maxwell3D(const DeviceState &state) : Engine(state), macroInterpreter(*this) {
+    /**
+     * @brief A map from every register to the state group it belongs to, this is generated at compile-time from the register layout
+     */
+    constexpr auto StateGroupMap = []() {
+        using StateGroup = Maxwell3D::StateGroup;
+
+        std::array<StateGroup, constant::Maxwell3DRegisterCounter> map{};
+        for (auto &group : map)
+            group = StateGroup::None;
+
+        auto SetRange = [&map](size_t offset, size_t size, StateGroup group) {
+            for (size_t index{offset}; index < offset + size; index++)
+                map[index] = group;
+        };
+
+        SetRange(MAXWELL3D_OFFSET(viewportTransform), MAXWELL3D_SIZE(viewportTransform), StateGroup::Viewport);
+        SetRange(MAXWELL3D_OFFSET(viewport), MAXWELL3D_SIZE(viewport), StateGroup::Viewport);
+        SetRange(MAXWELL3D_OFFSET(viewportTransformEnable), 1, StateGroup::Viewport);
+
+        SetRange(MAXWELL3D_OFFSET(rasterizerEnable), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(polygonMode), MAXWELL3D_SIZE(polygonMode), StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(lineWidthSmooth), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(lineWidthAliased), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(pointSpriteSize), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(pointSpriteEnable), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(polygonOffsetFactor), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(lineSmoothEnable), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(pointCoordReplace), MAXWELL3D_SIZE(pointCoordReplace), StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(cullFaceEnable), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(frontFace), 1, StateGroup::Rasterizer);
+        SetRange(MAXWELL3D_OFFSET(cullFace), 1, StateGroup::Rasterizer);
+
+        SetRange(MAXWELL3D_OFFSET(blendConstant), MAXWELL3D_SIZE(blendConstant), StateGroup::Blend);
+        SetRange(MAXWELL3D_OFFSET(blend), MAXWELL3D_SIZE(blend), StateGroup::Blend);
+        SetRange(MAXWELL3D_OFFSET(independentBlend), MAXWELL3D_SIZE(independentBlend), StateGroup::Blend);
+        SetRange(MAXWELL3D_OFFSET(multisampleControl), MAXWELL3D_SIZE(multisampleControl), StateGroup::Blend);
+
+        SetRange(MAXWELL3D_OFFSET(stencilBackExtra), MAXWELL3D_SIZE(stencilBackExtra), StateGroup::DepthStencil);
+        SetRange(MAXWELL3D_OFFSET(depthTestFunc), 1, StateGroup::DepthStencil);
+        SetRange(MAXWELL3D_OFFSET(stencilEnable), 1, StateGroup::DepthStencil);
+        SetRange(MAXWELL3D_OFFSET(stencilFront), MAXWELL3D_SIZE(stencilFront), StateGroup::DepthStencil);
+        SetRange(MAXWELL3D_OFFSET(stencilTwoSideEnable), 1, StateGroup::DepthStencil);
+        SetRange(MAXWELL3D_OFFSET(stencilBack), MAXWELL3D_SIZE(stencilBack), StateGroup::DepthStencil);
+
+        SetRange(MAXWELL3D_OFFSET(vertexAttributeState), MAXWELL3D_SIZE(vertexAttributeState), StateGroup::VertexAttributes);
+
+        SetRange(MAXWELL3D_OFFSET(rtSeparateFragData), 1, StateGroup::RenderTargets);
+        SetRange(MAXWELL3D_OFFSET(multisampleEnable), 1, StateGroup::RenderTargets);
+        SetRange(MAXWELL3D_OFFSET(depthTargetEnable), 1, StateGroup::RenderTargets);
+        SetRange(MAXWELL3D_OFFSET(colorMask), MAXWELL3D_SIZE(colorMask), StateGroup::RenderTargets);
+
+        return map;
+    }();
+
+    Maxwell3D::Maxwell3D(const DeviceState &state) : Engine(state), macroInterpreter(*this), macroThreadedInterpreter(state, *this, macroInterpreter, macroHle), macroHle(state) {
         ResetRegs();
     }
 
+    void Maxwell3D::MarkDirty(u32 method, size_t count) {
+        for (auto index{method}; index < std::min(method + count, static_cast<size_t>(constant::Maxwell3DRegisterCounter)); index++)
+            if (StateGroupMap[index] != StateGroup::None)
+                dirtyGroups.set(static_cast<size_t>(StateGroupMap[index]));
+    }
+
+    Maxwell3D::DirtyStateGroups Maxwell3D::ConsumeDirtyGroups() {
+        auto groups = dirtyGroups;
+        dirtyGroups.reset();
+        return groups;
+    }
+
+    bool Maxwell3D::ConsumeDirtyGroup(StateGroup group) {
+        if (group == StateGroup::None)
+            return false;
+
+        auto dirty = dirtyGroups.test(static_cast<size_t>(group));
+        dirtyGroups.reset(static_cast<size_t>(group));
+        return dirty;
+    }
+
     void Maxwell3D::ResetRegs() {
         registers = {};
 
@@ -72,6 +149,8 @@ namespace skyline::gpu::engine {
         }
 
         registers.viewportTransformEnable = true;
+
+        dirtyGroups.set(); // All state has to be translated after a reset
     }
 
     void Maxwell3D::CallMethod(MethodParams params) {
@@ -85,16 +164,14 @@ namespace skyline::gpu::engine {
             macroInvocation.arguments.push_back(params.argument);
 
             // Macros are always executed on the last method call in a pushbuffer entry
-            if (params.lastCall) {
-                macroInterpreter.Execute(macroPositions[macroInvocation.index], macroInvocation.arguments);
+            if (params.lastCall)
+                ExecuteMacro();
 
-                macroInvocation.arguments.clear();
-                macroInvocation.index = 0;
-            }
             return;
         }
 
         registers.raw[params.method] = params.argument;
+        MarkDirty(params.method);
 
         if (shadowRegisters.mme.shadowRamControl == Registers::MmeShadowRamControl::MethodTrack || shadowRegisters.mme.shadowRamControl == Registers::MmeShadowRamControl::MethodTrackWithFilter)
             shadowRegisters.raw[params.method] = params.argument;
@@ -106,6 +183,7 @@ namespace skyline::gpu::engine {
                 if (registers.mme.instructionRamPointer >= macroCode.size())
                     throw exception("Macro memory is full!");
 
+                macroThreadedInterpreter.InvalidateCode(registers.mme.instructionRamPointer, 1);
                 macroCode[registers.mme.instructionRamPointer++] = params.argument;
                 break;
             case MAXWELL3D_OFFSET(mme.startAddressRamLoad):
@@ -139,6 +217,95 @@ namespace skyline::gpu::engine {
         }
     }
 
+    void Maxwell3D::CallMethodBatch(u16 method, std::span<const u32> arguments, u32 subChannel, IncrementMode mode) {
+        state.logger->Debug("Called method batch in Maxwell 3D: 0x{:X} count: {}", method, arguments.size());
+
+        auto SetMacroIndex = [this](u16 macroMethod) {
+            if (!(macroMethod & 1))
+                macroInvocation.index = ((macroMethod - constant::Maxwell3DRegisterCounter) >> 1) % macroPositions.size();
+        };
+
+        if (method > constant::Maxwell3DRegisterCounter) {
+            // An incrementing run of macro methods spans several macros, this is handled by the generic path
+            if (mode != IncrementMode::Increment) {
+                SetMacroIndex(method);
+                if (mode == IncrementMode::IncrementOnce && arguments.size() > 1)
+                    SetMacroIndex(static_cast<u16>(method + 1));
+
+                macroInvocation.arguments.insert(macroInvocation.arguments.end(), arguments.begin(), arguments.end());
+                ExecuteMacro(); // The last argument in a batch is always the last call in the pushbuffer entry
+                return;
+            }
+        } else if (shadowRegisters.mme.shadowRamControl != Registers::MmeShadowRamControl::MethodReplay) {
+            // These are the only registers with side effects on writes, any other register write only has to be applied
+            constexpr std::array<u32, 6> SideEffectMethods{
+                MAXWELL3D_OFFSET(mme.instructionRamLoad),
+                MAXWELL3D_OFFSET(mme.startAddressRamLoad),
+                MAXWELL3D_OFFSET(mme.shadowRamControl),
+                MAXWELL3D_OFFSET(syncpointAction),
+                MAXWELL3D_OFFSET(semaphore.info),
+                MAXWELL3D_OFFSET(firmwareCall[4]),
+            };
+
+            bool shadowTrack{shadowRegisters.mme.shadowRamControl == Registers::MmeShadowRamControl::MethodTrack || shadowRegisters.mme.shadowRamControl == Registers::MmeShadowRamControl::MethodTrackWithFilter};
+            auto lastMethod = GetBatchMethodAddress(method, arguments.size() - 1, mode);
+
+            if (lastMethod < constant::Maxwell3DRegisterCounter && std::none_of(SideEffectMethods.begin(), SideEffectMethods.end(), [&](u32 sideEffectMethod) { return sideEffectMethod >= method && sideEffectMethod <= lastMethod; })) {
+                MarkDirty(method, lastMethod - method + 1);
+
+                if (mode == IncrementMode::Increment) {
+                    std::copy(arguments.begin(), arguments.end(), registers.raw.begin() + method);
+                    if (shadowTrack)
+                        std::copy(arguments.begin(), arguments.end(), shadowRegisters.raw.begin() + method);
+                } else {
+                    // Only the last write to each register in a non-incrementing run is visible
+                    registers.raw[method] = arguments.front();
+                    registers.raw[lastMethod] = arguments.back();
+                    if (shadowTrack) {
+                        shadowRegisters.raw[method] = arguments.front();
+                        shadowRegisters.raw[lastMethod] = arguments.back();
+                    }
+                }
+                return;
+            }
+
+            // Macro uploads are bulk copied into macro memory rather than being written a word at a time
+            auto UploadRun = [&](auto &target, u32 pointer, const char *fullMessage) -> u32 {
+                if (pointer + arguments.size() > target.size())
+                    throw exception(fullMessage);
+
+                std::copy(arguments.begin(), arguments.end(), target.begin() + pointer);
+
+                registers.raw[method] = arguments.back();
+                if (shadowTrack)
+                    shadowRegisters.raw[method] = arguments.back();
+
+                return pointer + static_cast<u32>(arguments.size());
+            };
+
+            if (mode == IncrementMode::NonIncrement) {
+                switch (method) {
+                    case MAXWELL3D_OFFSET(mme.instructionRamLoad):
+                        macroThreadedInterpreter.InvalidateCode(registers.mme.instructionRamPointer, arguments.size());
+                        registers.mme.instructionRamPointer = UploadRun(macroCode, registers.mme.instructionRamPointer, "Macro memory is full!");
+                        return;
+                    case MAXWELL3D_OFFSET(mme.startAddressRamLoad):
+                        registers.mme.startAddressRamPointer = UploadRun(macroPositions, registers.mme.startAddressRamPointer, "Maximum amount of macros reached!");
+                        return;
+                }
+            }
+        }
+
+        Engine::CallMethodBatch(method, arguments, subChannel, mode);
+    }
+
+    void Maxwell3D::ExecuteMacro() {
+        macroThreadedInterpreter.Execute(macroPositions[macroInvocation.index], macroInvocation.arguments);
+
+        macroInvocation.arguments.clear();
+        macroInvocation.index = 0;
+    }
+
     void Maxwell3D::HandleSemaphoreCounterOperation() {
         switch (registers.semaphore.info.counterType) {
             case Registers::SemaphoreInfo::CounterType::Zero:
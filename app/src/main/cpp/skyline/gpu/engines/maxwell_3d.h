@@ -4,9 +4,11 @@
 #pragma once
 
 #include <array>
+#include <bitset>
 #include <common.h>
 #include <gpu/texture.h>
 #include <gpu/macro_interpreter.h>
+#include <gpu/macro_threaded_interpreter.h>
 #include "engine.h"
 
 #define MAXWELL3D_OFFSET(field) U32_OFFSET(skyline::gpu::engine::Maxwell3D::Registers, field)
@@ -30,11 +32,43 @@ namespace skyline {
             } macroInvocation{}; //!< This hold the index and arguments of the macro that is pending execution
 
             MacroInterpreter macroInterpreter;
+            MacroThreadedInterpreter macroThreadedInterpreter;
+
+            /**
+             * @brief Executes the pending macro invocation with the arguments that have been collected for it
+             */
+            void ExecuteMacro();
 
             void HandleSemaphoreCounterOperation();
 
             void WriteSemaphoreResult(u64 result);
 
+          public:
+            /**
+             * @brief This enumerates the groups of registers which are translated into host state together
+             */
+            enum class StateGroup : u8 {
+                Viewport, //!< The viewport transforms and viewports
+                Rasterizer, //!< The rasterizer, polygon, culling, line and point state
+                Blend, //!< The blending state and the blend constant
+                DepthStencil, //!< The depth test and stencil state
+                VertexAttributes, //!< The vertex attribute state
+                RenderTargets, //!< The render target state such as color write masks
+                None = 0xFF, //!< The register doesn't belong to any state group
+            };
+            static constexpr size_t StateGroupCount{6}; //!< The amount of valid state groups
+            using DirtyStateGroups = std::bitset<StateGroupCount>; //!< A set of state groups, indexed by StateGroup
+
+          private:
+            DirtyStateGroups dirtyGroups; //!< The state groups that have been written to since they were last consumed
+
+            /**
+             * @brief Marks the state groups of a range of registers as dirty
+             * @param method The first register in the range
+             * @param count The amount of registers in the range
+             */
+            void MarkDirty(u32 method, size_t count = 1);
+
           public:
             /**
             * @brief This holds the Maxwell3D engine's register space
@@ -565,6 +599,7 @@ namespace skyline {
             Registers shadowRegisters{}; //!< The shadow registers, their function is controlled by the 'shadowRamControl' register
 
             std::array<u32, 0x10000> macroCode{}; //!< This is used to store GPU macros, the 256kb size is from Ryujinx
+            MacroHle macroHle; //!< The high-level implementations of macros and the statistics of their usage
 
             Maxwell3D(const DeviceState &state);
 
@@ -574,6 +609,23 @@ namespace skyline {
             void ResetRegs();
 
             void CallMethod(MethodParams params);
+
+            /**
+             * @brief This handles runs of macro arguments, register writes and macro uploads at once and falls back to CallMethod for methods with side effects
+             */
+            void CallMethodBatch(u16 method, std::span<const u32> arguments, u32 subChannel, IncrementMode mode);
+
+            /**
+             * @brief Returns and clears all dirty state groups, this should be used to only translate the state that changed since the last draw
+             * @return The state groups which were written to since the last time they were consumed
+             */
+            DirtyStateGroups ConsumeDirtyGroups();
+
+            /**
+             * @brief Returns and clears the dirty flag of a single state group
+             * @return If the state group was written to since the last time it was consumed, this is always false for StateGroup::None
+             */
+            bool ConsumeDirtyGroup(StateGroup group);
         };
     }
 }
\ No newline at end of file
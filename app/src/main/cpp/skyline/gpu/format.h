@@ -4,10 +4,119 @@
 #pragma once
 
 #include "texture.h"
+#include "bcn.h"
+#include "astc.h"
 
 namespace skyline::gpu::format {
     using Format = gpu::texture::Format;
 
     constexpr Format RGBA8888Unorm{sizeof(u8) * 4, 1, 1, vk::Format::eR8G8B8A8Unorm}; //!< 8-bits per channel 4-channel pixels
     constexpr Format RGB565Unorm{sizeof(u8) * 2, 1, 1, vk::Format::eR5G6B5UnormPack16}; //!< Red channel: 5-bit, Green channel: 6-bit, Blue channel: 5-bit
+    constexpr Format BC1RGBAUnorm{sizeof(u64), 4, 4, vk::Format::eBc1RgbaUnormBlock, texture::bcn::DecodeBc1}; //!< 4x4 RGB blocks with 1-bit alpha
+    constexpr Format BC2Unorm{sizeof(u64) * 2, 4, 4, vk::Format::eBc2UnormBlock, texture::bcn::DecodeBc2}; //!< 4x4 RGB blocks with explicit 4-bit alpha
+    constexpr Format BC3Unorm{sizeof(u64) * 2, 4, 4, vk::Format::eBc3UnormBlock, texture::bcn::DecodeBc3}; //!< 4x4 RGB blocks with interpolated alpha
+    constexpr Format BC4Unorm{sizeof(u64), 4, 4, vk::Format::eBc4UnormBlock, texture::bcn::DecodeBc4}; //!< 4x4 single-channel blocks
+    constexpr Format BC5Unorm{sizeof(u64) * 2, 4, 4, vk::Format::eBc5UnormBlock, texture::bcn::DecodeBc5}; //!< 4x4 two-channel blocks
+    constexpr Format BC6HUfloat{sizeof(u64) * 2, 4, 4, vk::Format::eBc6HUfloatBlock, texture::bcn::DecodeBc6h}; //!< 4x4 unsigned HDR RGB blocks
+    constexpr Format BC7Unorm{sizeof(u64) * 2, 4, 4, vk::Format::eBc7UnormBlock, texture::bcn::DecodeBc7}; //!< 4x4 RGBA blocks with a mode per block
+    constexpr Format ASTC4x4Unorm{sizeof(u64) * 2, 4, 4, vk::Format::eAstc4x4UnormBlock, texture::astc::Decode<4, 4>}; //!< 4x4 ASTC blocks
+    constexpr Format ASTC5x4Unorm{sizeof(u64) * 2, 4, 5, vk::Format::eAstc5x4UnormBlock, texture::astc::Decode<5, 4>}; //!< 5x4 ASTC blocks
+    constexpr Format ASTC5x5Unorm{sizeof(u64) * 2, 5, 5, vk::Format::eAstc5x5UnormBlock, texture::astc::Decode<5, 5>}; //!< 5x5 ASTC blocks
+    constexpr Format ASTC6x5Unorm{sizeof(u64) * 2, 5, 6, vk::Format::eAstc6x5UnormBlock, texture::astc::Decode<6, 5>}; //!< 6x5 ASTC blocks
+    constexpr Format ASTC6x6Unorm{sizeof(u64) * 2, 6, 6, vk::Format::eAstc6x6UnormBlock, texture::astc::Decode<6, 6>}; //!< 6x6 ASTC blocks
+    constexpr Format ASTC8x5Unorm{sizeof(u64) * 2, 5, 8, vk::Format::eAstc8x5UnormBlock, texture::astc::Decode<8, 5>}; //!< 8x5 ASTC blocks
+    constexpr Format ASTC8x6Unorm{sizeof(u64) * 2, 6, 8, vk::Format::eAstc8x6UnormBlock, texture::astc::Decode<8, 6>}; //!< 8x6 ASTC blocks
+    constexpr Format ASTC8x8Unorm{sizeof(u64) * 2, 8, 8, vk::Format::eAstc8x8UnormBlock, texture::astc::Decode<8, 8>}; //!< 8x8 ASTC blocks
+    constexpr Format ASTC10x5Unorm{sizeof(u64) * 2, 5, 10, vk::Format::eAstc10x5UnormBlock, texture::astc::Decode<10, 5>}; //!< 10x5 ASTC blocks
+    constexpr Format ASTC10x6Unorm{sizeof(u64) * 2, 6, 10, vk::Format::eAstc10x6UnormBlock, texture::astc::Decode<10, 6>}; //!< 10x6 ASTC blocks
+    constexpr Format ASTC10x8Unorm{sizeof(u64) * 2, 8, 10, vk::Format::eAstc10x8UnormBlock, texture::astc::Decode<10, 8>}; //!< 10x8 ASTC blocks
+    constexpr Format ASTC10x10Unorm{sizeof(u64) * 2, 10, 10, vk::Format::eAstc10x10UnormBlock, texture::astc::Decode<10, 10>}; //!< 10x10 ASTC blocks
+    constexpr Format ASTC12x10Unorm{sizeof(u64) * 2, 10, 12, vk::Format::eAstc12x10UnormBlock, texture::astc::Decode<12, 10>}; //!< 12x10 ASTC blocks
+    constexpr Format ASTC12x12Unorm{sizeof(u64) * 2, 12, 12, vk::Format::eAstc12x12UnormBlock, texture::astc::Decode<12, 12>}; //!< 12x12 ASTC blocks
+
+    /**
+     * @brief The texture formats of the Maxwell texture header, these describe the layout of a texel or block of a guest texture
+     * @note Only the formats which have a corresponding Format are listed
+     */
+    enum class TextureFormat : u8 {
+        A8R8G8B8 = 0x08,
+        B5G6R5 = 0x15,
+        BC6HUfloat = 0x11,
+        BC7 = 0x17,
+        BC1 = 0x24,
+        BC2 = 0x25,
+        BC3 = 0x26,
+        BC4 = 0x27,
+        BC5 = 0x28,
+        ASTC4x4 = 0x40,
+        ASTC5x5 = 0x41,
+        ASTC6x6 = 0x42,
+        ASTC8x8 = 0x44,
+        ASTC10x10 = 0x45,
+        ASTC12x12 = 0x46,
+        ASTC5x4 = 0x50,
+        ASTC6x5 = 0x51,
+        ASTC8x6 = 0x52,
+        ASTC10x8 = 0x53,
+        ASTC12x10 = 0x54,
+        ASTC8x5 = 0x55,
+        ASTC10x5 = 0x56,
+        ASTC10x6 = 0x57,
+    };
+
+    /**
+     * @return The Format of guest textures in the supplied texture format, compressed formats have a decoder which is used when they're synchronized
+     */
+    constexpr Format GetFormat(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::A8R8G8B8:
+                return RGBA8888Unorm;
+            case TextureFormat::B5G6R5:
+                return RGB565Unorm;
+            case TextureFormat::BC1:
+                return BC1RGBAUnorm;
+            case TextureFormat::BC2:
+                return BC2Unorm;
+            case TextureFormat::BC3:
+                return BC3Unorm;
+            case TextureFormat::BC4:
+                return BC4Unorm;
+            case TextureFormat::BC5:
+                return BC5Unorm;
+            case TextureFormat::BC6HUfloat:
+                return BC6HUfloat;
+            case TextureFormat::BC7:
+                return BC7Unorm;
+            case TextureFormat::ASTC4x4:
+                return ASTC4x4Unorm;
+            case TextureFormat::ASTC5x4:
+                return ASTC5x4Unorm;
+            case TextureFormat::ASTC5x5:
+                return ASTC5x5Unorm;
+            case TextureFormat::ASTC6x5:
+                return ASTC6x5Unorm;
+            case TextureFormat::ASTC6x6:
+                return ASTC6x6Unorm;
+            case TextureFormat::ASTC8x5:
+                return ASTC8x5Unorm;
+            case TextureFormat::ASTC8x6:
+                return ASTC8x6Unorm;
+            case TextureFormat::ASTC8x8:
+                return ASTC8x8Unorm;
+            case TextureFormat::ASTC10x5:
+                return ASTC10x5Unorm;
+            case TextureFormat::ASTC10x6:
+                return ASTC10x6Unorm;
+            case TextureFormat::ASTC10x8:
+                return ASTC10x8Unorm;
+            case TextureFormat::ASTC10x10:
+                return ASTC10x10Unorm;
+            case TextureFormat::ASTC12x10:
+                return ASTC12x10Unorm;
+            case TextureFormat::ASTC12x12:
+                return ASTC12x12Unorm;
+            default:
+                throw exception("Unsupported guest texture format: 0x{:X}", static_cast<u8>(format));
+        }
+    }
 }
@@ -5,6 +5,9 @@
 #include <gpu/engines/maxwell_3d.h>
 #include "gpfifo.h"
 
+extern bool Halt;
+extern skyline::GroupMutex JniMtx;
+
 namespace skyline::gpu::gpfifo {
     void GPFIFO::Send(MethodParams params) {
         state.logger->Debug("Called GPU method - method: 0x{:X} argument: 0x{:X} subchannel: 0x{:X} last: {}", params.method, params.argument, params.subChannel, params.lastCall);
@@ -42,7 +45,27 @@ namespace skyline::gpu::gpfifo {
         }
     }
 
-    void GPFIFO::Process(const std::vector<u32> &segment) {
+    void GPFIFO::SendBatch(u16 method, std::span<const u32> arguments, u32 subChannel, IncrementMode mode) {
+        if (arguments.empty())
+            return;
+
+        // GPFIFO methods and engine binds are rare and a run of them can spill over into engine methods, so they're sent individually
+        if (method < constant::GpfifoRegisterCount) {
+            for (size_t index{}; index < arguments.size(); index++)
+                Send(MethodParams{GetBatchMethodAddress(method, index, mode), arguments[index], subChannel, index == arguments.size() - 1});
+            return;
+        }
+
+        state.logger->Debug("Called GPU method batch - method: 0x{:X} count: {} subchannel: 0x{:X}", method, arguments.size(), subChannel);
+
+        auto &engine = subchannels.at(subChannel);
+        if (engine == nullptr)
+            throw exception("Calling method on unbound channel");
+
+        engine->CallMethodBatch(method, arguments, subChannel, mode);
+    }
+
+    void GPFIFO::Process(std::span<const u32> segment) {
         for (auto entry = segment.begin(); entry != segment.end(); entry++) {
             // An entry containing all zeroes is a NOP, skip over it
             if (*entry == 0)
@@ -50,21 +73,23 @@ namespace skyline::gpu::gpfifo {
 
             auto methodHeader = reinterpret_cast<const PushBufferMethodHeader *>(&*entry);
 
+            auto SendArguments = [&](IncrementMode mode) {
+                if (methodHeader->methodCount > std::distance(entry, segment.end()) - 1)
+                    throw exception("Pushbuffer method 0x{:X} with {} arguments overflows the segment", methodHeader->methodAddress, methodHeader->methodCount);
+
+                SendBatch(methodHeader->methodAddress, std::span(entry + 1, methodHeader->methodCount), methodHeader->methodSubChannel, mode);
+                entry += methodHeader->methodCount;
+            };
+
             switch (methodHeader->secOp) {
                 case PushBufferMethodHeader::SecOp::IncMethod:
-                    for (u16 i{}; i < methodHeader->methodCount; i++)
-                        Send(MethodParams{static_cast<u16>(methodHeader->methodAddress + i), *++entry, methodHeader->methodSubChannel, i == methodHeader->methodCount - 1});
-
+                    SendArguments(IncrementMode::Increment);
                     break;
                 case PushBufferMethodHeader::SecOp::NonIncMethod:
-                    for (u16 i{}; i < methodHeader->methodCount; i++)
-                        Send(MethodParams{methodHeader->methodAddress, *++entry, methodHeader->methodSubChannel, i == methodHeader->methodCount - 1});
-
+                    SendArguments(IncrementMode::NonIncrement);
                     break;
                 case PushBufferMethodHeader::SecOp::OneInc:
-                    for (u16 i{}; i < methodHeader->methodCount; i++)
-                        Send(MethodParams{static_cast<u16>(methodHeader->methodAddress + bool(i)), *++entry, methodHeader->methodSubChannel, i == methodHeader->methodCount - 1});
-
+                    SendArguments(IncrementMode::IncrementOnce);
                     break;
                 case PushBufferMethodHeader::SecOp::ImmdDataMethod:
                     Send(MethodParams{methodHeader->methodAddress, methodHeader->immdData, methodHeader->methodSubChannel, true});
@@ -78,26 +103,45 @@ namespace skyline::gpu::gpfifo {
     }
 
     void GPFIFO::Run() {
-        std::lock_guard lock(pushBufferQueueLock);
-        while (!pushBufferQueue.empty()) {
-            auto pushBuffer = pushBufferQueue.front();
-            if (pushBuffer.segment.empty())
-                pushBuffer.Fetch(state.gpu->memoryManager);
-
-            Process(pushBuffer.segment);
-            pushBufferQueue.pop();
+        try {
+            GpEntry gpEntry;
+            while (gpEntryQueue.Pop(gpEntry, [this]() { return exit.load(std::memory_order_relaxed); })) {
+                PushBuffer pushBuffer(gpEntry, state.gpu->memoryManager);
+                Process(pushBuffer.segment);
+            }
+        } catch (const std::exception &e) {
+            state.logger->Error(e.what());
+            JniMtx.lock(GroupMutex::Group::Group2);
+            Halt = true;
+            JniMtx.unlock();
+        } catch (...) {
+            state.logger->Error("An unknown exception has occurred in the GPFIFO thread");
+            JniMtx.lock(GroupMutex::Group::Group2);
+            Halt = true;
+            JniMtx.unlock();
         }
     }
 
-    void GPFIFO::Push(std::span<GpEntry> entries) {
-        std::lock_guard lock(pushBufferQueueLock);
-        bool beforeBarrier{false};
+    void GPFIFO::Initialize() {
+        thread = std::thread(&GPFIFO::Run, this);
+    }
 
-        for (const auto &entry : entries) {
-            if (entry.sync == GpEntry::Sync::Wait)
-                beforeBarrier = false;
+    GPFIFO::~GPFIFO() {
+        exit = true;
+        gpEntryQueue.Notify();
 
-            pushBufferQueue.emplace(PushBuffer(entry, state.gpu->memoryManager, beforeBarrier));
+        if (thread.joinable())
+            thread.join();
+    }
+
+    void GPFIFO::Push(std::span<GpEntry> entries) {
+        for (const auto &entry : entries) {
+            // The queue being full only happens when the GPFIFO thread is far behind the guest, we yield to it rather than dropping any entries
+            while (!gpEntryQueue.TryPush(entry)) {
+                if (Halt)
+                    return;
+                std::this_thread::yield();
+            }
         }
     }
 }
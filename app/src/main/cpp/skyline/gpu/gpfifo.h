@@ -4,13 +4,17 @@
 #pragma once
 
 #include <common.h>
-#include <queue>
+#include <mpsc_queue.h>
 #include "engines/engine.h"
 #include "engines/gpfifo.h"
 #include "memory_manager.h"
 
-namespace skyline::gpu {
-    namespace gpfifo {
+namespace skyline {
+    namespace constant {
+        constexpr size_t GpEntryQueueSize = 0x4000; //!< The amount of GP entries that can be queued for the GPFIFO thread
+    }
+
+    namespace gpu::gpfifo {
         /**
          * @brief This contains a single GPFIFO entry that is submitted through 'SubmitGpfifo'
          * @url https://nvidia.github.io/open-gpu-doc/manuals/volta/gv100/dev_pbdma.ref.txt
@@ -133,45 +137,87 @@ namespace skyline::gpu {
              */
             struct PushBuffer {
                 GpEntry gpEntry;
-                std::vector<u32> segment;
+                std::vector<u32> segmentBuffer; //!< A buffer which holds a copy of the segment when it isn't contiguous in host memory
+                std::span<const u32> segment; //!< A span over the words in the segment, this points directly into guest memory when possible
 
-                PushBuffer(const GpEntry &gpEntry, const vmm::MemoryManager &memoryManager, bool fetch) : gpEntry(gpEntry) {
-                    if (fetch)
-                        Fetch(memoryManager);
+                PushBuffer(const GpEntry &gpEntry, const vmm::MemoryManager &memoryManager) : gpEntry(gpEntry) {
+                    Fetch(memoryManager);
                 }
 
+                /**
+                 * @note Pushbuffers are only read once, so the segment is only copied when it spans discontiguous host memory
+                 */
                 inline void Fetch(const vmm::MemoryManager &memoryManager) {
-                    segment.resize(gpEntry.size);
-                    memoryManager.Read<u32>(segment, (static_cast<u64>(gpEntry.getHi) << 32) | (static_cast<u64>(gpEntry.get) << 2));
+                    auto address = (static_cast<u64>(gpEntry.getHi) << 32) | (static_cast<u64>(gpEntry.get) << 2);
+
+                    auto hostSpans = memoryManager.GetHostSpans(address, gpEntry.size * sizeof(u32));
+                    if (hostSpans.size() == 1) {
+                        segment = std::span(reinterpret_cast<const u32 *>(hostSpans.front().data()), gpEntry.size);
+                        return;
+                    }
+
+                    segmentBuffer.resize(gpEntry.size);
+                    if (hostSpans.empty()) {
+                        memoryManager.Read<u32>(segmentBuffer, address); // The segment isn't backed by host memory, this throws if it isn't mapped either
+                    } else {
+                        // The spans are gathered directly rather than using Read which would translate the segment again
+                        auto destination = reinterpret_cast<u8 *>(segmentBuffer.data());
+                        for (auto hostSpan : hostSpans) {
+                            std::memcpy(destination, hostSpan.data(), hostSpan.size());
+                            destination += hostSpan.size();
+                        }
+                    }
+                    segment = segmentBuffer;
                 }
             };
 
             const DeviceState &state;
             engine::GPFIFO gpfifoEngine; //!< The engine for processing GPFIFO method calls
             std::array<std::shared_ptr<engine::Engine>, 8> subchannels;
-            std::queue<PushBuffer> pushBufferQueue;
-            skyline::Mutex pushBufferQueueLock; //!< This is used to lock pushbuffer queue insertions as the GPU runs on a seperate thread
+            MpscQueue<GpEntry, constant::GpEntryQueueSize> gpEntryQueue; //!< A lock-free queue of GP entries which are pushed by the guest and consumed by the GPFIFO thread
+            std::thread thread; //!< The thread that processes all GP entries
+            std::atomic<bool> exit{false}; //!< If the GPFIFO thread should exit
 
             /**
              * @brief Processes a pushbuffer segment, calling methods as needed
              */
-            void Process(const std::vector<u32> &segment);
+            void Process(std::span<const u32> segment);
 
             /**
              * @brief This sends a method call to the GPU hardware
              */
             void Send(MethodParams params);
 
+            /**
+             * @brief This sends a batch of method calls with consecutive arguments to the GPU hardware
+             * @param method The method address of the first argument
+             * @param arguments The arguments of all method calls in the batch
+             * @param subChannel The subchannel the methods are called on
+             * @param mode The way the method address changes over the batch
+             */
+            void SendBatch(u16 method, std::span<const u32> arguments, u32 subChannel, IncrementMode mode);
+
+            /**
+             * @brief The entry point of the GPFIFO thread, this processes GP entries as they're pushed and sleeps when there are none
+             */
+            void Run();
+
           public:
             GPFIFO(const DeviceState &state) : state(state), gpfifoEngine(state) {}
 
             /**
-             * @brief Executes all pending entries in the FIFO
+             * @brief This stops and joins the GPFIFO thread
              */
-            void Run();
+            ~GPFIFO();
+
+            /**
+             * @brief This starts the GPFIFO thread, it can only be called after the GPU has been constructed as the thread accesses it
+             */
+            void Initialize();
 
             /**
-             * @brief Pushes a list of entries to the FIFO, these commands will be executed on calls to 'Step'
+             * @brief Pushes a list of entries to the FIFO, these commands will be executed asynchronously by the GPFIFO thread
+             * @note This never waits on the processing of pushbuffers, it only yields when the queue is completely full
              */
             void Push(std::span<GpEntry> entries);
         };
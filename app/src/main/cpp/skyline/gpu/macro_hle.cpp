@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "engines/maxwell_3d.h"
+#include "macro_hle.h"
+
+namespace skyline::gpu {
+    namespace {
+        constexpr u32 MethodOperandMask{0x3FFF}; //!< The mask of an opcode with its 18-bit immediate operand cleared
+
+        /**
+         * @brief This holds the method address and increment that a macro sets with an immediate
+         */
+        struct MethodImmediate {
+            u16 address;
+            u8 increment;
+
+            MethodImmediate(u32 opcode) : address(static_cast<u16>((opcode >> 14) & 0xFFF)), increment(static_cast<u8>((opcode >> 26) & 0x3F)) {}
+        };
+
+        /**
+         * @brief Sends arguments to consecutive methods exactly as a macro does with MoveAndSend, runs of plain registers are written in a single batch
+         */
+        void SendRun(engine::Maxwell3D &maxwell3D, MethodImmediate method, std::span<const u32> arguments) {
+            if ((method.increment == 0 || method.increment == 1) && method.address + (arguments.size() - 1) * method.increment < constant::Maxwell3DRegisterCounter) {
+                maxwell3D.CallMethodBatch(method.address, arguments, 0, method.increment ? IncrementMode::Increment : IncrementMode::NonIncrement);
+                return;
+            }
+
+            // Macro sends are always the last call so macro methods would be executed on every send, these have to be replicated one at a time
+            for (auto argument : arguments) {
+                maxwell3D.CallMethod(MethodParams{method.address, argument, 0, true});
+                method.address = (method.address + method.increment) & 0xFFF;
+            }
+        }
+
+        /**
+         * @brief The high-level implementations of macros, any addition must be verified against the interpreter in the host tests
+         */
+        const std::array<MacroHle::Implementation, 2> Implementations{{
+            {
+                /*
+                 * Writes the first argument to a single method:
+                 * 0: r0 = 0 + <method>, set method
+                 * 1: r0 = r1 + 0, send, exit
+                 * 2: nop (delay slot)
+                 */
+                .name = "WriteRegister",
+                .entry = 0,
+                .code = {0x00000021, 0x000008C1, 0x00000011},
+                .mask = {MethodOperandMask, 0xFFFFFFFF, 0xFFFFFFFF},
+                .function = [](engine::Maxwell3D &maxwell3D, const std::vector<u32> &code, const std::vector<u32> &args) {
+                    if (args.empty())
+                        return false;
+
+                    MethodImmediate method(code[0]);
+                    maxwell3D.CallMethod(MethodParams{method.address, args[0], 0, true});
+                    return true;
+                },
+            },
+            {
+                /*
+                 * Writes a counted run of arguments to consecutive methods, the first argument is the count:
+                 * 0: r0 = 0 + <method>, set method
+                 * 1: r1 = r1 - 1
+                 * 2: r2 = fetch
+                 * 3: branch to 1 if r1 != 0
+                 * 4: r0 = r2 + 0, send (delay slot)
+                 * 5: nop, exit
+                 * 6: nop (delay slot)
+                 */
+                .name = "WriteRegisters",
+                .entry = 0,
+                .code = {0x00000021, 0xFFFFC911, 0x00000201, 0xFFFF8817, 0x00001041, 0x00000091, 0x00000011},
+                .mask = {MethodOperandMask, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+                .function = [](engine::Maxwell3D &maxwell3D, const std::vector<u32> &code, const std::vector<u32> &args) {
+                    // A count of zero underflows and loops past the arguments, that's left to the interpreter
+                    if (args.empty() || args[0] == 0 || args.size() - 1 < args[0])
+                        return false;
+
+                    SendRun(maxwell3D, MethodImmediate(code[0]), std::span(args).subspan(1, args[0]));
+                    return true;
+                },
+            },
+        }};
+    }
+
+    bool MacroHle::Implementation::Matches(size_t macroEntry, const std::vector<u32> &macroCode) const {
+        if (macroEntry != entry || macroCode.size() != code.size())
+            return false;
+
+        for (size_t index{}; index < code.size(); index++)
+            if ((macroCode[index] & mask[index]) != code[index])
+                return false;
+
+        return true;
+    }
+
+    size_t MacroHle::MacroKeyHash::operator()(const MacroKey &key) const {
+        // FNV-1a over the words of the code, the entry is mixed in as the first word
+        u64 hash{0xCBF29CE484222325};
+        auto Mix = [&hash](u64 value) {
+            hash ^= value;
+            hash *= 0x100000001B3;
+        };
+
+        Mix(key.entry);
+        for (auto word : key.code)
+            Mix(word);
+
+        return static_cast<size_t>(hash);
+    }
+
+    MacroHle::MacroHle(const DeviceState &state) : state(state), enabled(state.settings->GetBool("macro_hle")) {}
+
+    MacroHle::Entry &MacroHle::GetEntry(size_t entry, const std::vector<u32> &code) {
+        auto [iterator, inserted] = entries.try_emplace(MacroKey{entry, code});
+        if (inserted && enabled) {
+            for (const auto &implementation : Implementations) {
+                if (implementation.Matches(entry, code)) {
+                    iterator->second.implementation = &implementation;
+                    state.logger->Debug("Macro with {} opcodes will be replaced by the high-level implementation {}", code.size(), implementation.name);
+                    break;
+                }
+            }
+        }
+        return iterator->second;
+    }
+
+    void MacroHle::Dump() {
+        constexpr size_t MaxDumpedMacros{10}; //!< The amount of the most executed macros which are written to the log
+
+        std::vector<std::pair<const MacroKey *, const Entry *>> sortedEntries;
+        u64 executions{}, hits{};
+        for (const auto &[key, entry] : entries) {
+            executions += entry.executions;
+            hits += entry.hits;
+            sortedEntries.emplace_back(&key, &entry);
+        }
+
+        if (!executions)
+            return;
+
+        state.logger->Info("Macro HLE: {} of {} macro executions were handled by high-level implementations ({}%)", hits, executions, (hits * 100) / executions);
+
+        auto dumpedCount{std::min(sortedEntries.size(), MaxDumpedMacros)};
+        std::partial_sort(sortedEntries.begin(), sortedEntries.begin() + static_cast<ssize_t>(dumpedCount), sortedEntries.end(), [](const auto &a, const auto &b) {
+            return a.second->executions > b.second->executions;
+        });
+        for (size_t index{}; index < dumpedCount; index++) {
+            const auto &[key, entry] = sortedEntries[index];
+            state.logger->Info("Macro 0x{:016X} ({} opcodes): {} executions, {} handled by {}", MacroKeyHash{}(*key), key->code.size(), entry->executions, entry->hits, entry->implementation ? entry->implementation->name : "nothing");
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <unordered_map>
+#include <common.h>
+
+namespace skyline::gpu {
+    namespace engine {
+        class Maxwell3D;
+    }
+
+    /**
+     * @brief The MacroHle class holds high-level implementations of macros which replace executing them, it also tracks how often every macro is executed and how many of those executions were handled by a high-level implementation
+     * @details Titles upload the same macros at different positions in macro memory, so macros are identified by their code and entry point, these are compared in full rather than by a hash so two different macros can never be confused
+     * @note This must only be used from the thread that executes macros
+     */
+    class MacroHle {
+      public:
+        /**
+         * @brief A high-level implementation of a macro, this must have the same effect on the Maxwell 3D as executing the macro with the same arguments
+         * @param code The code of the macro that's being replaced, the operands which were masked out while matching it can be read from this
+         * @return If the macro was handled, the macro is executed by an interpreter if this is false
+         */
+        using Function = bool (*)(engine::Maxwell3D &maxwell3D, const std::vector<u32> &code, const std::vector<u32> &args);
+
+        /**
+         * @brief This describes the code of the macros that a high-level implementation can replace
+         */
+        struct Implementation {
+            std::string_view name;
+            size_t entry; //!< The index of the entry point in the code
+            std::vector<u32> code; //!< The code of the macro with every bit outside of the mask cleared
+            std::vector<u32> mask; //!< The bits of every opcode which have to match the code, the other bits hold operands such as method addresses which are read by the function
+            Function function;
+
+            /**
+             * @return If this implementation can replace the macro with the supplied code and entry point
+             */
+            bool Matches(size_t macroEntry, const std::vector<u32> &macroCode) const;
+        };
+
+        /**
+         * @brief This holds the implementation and statistics of a single distinct macro
+         */
+        struct Entry {
+            const Implementation *implementation{}; //!< The high-level implementation of the macro, this is null if the macro isn't recognized
+            u64 executions{}; //!< The amount of times the macro was executed
+            u64 hits{}; //!< The amount of executions that were handled by the high-level implementation
+        };
+
+      private:
+        /**
+         * @brief This identifies a macro by its code and entry point
+         */
+        struct MacroKey {
+            size_t entry;
+            std::vector<u32> code;
+
+            bool operator==(const MacroKey &) const = default;
+        };
+
+        struct MacroKeyHash {
+            size_t operator()(const MacroKey &key) const;
+        };
+
+        const DeviceState &state;
+        bool enabled; //!< If high-level implementations should be used, executions are still tracked if this is false
+        std::unordered_map<MacroKey, Entry, MacroKeyHash> entries; //!< The entries of every macro that has been executed, references to them stay valid till this object is destroyed
+
+      public:
+        MacroHle(const DeviceState &state);
+
+        /**
+         * @return The entry of the macro with the supplied code and entry point, a high-level implementation is looked up the first time a macro is seen
+         */
+        Entry &GetEntry(size_t entry, const std::vector<u32> &code);
+
+        /**
+         * @brief Executes a macro with its high-level implementation if it has one and records the execution
+         * @return If the macro was handled, it needs to be executed by an interpreter if this is false
+         */
+        static bool Execute(Entry &entry, engine::Maxwell3D &maxwell3D, const std::vector<u32> &code, const std::vector<u32> &args) {
+            entry.executions++;
+            if (entry.implementation && entry.implementation->function(maxwell3D, code, args)) {
+                entry.hits++;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief This writes the hit rate of the high-level implementations and the execution counts of the most executed macros to the log
+         */
+        void Dump();
+    };
+}
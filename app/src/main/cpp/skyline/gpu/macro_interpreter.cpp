@@ -7,12 +7,72 @@
 #include "macro_interpreter.h"
 
 namespace skyline::gpu {
+    MacroInterpreter::DecodedOpcode::DecodedOpcode(Opcode opcode)
+        : operation(opcode.operation), assignmentOperation(opcode.assignmentOperation), aluOperation(opcode.aluOperation), branchCondition(opcode.branchCondition), noDelay(opcode.noDelay), exit(opcode.exit), dest(opcode.dest), srcA(opcode.srcA), srcB(opcode.srcB), srcBit(opcode.bitfield.srcBit), destBit(opcode.bitfield.destBit), mask(opcode.bitfield.GetMask()), immediate(opcode.immediate) {}
+
+    std::shared_ptr<const MacroInterpreter::DecodedMacro> MacroInterpreter::GetMacro(size_t offset) {
+        auto cached = macroCache.find(offset);
+        if (cached != macroCache.end())
+            return cached->second;
+
+        const auto &code = maxwell3D.macroCode;
+        size_t begin{offset}, end{offset + 1};
+        std::vector<bool> visited(code.size());
+        std::vector<size_t> pending{offset};
+
+        while (!pending.empty()) {
+            auto position = pending.back();
+            pending.pop_back();
+
+            for (; position < code.size() && !visited[position]; position++) {
+                visited[position] = true;
+                begin = std::min(begin, position);
+                end = std::max(end, position + 1);
+
+                Opcode opcode{.raw = code[position]};
+                if (opcode.operation == Opcode::Operation::Branch) {
+                    auto target = static_cast<i64>(position) + opcode.immediate;
+                    if (target >= 0 && target < static_cast<i64>(code.size()))
+                        pending.push_back(static_cast<size_t>(target));
+                }
+
+                if (opcode.exit) {
+                    end = std::max(end, std::min(position + 2, code.size())); // Exit has a delay slot
+                    break;
+                }
+            }
+        }
+
+        auto macro{std::make_shared<DecodedMacro>(DecodedMacro{begin, offset - begin, std::vector<u32>(code.begin() + begin, code.begin() + end)})};
+        macro->opcodes.reserve(end - begin);
+        for (auto position{begin}; position < end; position++)
+            macro->opcodes.emplace_back(Opcode{.raw = code[position]});
+
+        return macroCache.emplace(offset, std::move(macro)).first->second;
+    }
+
+    void MacroInterpreter::InvalidateCode(size_t offset, size_t size) {
+        for (auto macro = macroCache.begin(); macro != macroCache.end();) {
+            if (macro->second->offset < offset + size && offset < macro->second->offset + macro->second->opcodes.size())
+                macro = macroCache.erase(macro);
+            else
+                macro++;
+        }
+    }
+
     void MacroInterpreter::Execute(size_t offset, const std::vector<u32> &args) {
+        auto macro{GetMacro(offset)}; // This is retained till the macro returns as it could write to its own code
+        Execute(*macro, args);
+    }
+
+    void MacroInterpreter::Execute(const DecodedMacro &macro, const std::vector<u32> &args) {
         // Reset the interpreter state
         registers = {};
         carryFlag = false;
         methodAddress.raw = 0;
-        opcode = reinterpret_cast<Opcode *>(&maxwell3D.macroCode[offset]);
+        opcodesBegin = macro.opcodes.data();
+        opcodesEnd = opcodesBegin + macro.opcodes.size();
+        opcode = opcodesBegin + macro.entry;
         argument = args.data();
 
         // The first argument is stored in register 1
@@ -21,7 +81,10 @@ namespace skyline::gpu {
         while (Step());
     }
 
-    FORCE_INLINE bool MacroInterpreter::Step(Opcode *delayedOpcode) {
+    FORCE_INLINE bool MacroInterpreter::Step(const DecodedOpcode *delayedOpcode) {
+        if (__predict_false(opcode >= opcodesEnd))
+            throw exception("Macro execution ran past the end of the macro");
+
         switch (opcode->operation) {
             case Opcode::Operation::AluRegister: {
                 u32 result = HandleAlu(opcode->aluOperation, registers[opcode->srcA], registers[opcode->srcB]);
@@ -37,13 +100,13 @@ namespace skyline::gpu {
                 u32 dest = registers[opcode->srcA];
 
                 // Extract the source region
-                src = (src >> opcode->bitfield.srcBit) & opcode->bitfield.GetMask();
+                src = (src >> opcode->srcBit) & opcode->mask;
 
                 // Mask out the bits that we will replace
-                dest &= ~(opcode->bitfield.GetMask() << opcode->bitfield.destBit);
+                dest &= ~(opcode->mask << opcode->destBit);
 
                 // Replace the bitfield region in the destination with the region from the source
-                dest |= src << opcode->bitfield.destBit;
+                dest |= src << opcode->destBit;
 
                 HandleAssignment(opcode->assignmentOperation, opcode->dest, dest);
                 break;
@@ -52,7 +115,7 @@ namespace skyline::gpu {
                 u32 src = registers[opcode->srcB];
                 u32 dest = registers[opcode->srcA];
 
-                u32 result = ((src >> dest) & opcode->bitfield.GetMask()) << opcode->bitfield.destBit;
+                u32 result = ((src >> dest) & opcode->mask) << opcode->destBit;
 
                 HandleAssignment(opcode->assignmentOperation, opcode->dest, result);
                 break;
@@ -61,7 +124,7 @@ namespace skyline::gpu {
                 u32 src = registers[opcode->srcB];
                 u32 dest = registers[opcode->srcA];
 
-                u32 result = ((src >> opcode->bitfield.srcBit) & opcode->bitfield.GetMask()) << dest;
+                u32 result = ((src >> opcode->srcBit) & opcode->mask) << dest;
 
                 HandleAssignment(opcode->assignmentOperation, opcode->dest, result);
                 break;
@@ -79,11 +142,14 @@ namespace skyline::gpu {
                 bool branch = (opcode->branchCondition == Opcode::BranchCondition::Zero) ? (value == 0) : (value != 0);
 
                 if (branch) {
+                    if (opcode + opcode->immediate < opcodesBegin || opcode + opcode->immediate >= opcodesEnd)
+                        throw exception("Macro branch target is outside of macro memory");
+
                     if (opcode->noDelay) {
                         opcode += opcode->immediate;
                         return true;
                     } else {
-                        Opcode *targetOpcode = opcode + opcode->immediate;
+                        const DecodedOpcode *targetOpcode = opcode + opcode->immediate;
 
                         // Step into delay slot
                         opcode++;
@@ -186,7 +252,7 @@ namespace skyline::gpu {
     }
 
     FORCE_INLINE void MacroInterpreter::Send(u32 argument) {
-        maxwell3D.CallMethod(MethodParams{methodAddress.address, argument, 0, true});
+        maxwell3D.CallMethod(MethodParams{static_cast<u16>(methodAddress.address), argument, 0, true});
 
         methodAddress.address += methodAddress.increment;
     }
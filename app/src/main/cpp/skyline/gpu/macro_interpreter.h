@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <common.h>
 
 namespace skyline::gpu {
@@ -10,11 +11,15 @@ namespace skyline::gpu {
         class Maxwell3D;
     }
 
+    class MacroThreadedInterpreter;
+
     /**
      * @brief The MacroInterpreter class handles interpreting macros. Macros are small programs that run on the GPU and are used for things like instanced rendering.
      */
     class MacroInterpreter {
       private:
+        friend MacroThreadedInterpreter;
+
         /**
          * @brief This holds a single macro opcode
          */
@@ -97,6 +102,37 @@ namespace skyline::gpu {
 #pragma pack(pop)
         static_assert(sizeof(Opcode) == sizeof(u32));
 
+        /**
+         * @brief This holds a single macro opcode with all of its fields extracted ahead of time, this avoids decoding the packed bitfields on every execution
+         */
+        struct DecodedOpcode {
+            Opcode::Operation operation;
+            Opcode::AssignmentOperation assignmentOperation;
+            Opcode::AluOperation aluOperation;
+            Opcode::BranchCondition branchCondition;
+            bool noDelay;
+            bool exit;
+            u8 dest;
+            u8 srcA;
+            u8 srcB;
+            u8 srcBit; //!< The bit to extract the bitfield from
+            u8 destBit; //!< The bit to insert the bitfield at
+            u32 mask; //!< The mask of the bitfield
+            i32 immediate;
+
+            DecodedOpcode(Opcode opcode);
+        };
+
+        /**
+         * @brief This holds a macro program that was decoded from macro memory
+         */
+        struct DecodedMacro {
+            size_t offset; //!< The offset of the first decoded opcode in macro memory, this can be lower than the entry point if the macro branches backwards
+            size_t entry; //!< The index of the entry point in the decoded opcodes
+            std::vector<u32> code; //!< The raw code of the macro, this is compared to check if two macros are identical
+            std::vector<DecodedOpcode> opcodes;
+        };
+
         /**
          * @brief This holds information about the Maxwell 3D method to be called in 'Send'
          */
@@ -104,25 +140,43 @@ namespace skyline::gpu {
             u32 raw;
 
             struct {
-                u16 address : 12;
-                u8 increment : 6;
+                u32 address : 12;
+                u32 increment : 6; //!< This is at bits 12-17, it would be moved to bit 16 if it were a u8 as it can't straddle a byte
             };
         };
 
         engine::Maxwell3D &maxwell3D;
 
+        std::unordered_map<size_t, std::shared_ptr<const DecodedMacro>> macroCache; //!< A cache of decoded macros keyed by the offset of their entry point in macro memory, these are shared with any execution of them so invalidating a macro while it's executing doesn't free it
+
         std::array<u32, 8> registers{};
 
-        Opcode *opcode{};
+        const DecodedOpcode *opcode{};
+        const DecodedOpcode *opcodesBegin{}; //!< The first opcode of the macro being executed
+        const DecodedOpcode *opcodesEnd{}; //!< The end of the opcodes of the macro being executed
         const u32 *argument{};
         MethodAddress methodAddress{};
         bool carryFlag{};
 
+        /**
+         * @brief Retrieves a decoded macro from the cache or decodes it from macro memory
+         * @param offset The offset of the entry point of the macro in macro memory
+         * @details The extent of a macro isn't stored anywhere, so every path from the entry point is followed till an exit and its delay slot
+         * @note The returned reference must be held for as long as the macro is executing as it can be invalidated by the methods it calls
+         */
+        std::shared_ptr<const DecodedMacro> GetMacro(size_t offset);
+
+        /**
+         * @brief Executes a decoded macro with the given arguments
+         * @note The caller must hold a reference to the macro for the duration of the call
+         */
+        void Execute(const DecodedMacro &macro, const std::vector<u32> &args);
+
         /**
          * @brief Steps forward one macro instruction, including delay slots
          * @param delayedOpcode The target opcode to be jumped to after executing the instruction
          */
-        bool Step(Opcode *delayedOpcode = nullptr);
+        bool Step(const DecodedOpcode *delayedOpcode = nullptr);
 
         /**
          * @brief Performs an ALU operation on the given source values and returns the result as a u32
@@ -148,5 +202,12 @@ namespace skyline::gpu {
          * @brief Executes a GPU macro from macro memory with the given arguments
          */
         void Execute(size_t offset, const std::vector<u32> &args);
+
+        /**
+         * @brief Invalidates all decoded macros which overlap with a region of macro memory, this must be called whenever macro memory is written to
+         * @param offset The offset of the region in macro memory
+         * @param size The size of the region in words
+         */
+        void InvalidateCode(size_t offset, size_t size);
     };
 }
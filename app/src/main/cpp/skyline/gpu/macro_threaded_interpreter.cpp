@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "engines/maxwell_3d.h"
+#include "macro_threaded_interpreter.h"
+
+namespace skyline::gpu {
+    MacroThreadedInterpreter::MacroThreadedInterpreter(const DeviceState &state, engine::Maxwell3D &maxwell3D, MacroInterpreter &interpreter, MacroHle &hle) : state(state), maxwell3D(maxwell3D), interpreter(interpreter), hle(hle), enabled(state.settings->GetBool("macro_threaded_interpreter")) {}
+
+    void MacroThreadedInterpreter::Execute(size_t offset, const std::vector<u32> &args) {
+        auto macro{interpreter.GetMacro(offset)}; // This is retained till the macro returns as it could write to its own code
+
+        auto &cached{translatedMacros[offset]};
+        if (!cached || (cached->source != macro && (cached->source->code != macro->code || cached->source->entry != macro->entry))) {
+            cached = Translate(macro);
+            if (cached->entry)
+                state.logger->Debug("Translated macro at 0x{:X} into {} instructions", offset, cached->instructions.size());
+            else if (enabled)
+                state.logger->Warn("Couldn't translate macro at 0x{:X}, it will be interpreted", offset);
+        } else {
+            cached->source = macro; // The macro was decoded again without its code changing so the translation is still valid
+        }
+
+        // The translation is retained till the macro returns as it could write to its own code or call into another macro which could rehash the cache
+        auto translated{cached};
+        if (MacroHle::Execute(*translated->hle, maxwell3D, macro->code, args))
+            return;
+
+        if (!translated->entry) {
+            interpreter.Execute(*macro, args);
+            return;
+        }
+
+        Context context(maxwell3D);
+        context.argument = args.data();
+
+        // The first argument is stored in register 1
+        context.registers[1] = *context.argument++;
+
+        for (auto instruction{translated->entry}; instruction;)
+            instruction = instruction->handler(context, *instruction);
+    }
+
+    void MacroThreadedInterpreter::InvalidateCode(size_t offset, size_t size) {
+        interpreter.InvalidateCode(offset, size);
+
+        for (auto macro = translatedMacros.begin(); macro != translatedMacros.end();) {
+            const auto &source{*macro->second->source};
+            if (source.offset < offset + size && offset < source.offset + source.code.size())
+                macro = translatedMacros.erase(macro);
+            else
+                macro++;
+        }
+    }
+
+    std::shared_ptr<MacroThreadedInterpreter::ThreadedMacro> MacroThreadedInterpreter::Translate(const std::shared_ptr<const DecodedMacro> &macro) {
+        const auto &opcodes = macro->opcodes;
+        auto count{opcodes.size()};
+
+        // Links between instructions are recorded as indices while translating as the instructions can move, they're resolved into pointers at the end
+        constexpr size_t Exit{std::numeric_limits<size_t>::max()};
+        struct Links {
+            size_t next{Exit};
+            size_t target{Exit};
+        };
+
+        auto translated = std::make_shared<ThreadedMacro>();
+        translated->source = macro;
+        translated->hle = &hle.GetEntry(macro->entry, macro->code);
+        if (!enabled)
+            return translated;
+
+        auto &instructions = translated->instructions;
+        std::vector<Links> links(count);
+        instructions.reserve(count * 2);
+
+        for (const auto &opcode : opcodes) {
+            auto handler = GetHandler(opcode);
+            if (!handler) {
+                instructions.clear();
+                return translated;
+            }
+
+            instructions.push_back(Instruction{
+                .handler = handler,
+                .immediate = opcode.immediate,
+                .mask = opcode.mask,
+                .dest = opcode.dest ? opcode.dest : ScratchRegister,
+                .srcA = opcode.srcA,
+                .srcB = opcode.srcB,
+                .srcBit = opcode.srcBit,
+                .destBit = opcode.destBit,
+            });
+        }
+
+        auto Emit = [&](Instruction instruction, size_t next) -> size_t {
+            instructions.push_back(instruction);
+            links.push_back(Links{next});
+            return instructions.size() - 1;
+        };
+
+        size_t pastEnd{Emit(Instruction{.handler = &PastEnd}, Exit)};
+        size_t outOfBounds{Emit(Instruction{.handler = &BranchOutOfBounds}, Exit)};
+
+        // Delay slots are emitted as copies of the instruction that link to the instruction following the delay slot, the exit flag is ignored inside them
+        auto DelaySlot = [&](size_t index, size_t next) -> size_t {
+            if (index >= count)
+                return pastEnd;
+
+            auto instruction{instructions[index]};
+            if (opcodes[index].operation == Opcode::Operation::Branch)
+                instruction.handler = &BranchInDelaySlot;
+
+            return Emit(instruction, next);
+        };
+
+        for (size_t index{}; index < count; index++) {
+            const auto &opcode{opcodes[index]};
+
+            if (opcode.exit)
+                links[index].next = DelaySlot(index + 1, Exit);
+            else
+                links[index].next = (index + 1 < count) ? index + 1 : pastEnd;
+
+            if (opcode.operation == Opcode::Operation::Branch) {
+                auto target{static_cast<i64>(index) + opcode.immediate};
+                if (target < 0 || target >= static_cast<i64>(count))
+                    links[index].target = outOfBounds;
+                else if (opcode.noDelay)
+                    links[index].target = static_cast<size_t>(target);
+                else
+                    links[index].target = DelaySlot(index + 1, static_cast<size_t>(target));
+            }
+        }
+
+        for (size_t index{}; index < instructions.size(); index++) {
+            instructions[index].next = (links[index].next != Exit) ? &instructions[links[index].next] : nullptr;
+            instructions[index].target = (links[index].target != Exit) ? &instructions[links[index].target] : nullptr;
+        }
+
+        translated->entry = &instructions[macro->entry];
+        return translated;
+    }
+
+    MacroThreadedInterpreter::Handler MacroThreadedInterpreter::GetHandler(const DecodedOpcode &opcode) {
+        switch (opcode.operation) {
+            case Opcode::Operation::AluRegister:
+                switch (opcode.aluOperation) {
+                    case Opcode::AluOperation::Add:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::Add>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::AddWithCarry:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::AddWithCarry>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::Subtract:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::Subtract>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::SubtractWithBorrow:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::SubtractWithBorrow>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::BitwiseXor:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::BitwiseXor>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::BitwiseOr:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::BitwiseOr>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::BitwiseAnd:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::BitwiseAnd>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::BitwiseAndNot:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::BitwiseAndNot>(opcode.assignmentOperation);
+                    case Opcode::AluOperation::BitwiseNand:
+                        return GetAssignmentHandler<Opcode::Operation::AluRegister, Opcode::AluOperation::BitwiseNand>(opcode.assignmentOperation);
+                    default:
+                        return nullptr;
+                }
+            case Opcode::Operation::AddImmediate:
+                return GetAssignmentHandler<Opcode::Operation::AddImmediate>(opcode.assignmentOperation);
+            case Opcode::Operation::BitfieldReplace:
+                return GetAssignmentHandler<Opcode::Operation::BitfieldReplace>(opcode.assignmentOperation);
+            case Opcode::Operation::BitfieldExtractShiftLeftImmediate:
+                return GetAssignmentHandler<Opcode::Operation::BitfieldExtractShiftLeftImmediate>(opcode.assignmentOperation);
+            case Opcode::Operation::BitfieldExtractShiftLeftRegister:
+                return GetAssignmentHandler<Opcode::Operation::BitfieldExtractShiftLeftRegister>(opcode.assignmentOperation);
+            case Opcode::Operation::ReadImmediate:
+                return GetAssignmentHandler<Opcode::Operation::ReadImmediate>(opcode.assignmentOperation);
+            case Opcode::Operation::Branch:
+                if (opcode.branchCondition == Opcode::BranchCondition::Zero)
+                    return &Branch<Opcode::BranchCondition::Zero>;
+                else
+                    return &Branch<Opcode::BranchCondition::NonZero>;
+            default:
+                return &Nop; // The interpreter doesn't do anything for unknown operations
+        }
+    }
+
+    template<MacroThreadedInterpreter::Opcode::Operation Operation, MacroThreadedInterpreter::Opcode::AluOperation AluOperation>
+    MacroThreadedInterpreter::Handler MacroThreadedInterpreter::GetAssignmentHandler(Opcode::AssignmentOperation assignmentOperation) {
+        switch (assignmentOperation) {
+            case Opcode::AssignmentOperation::IgnoreAndFetch:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::IgnoreAndFetch>;
+            case Opcode::AssignmentOperation::Move:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::Move>;
+            case Opcode::AssignmentOperation::MoveAndSetMethod:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::MoveAndSetMethod>;
+            case Opcode::AssignmentOperation::FetchAndSend:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::FetchAndSend>;
+            case Opcode::AssignmentOperation::MoveAndSend:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::MoveAndSend>;
+            case Opcode::AssignmentOperation::FetchAndSetMethod:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::FetchAndSetMethod>;
+            case Opcode::AssignmentOperation::MoveAndSetMethodThenFetchAndSend:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::MoveAndSetMethodThenFetchAndSend>;
+            case Opcode::AssignmentOperation::MoveAndSetMethodThenSendHigh:
+                return &Operate<Operation, AluOperation, Opcode::AssignmentOperation::MoveAndSetMethodThenSendHigh>;
+            default:
+                return nullptr;
+        }
+    }
+
+    template<MacroThreadedInterpreter::Opcode::Operation Operation, MacroThreadedInterpreter::Opcode::AluOperation AluOperation, MacroThreadedInterpreter::Opcode::AssignmentOperation AssignmentOperation>
+    const MacroThreadedInterpreter::Instruction *MacroThreadedInterpreter::Operate(Context &context, const Instruction &instruction) {
+        const auto &registers{context.registers};
+        u32 result{};
+
+        if constexpr (Operation == Opcode::Operation::AluRegister) {
+            result = Alu<AluOperation>(context, registers[instruction.srcA], registers[instruction.srcB]);
+        } else if constexpr (Operation == Opcode::Operation::AddImmediate) {
+            result = registers[instruction.srcA] + instruction.immediate;
+        } else if constexpr (Operation == Opcode::Operation::BitfieldReplace) {
+            u32 src = (registers[instruction.srcB] >> instruction.srcBit) & instruction.mask;
+            u32 dest = registers[instruction.srcA] & ~(instruction.mask << instruction.destBit);
+            result = dest | (src << instruction.destBit);
+        } else if constexpr (Operation == Opcode::Operation::BitfieldExtractShiftLeftImmediate) {
+            result = ((registers[instruction.srcB] >> registers[instruction.srcA]) & instruction.mask) << instruction.destBit;
+        } else if constexpr (Operation == Opcode::Operation::BitfieldExtractShiftLeftRegister) {
+            result = ((registers[instruction.srcB] >> instruction.srcBit) & instruction.mask) << registers[instruction.srcA];
+        } else if constexpr (Operation == Opcode::Operation::ReadImmediate) {
+            result = context.maxwell3D.registers.raw[registers[instruction.srcA] + instruction.immediate];
+        }
+
+        Assign<AssignmentOperation>(context, instruction.dest, result);
+        return instruction.next;
+    }
+
+    template<MacroThreadedInterpreter::Opcode::AluOperation AluOperation>
+    FORCE_INLINE u32 MacroThreadedInterpreter::Alu(Context &context, u32 srcA, u32 srcB) {
+        if constexpr (AluOperation == Opcode::AluOperation::Add) {
+            u64 result = static_cast<u64>(srcA) + srcB;
+
+            context.carryFlag = result >> 32;
+            return static_cast<u32>(result);
+        } else if constexpr (AluOperation == Opcode::AluOperation::AddWithCarry) {
+            u64 result = static_cast<u64>(srcA) + srcB + context.carryFlag;
+
+            context.carryFlag = result >> 32;
+            return static_cast<u32>(result);
+        } else if constexpr (AluOperation == Opcode::AluOperation::Subtract) {
+            u64 result = static_cast<u64>(srcA) - srcB;
+
+            context.carryFlag = result & 0xFFFFFFFF;
+            return static_cast<u32>(result);
+        } else if constexpr (AluOperation == Opcode::AluOperation::SubtractWithBorrow) {
+            u64 result = static_cast<u64>(srcA) - srcB - !context.carryFlag;
+
+            context.carryFlag = result & 0xFFFFFFFF;
+            return static_cast<u32>(result);
+        } else if constexpr (AluOperation == Opcode::AluOperation::BitwiseXor) {
+            return srcA ^ srcB;
+        } else if constexpr (AluOperation == Opcode::AluOperation::BitwiseOr) {
+            return srcA | srcB;
+        } else if constexpr (AluOperation == Opcode::AluOperation::BitwiseAnd) {
+            return srcA & srcB;
+        } else if constexpr (AluOperation == Opcode::AluOperation::BitwiseAndNot) {
+            return srcA & ~srcB;
+        } else if constexpr (AluOperation == Opcode::AluOperation::BitwiseNand) {
+            return ~(srcA & srcB);
+        }
+    }
+
+    template<MacroThreadedInterpreter::Opcode::AssignmentOperation AssignmentOperation>
+    FORCE_INLINE void MacroThreadedInterpreter::Assign(Context &context, u8 reg, u32 result) {
+        auto &registers{context.registers};
+
+        if constexpr (AssignmentOperation == Opcode::AssignmentOperation::IgnoreAndFetch) {
+            registers[reg] = *context.argument++;
+        } else if constexpr (AssignmentOperation == Opcode::AssignmentOperation::Move) {
+            registers[reg] = result;
+        } else if constexpr (AssignmentOperation == Opcode::AssignmentOperation::MoveAndSetMethod) {
+            registers[reg] = result;
+            context.methodAddress.raw = result;
+        } else if constexpr (AssignmentOperation == Opcode::AssignmentOperation::FetchAndSend) {
+            registers[reg] = *context.argument++;
+            Send(context, result);
+        } else if constexpr (AssignmentOperation == Opcode::AssignmentOperation::MoveAndSend) {
+            registers[reg] = result;
+            Send(context, result);
+        } else if constexpr (AssignmentOperation == Opcode::AssignmentOperation::FetchAndSetMethod) {
+            registers[reg] = *context.argument++;
+            context.methodAddress.raw = result;
+        } else if constexpr (AssignmentOperation == Opcode::AssignmentOperation::MoveAndSetMethodThenFetchAndSend) {
+            registers[reg] = result;
+            context.methodAddress.raw = result;
+            Send(context, *context.argument++);
+        } else if constexpr (AssignmentOperation == Opcode::AssignmentOperation::MoveAndSetMethodThenSendHigh) {
+            registers[reg] = result;
+            context.methodAddress.raw = result;
+            Send(context, context.methodAddress.increment);
+        }
+    }
+
+    FORCE_INLINE void MacroThreadedInterpreter::Send(Context &context, u32 argument) {
+        context.maxwell3D.CallMethod(MethodParams{static_cast<u16>(context.methodAddress.address), argument, 0, true});
+
+        context.methodAddress.address += context.methodAddress.increment;
+    }
+
+    template<MacroThreadedInterpreter::Opcode::BranchCondition BranchCondition>
+    const MacroThreadedInterpreter::Instruction *MacroThreadedInterpreter::Branch(Context &context, const Instruction &instruction) {
+        u32 value = context.registers[instruction.srcA];
+        bool branch = (BranchCondition == Opcode::BranchCondition::Zero) ? (value == 0) : (value != 0);
+
+        return branch ? instruction.target : instruction.next;
+    }
+
+    const MacroThreadedInterpreter::Instruction *MacroThreadedInterpreter::Nop(Context &context, const Instruction &instruction) {
+        return instruction.next;
+    }
+
+    const MacroThreadedInterpreter::Instruction *MacroThreadedInterpreter::BranchInDelaySlot(Context &context, const Instruction &instruction) {
+        throw exception("Cannot branch while inside a delay slot");
+    }
+
+    const MacroThreadedInterpreter::Instruction *MacroThreadedInterpreter::BranchOutOfBounds(Context &context, const Instruction &instruction) {
+        throw exception("Macro branch target is outside of macro memory");
+    }
+
+    const MacroThreadedInterpreter::Instruction *MacroThreadedInterpreter::PastEnd(Context &context, const Instruction &instruction) {
+        throw exception("Macro execution ran past the end of the macro");
+    }
+}
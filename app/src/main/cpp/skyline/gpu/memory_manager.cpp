@@ -6,86 +6,87 @@
 
 namespace skyline::gpu::vmm {
     MemoryManager::MemoryManager(const DeviceState &state) : state(state) {
-        constexpr u64 GpuAddressSpaceSize = 1ul << 40; //!< The size of the GPU address space
-        constexpr u64 GpuAddressSpaceBase = 0x100000; //!< The base of the GPU address space - must be non-zero
-
         // Create the initial chunk that will be split to create new chunks
-        ChunkDescriptor baseChunk(GpuAddressSpaceBase, GpuAddressSpaceSize, 0, ChunkState::Unmapped);
-        chunkList.push_back(baseChunk);
+        EmplaceChunk(ChunkDescriptor(constant::GpuAddressSpaceBase, constant::GpuAddressSpaceSize, 0, ChunkState::Unmapped));
+    }
+
+    void MemoryManager::EmplaceChunk(const ChunkDescriptor &chunk) {
+        chunks.emplace(chunk.address, chunk);
+        if (chunk.state == ChunkState::Unmapped)
+            freeChunks.emplace(chunk.size, chunk.address);
     }
 
-    std::optional<ChunkDescriptor> MemoryManager::FindChunk(u64 size, ChunkState state) {
-        auto chunk = std::find_if(chunkList.begin(), chunkList.end(), [size, state](const ChunkDescriptor &chunk) -> bool {
-            return chunk.size > size && chunk.state == state;
-        });
+    std::map<u64, ChunkDescriptor>::iterator MemoryManager::EraseChunk(std::map<u64, ChunkDescriptor>::iterator chunk) {
+        if (chunk->second.state == ChunkState::Unmapped)
+            freeChunks.erase({chunk->second.size, chunk->second.address});
+        return chunks.erase(chunk);
+    }
 
-        if (chunk != chunkList.end())
-            return *chunk;
+    std::optional<ChunkDescriptor> MemoryManager::FindChunk(u64 size) {
+        auto chunk = freeChunks.lower_bound({size, 0});
+        if (chunk != freeChunks.end())
+            return chunks.at(chunk->second);
 
         return std::nullopt;
     }
 
     u64 MemoryManager::InsertChunk(const ChunkDescriptor &newChunk) {
-        auto chunkEnd = chunkList.end();
-        for (auto chunk = chunkList.begin(); chunk != chunkEnd; chunk++) {
-            if (chunk->CanContain(newChunk)) {
-                auto oldChunk = *chunk;
-                u64 newSize = newChunk.address - chunk->address;
-                u64 extension = chunk->size - newSize - newChunk.size;
-
-                if (newSize == 0) {
-                    *chunk = newChunk;
-                } else {
-                    chunk->size = newSize;
-
-                    chunk = chunkList.insert(std::next(chunk), newChunk);
-                }
-
-                if (extension)
-                    chunkList.insert(std::next(chunk), ChunkDescriptor(newChunk.address + newChunk.size, extension, (oldChunk.state == ChunkState::Mapped) ? (oldChunk.cpuAddress + newSize + newChunk.size) : 0, oldChunk.state));
-
-                return newChunk.address;
-            } else if (chunk->address + chunk->size > newChunk.address) {
-                chunk->size = newChunk.address - chunk->address;
-
-                // Deletes all chunks that are within the chunk being inserted and split the final one
-                auto tailChunk = std::next(chunk);
-                while (tailChunk != chunkEnd) {
-                    if (tailChunk->address + tailChunk->size >= newChunk.address + newChunk.size)
-                        break;
-
-                    tailChunk = chunkList.erase(tailChunk);
-                    chunkEnd = chunkList.end();
-                }
-
-                // The given chunk is too large to fit into existing chunks
-                if (tailChunk == chunkEnd)
-                    break;
-
-                u64 chunkSliceOffset = newChunk.address + newChunk.size - tailChunk->address;
-                tailChunk->address += chunkSliceOffset;
-                tailChunk->size -= chunkSliceOffset;
-                if (tailChunk->state == ChunkState::Mapped)
-                    tailChunk->cpuAddress += chunkSliceOffset;
-
-
-                // If the size of the head chunk is zero then we can directly replace it with our new one rather than inserting it
-                auto headChunk = std::prev(tailChunk);
-                if (headChunk->size == 0)
-                    *headChunk = newChunk;
-                else
-                    chunkList.insert(std::next(headChunk), newChunk);
+        u64 newEnd{newChunk.address + newChunk.size};
+        auto chunk = chunks.upper_bound(newChunk.address);
+
+        // The given chunk is outside of the address space or too large to fit into it
+        if (chunk == chunks.begin() || newEnd > constant::GpuAddressSpaceBase + constant::GpuAddressSpaceSize)
+            throw exception("Failed to insert chunk into GPU address space!");
 
-                return newChunk.address;
+        // Every chunk overlapping the new chunk is removed, the parts of the first and last ones that lie outside of it are reinserted
+        chunk--;
+        while (chunk != chunks.end() && chunk->second.address < newEnd) {
+            auto oldChunk = chunk->second;
+            chunk = EraseChunk(chunk);
+
+            if (oldChunk.address < newChunk.address)
+                EmplaceChunk(ChunkDescriptor(oldChunk.address, newChunk.address - oldChunk.address, oldChunk.cpuAddress, oldChunk.state));
+
+            u64 oldEnd{oldChunk.address + oldChunk.size};
+            if (oldEnd > newEnd) {
+                u64 chunkSliceOffset{newEnd - oldChunk.address};
+                EmplaceChunk(ChunkDescriptor(newEnd, oldEnd - newEnd, (oldChunk.state == ChunkState::Mapped) ? (oldChunk.cpuAddress + chunkSliceOffset) : 0, oldChunk.state));
             }
         }
 
-        throw exception("Failed to insert chunk into GPU address space!");
+        EmplaceChunk(newChunk);
+        translationCache.fill({});
+
+        return newChunk.address;
+    }
+
+    std::optional<ChunkDescriptor> MemoryManager::GetMappedChunk(u64 address) const {
+        std::lock_guard guard(mutex);
+
+        for (const auto &entry : translationCache)
+            if (entry.Contains(address))
+                return entry;
+
+        auto chunk = chunks.upper_bound(address);
+        if (chunk == chunks.begin())
+            return std::nullopt;
+
+        chunk--;
+
+        if (chunk->second.state != ChunkState::Mapped || !chunk->second.Contains(address))
+            return std::nullopt;
+
+        translationCache[translationCacheIndex] = chunk->second;
+        translationCacheIndex = (translationCacheIndex + 1) % translationCache.size();
+
+        return chunk->second;
     }
 
     u64 MemoryManager::ReserveSpace(u64 size) {
         size = util::AlignUp(size, constant::GpuPageSize);
-        auto newChunk = FindChunk(size, ChunkState::Unmapped);
+
+        std::lock_guard guard(mutex);
+        auto newChunk = FindChunk(size);
         if (!newChunk)
             return 0;
 
@@ -102,12 +103,15 @@ namespace skyline::gpu::vmm {
 
         size = util::AlignUp(size, constant::GpuPageSize);
 
+        std::lock_guard guard(mutex);
         return InsertChunk(ChunkDescriptor(address, size, 0, ChunkState::Reserved));
     }
 
     u64 MemoryManager::MapAllocate(u64 address, u64 size) {
         size = util::AlignUp(size, constant::GpuPageSize);
-        auto mappedChunk = FindChunk(size, ChunkState::Unmapped);
+
+        std::lock_guard guard(mutex);
+        auto mappedChunk = FindChunk(size);
         if (!mappedChunk)
             return 0;
 
@@ -125,6 +129,7 @@ namespace skyline::gpu::vmm {
 
         size = util::AlignUp(size, constant::GpuPageSize);
 
+        std::lock_guard guard(mutex);
         return InsertChunk(ChunkDescriptor(address, size, cpuAddress, ChunkState::Mapped));
     }
 
@@ -132,76 +137,98 @@ namespace skyline::gpu::vmm {
         if (!util::IsAligned(address, constant::GpuPageSize))
             return false;
 
-        auto chunk = std::find_if(chunkList.begin(), chunkList.end(), [address](const ChunkDescriptor &chunk) -> bool {
-            return chunk.address == address;
-        });
-
-        if (chunk == chunkList.end())
+        std::lock_guard guard(mutex);
+        auto chunk = chunks.find(address);
+        if (chunk == chunks.end())
             return false;
 
-        chunk->state = ChunkState::Reserved;
-        chunk->cpuAddress = 0;
+        auto unmappedChunk = chunk->second;
+        unmappedChunk.state = ChunkState::Reserved;
+        unmappedChunk.cpuAddress = 0;
+
+        EraseChunk(chunk);
+        EmplaceChunk(unmappedChunk);
+        translationCache.fill({});
 
         return true;
     }
 
-    void MemoryManager::Read(u8 *destination, u64 address, u64 size) const {
-        auto chunk = std::upper_bound(chunkList.begin(), chunkList.end(), address, [](const u64 address, const ChunkDescriptor &chunk) -> bool {
-            return address < chunk.address;
-        });
-
-        if (chunk == chunkList.end() || chunk->state != ChunkState::Mapped)
-            throw exception("Failed to read region in GPU address space: Address: 0x{:X}, Size: 0x{:X}", address, size);
+    u8 *MemoryManager::GetHostPointer(u64 address, u64 size) const {
+        auto chunk = GetMappedChunk(address);
+        if (!chunk)
+            return nullptr;
 
-        chunk--;
+        if ((address + size) <= (chunk->address + chunk->size))
+            return reinterpret_cast<u8 *>(state.process->GetHostAddress(chunk->cpuAddress + (address - chunk->address), size));
 
-        u64 initialSize{size};
-        u64 chunkOffset{address - chunk->address};
-        u64 readAddress{chunk->cpuAddress + chunkOffset};
-        u64 readSize{std::min(chunk->size - chunkOffset, size)};
+        // The region spans multiple chunks which might still be contiguous in host memory
+        auto spans = GetHostSpans(address, size);
+        return (spans.size() == 1) ? spans.front().data() : nullptr;
+    }
 
-        // A continuous region in the GPU address space may be made up of several discontinuous regions in physical memory so we have to iterate over all chunks
+    std::vector<std::span<u8>> MemoryManager::GetHostSpans(u64 address, u64 size) const {
+        std::vector<std::span<u8>> spans;
         while (size) {
-            state.process->ReadMemory(destination + (initialSize - size), readAddress, readSize);
+            auto chunk = GetMappedChunk(address);
+            if (!chunk)
+                return {};
 
-            size -= readSize;
-            if (size) {
-                if (++chunk == chunkList.end() || chunk->state != ChunkState::Mapped)
-                    throw exception("Failed to read region in GPU address space: Address: 0x{:X}, Size: 0x{:X}", address, size);
+            u64 chunkOffset{address - chunk->address};
+            u64 chunkSize{std::min(chunk->size - chunkOffset, size)};
+
+            // A chunk may be backed by several host mappings as it's only contiguous in the CPU address space
+            for (u64 cpuAddress{chunk->cpuAddress + chunkOffset}, remaining{chunkSize}; remaining;) {
+                auto span = state.process->GetHostSpan(cpuAddress, remaining);
+                if (span.empty())
+                    return {};
 
-                readAddress = chunk->cpuAddress;
-                readSize = std::min(chunk->size, size);
+                if (!spans.empty() && spans.back().data() + spans.back().size() == span.data())
+                    spans.back() = std::span(spans.back().data(), spans.back().size() + span.size());
+                else
+                    spans.push_back(span);
+
+                cpuAddress += span.size();
+                remaining -= span.size();
             }
+
+            address += chunkSize;
+            size -= chunkSize;
         }
-    }
 
-    void MemoryManager::Write(u8 *source, u64 address, u64 size) const {
-        auto chunk = std::upper_bound(chunkList.begin(), chunkList.end(), address, [](const u64 address, const ChunkDescriptor &chunk) -> bool {
-            return address < chunk.address;
-        });
+        return spans;
+    }
 
-        if (chunk == chunkList.end() || chunk->state != ChunkState::Mapped)
-            throw exception("Failed to write region in GPU address space: Address: 0x{:X}, Size: 0x{:X}", address, size);
+    void MemoryManager::Read(u8 *destination, u64 address, u64 size) const {
+        // A continuous region in the GPU address space may be made up of several discontinuous regions in physical memory so it's split at every chunk boundary
+        while (size) {
+            auto chunk = GetMappedChunk(address);
+            if (!chunk)
+                throw exception("Failed to read region in GPU address space: Address: 0x{:X}, Size: 0x{:X}", address, size);
 
-        chunk--;
+            u64 chunkOffset{address - chunk->address};
+            u64 readSize{std::min(chunk->size - chunkOffset, size)};
+            state.process->ReadMemory(destination, chunk->cpuAddress + chunkOffset, readSize);
 
-        u64 initialSize{size};
-        u64 chunkOffset{address - chunk->address};
-        u64 writeAddress{chunk->cpuAddress + chunkOffset};
-        u64 writeSize{std::min(chunk->size - chunkOffset, size)};
+            destination += readSize;
+            address += readSize;
+            size -= readSize;
+        }
+    }
 
-        // A continuous region in the GPU address space may be made up of several discontinuous regions in physical memory so we have to iterate over all chunks
+    void MemoryManager::Write(u8 *source, u64 address, u64 size) const {
+        // A continuous region in the GPU address space may be made up of several discontinuous regions in physical memory so it's split at every chunk boundary
         while (size) {
-            state.process->WriteMemory(source + (initialSize - size), writeAddress, writeSize);
+            auto chunk = GetMappedChunk(address);
+            if (!chunk)
+                throw exception("Failed to write region in GPU address space: Address: 0x{:X}, Size: 0x{:X}", address, size);
 
-            size -= writeSize;
-            if (size) {
-                if (++chunk == chunkList.end() || chunk->state != ChunkState::Mapped)
-                    throw exception("Failed to write region in GPU address space: Address: 0x{:X}, Size: 0x{:X}", address, size);
+            u64 chunkOffset{address - chunk->address};
+            u64 writeSize{std::min(chunk->size - chunkOffset, size)};
+            state.process->WriteMemory(source, chunk->cpuAddress + chunkOffset, writeSize);
 
-                writeAddress = chunk->cpuAddress;
-                writeSize = std::min(chunk->size, size);
-            }
+            source += writeSize;
+            address += writeSize;
+            size -= writeSize;
         }
     }
 }
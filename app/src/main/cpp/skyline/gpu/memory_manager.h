@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <set>
 #include <common.h>
 
 namespace skyline {
     namespace constant {
         constexpr u64 GpuPageSize = 1 << 16; //!< The page size of the GPU address space
+        constexpr u64 GpuAddressSpaceSize = 1ul << 40; //!< The size of the GPU address space
+        constexpr u64 GpuAddressSpaceBase = 0x100000; //!< The base of the GPU address space - must be non-zero
     }
 
     namespace gpu::vmm {
@@ -24,10 +27,12 @@ namespace skyline {
         * @brief This describes a chunk of memory and all of it's individual attributes
         */
         struct ChunkDescriptor {
-            u64 address; //!< The address of the chunk in the GPU address space
-            u64 size; //!< The size of the chunk in bytes
-            u64 cpuAddress; //!< The address of the chunk in the CPU address space (if mapped)
-            ChunkState state; //!< The state of the chunk
+            u64 address{}; //!< The address of the chunk in the GPU address space
+            u64 size{}; //!< The size of the chunk in bytes
+            u64 cpuAddress{}; //!< The address of the chunk in the CPU address space (if mapped)
+            ChunkState state{ChunkState::Unmapped}; //!< The state of the chunk
+
+            ChunkDescriptor() = default;
 
             ChunkDescriptor(u64 address, u64 size, u64 cpuAddress, ChunkState state) : address(address), size(size), cpuAddress(cpuAddress), state(state) {}
 
@@ -38,6 +43,13 @@ namespace skyline {
             inline bool CanContain(const ChunkDescriptor &chunk) {
                 return (chunk.address >= this->address) && ((this->size + this->address) >= (chunk.size + chunk.address));
             }
+
+            /**
+             * @return If the given address is inside of this chunk
+             */
+            inline bool Contains(u64 address) const {
+                return (address - this->address) < size;
+            }
         };
 
         /**
@@ -46,25 +58,45 @@ namespace skyline {
         class MemoryManager {
           private:
             const DeviceState &state;
+            std::map<u64, ChunkDescriptor> chunks; //!< All chunks in the GPU address space keyed by their address, they're contiguous and cover the entire address space
+            std::set<std::pair<u64, u64>> freeChunks; //!< The size and address of every unmapped chunk, this is ordered by size so the best fit for an allocation can be found quickly
+            mutable std::array<ChunkDescriptor, 4> translationCache{}; //!< The most recently translated mapped chunks, most accesses hit the same few chunks repeatedly so this avoids most tree lookups
+            mutable size_t translationCacheIndex{}; //!< The index of the next entry in the translation cache to be replaced
+            mutable Mutex mutex; //!< Synchronizes all accesses to the chunks and the translation cache
 
             /**
-             * @brief This finds a chunk of the specified type in the GPU address space that is larger than the given size
+             * @brief This finds the smallest unmapped chunk in the GPU address space that fits the given size
              * @param size The minimum size of the chunk to find
-             * @param state The state desired state of the chunk to find
-             * @return The first unmapped chunk in the GPU address space that fits the requested size
+             * @return The best fitting unmapped chunk in the GPU address space
              */
-            std::optional<ChunkDescriptor> FindChunk(u64 size, ChunkState state);
+            std::optional<ChunkDescriptor> FindChunk(u64 size);
 
             /**
-             * @brief This inserts a chunk into the chunk list, resizing and splitting as necessary
+             * @brief This inserts a chunk into the chunk tree, resizing and splitting the chunks it overlaps as necessary
              * @param newChunk The chunk to insert
              * @return The base virtual GPU address of the inserted chunk
              */
             u64 InsertChunk(const ChunkDescriptor &newChunk);
 
+            /**
+             * @brief Adds a chunk to the chunk tree and the free-space index if it's unmapped
+             */
+            void EmplaceChunk(const ChunkDescriptor &chunk);
+
+            /**
+             * @brief Removes a chunk from the chunk tree and the free-space index if it's unmapped
+             * @return An iterator to the chunk after the erased one
+             */
+            std::map<u64, ChunkDescriptor>::iterator EraseChunk(std::map<u64, ChunkDescriptor>::iterator chunk);
+
+            /**
+             * @brief Looks up the mapped chunk which contains an address
+             * @return A copy of the chunk or std::nullopt if the address isn't mapped
+             */
+            std::optional<ChunkDescriptor> GetMappedChunk(u64 address) const;
+
           public:
             MemoryManager(const DeviceState &state);
-            std::vector<ChunkDescriptor> chunkList; //!< This vector holds all the chunk descriptors
 
             /**
              * @brief This reserves a region of the GPU address space so it will not be chosen automatically when mapping
@@ -104,6 +136,23 @@ namespace skyline {
              */
             bool Unmap(u64 address);
 
+            /**
+             * @brief Translates a region of the GPU virtual address space into a host pointer, this can be used to access it without copying
+             * @param address The address of the region in the GPU virtual address space
+             * @param size The size of the region
+             * @return A pointer to the region in host memory or nullptr if it's not contiguous in host memory
+             */
+            u8 *GetHostPointer(u64 address, u64 size) const;
+
+            /**
+             * @brief Translates a region of the GPU virtual address space into the spans of host memory that back it, these can be accessed in place rather than copying the region with Read or Write
+             * @param address The address of the region in the GPU virtual address space
+             * @param size The size of the region
+             * @return The spans covering the region in order, spans that are contiguous in host memory are merged together
+             * @note This returns no spans if any part of the region isn't mapped or isn't backed by host memory, Read and Write can still be used on such regions
+             */
+            std::vector<std::span<u8>> GetHostSpans(u64 address, u64 size) const;
+
             void Read(u8 *destination, u64 address, u64 size) const;
 
             /**
@@ -1,62 +1,93 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <common.h>
 #include "syncpoint.h"
 
 namespace skyline::gpu {
     u64 Syncpoint::RegisterWaiter(u32 threshold, const std::function<void()> &callback) {
+        std::unique_lock lock(waiterLock);
         if (value >= threshold) {
+            // The threshold is checked while holding the lock as increments only process waiters after updating the value
+            lock.unlock();
             callback();
             return 0;
         }
 
-        std::lock_guard guard(waiterLock);
-        waiterMap.insert({nextWaiterId, Waiter{threshold, callback}});
+        waiterCallbacks.emplace(nextWaiterId, callback);
+        waiterHeap.push_back(Waiter{threshold, nextWaiterId});
+        std::push_heap(waiterHeap.begin(), waiterHeap.end());
 
         return nextWaiterId++;
     }
 
     void Syncpoint::DeregisterWaiter(u64 id) {
         std::lock_guard guard(waiterLock);
-        waiterMap.erase(id);
+        waiterCallbacks.erase(id);
+
+        // Deregistered waiters stay in the heap till they reach the top, the heap is rebuilt without them once they outnumber the live waiters so it can't grow without bound
+        if (waiterCallbacks.empty()) {
+            waiterHeap.clear();
+        } else if (waiterHeap.size() > waiterCallbacks.size() * 2) {
+            std::erase_if(waiterHeap, [this](const Waiter &waiter) { return !waiterCallbacks.contains(waiter.id); });
+            std::make_heap(waiterHeap.begin(), waiterHeap.end());
+        }
     }
 
     u32 Syncpoint::Increment() {
-        value++;
+        u32 newValue{++value};
+
+        if (futexWaiters.load(std::memory_order_seq_cst))
+            syscall(SYS_futex, reinterpret_cast<u32 *>(&value), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
 
         std::lock_guard guard(waiterLock);
-        std::erase_if(waiterMap, [this](const auto &entry) {
-            if (value >= entry.second.threshold) {
-                entry.second.callback();
-                return true;
-            } else {
-                return false;
+        while (!waiterHeap.empty() && waiterHeap.front().threshold <= newValue) {
+            auto id{waiterHeap.front().id};
+            std::pop_heap(waiterHeap.begin(), waiterHeap.end());
+            waiterHeap.pop_back();
+
+            auto callback{waiterCallbacks.find(id)};
+            if (callback != waiterCallbacks.end()) {
+                callback->second();
+                waiterCallbacks.erase(callback);
             }
-        });
+        }
 
-        return value;
+        return newValue;
     }
 
     bool Syncpoint::Wait(u32 threshold, std::chrono::steady_clock::duration timeout) {
-        std::mutex mtx;
-        std::condition_variable cv;
-        bool flag{};
-
         if (timeout == timeout.max())
             timeout = std::chrono::seconds(1);
 
-        if (!RegisterWaiter(threshold, [&cv, &mtx, &flag] {
-            std::unique_lock lock(mtx);
-            flag = true;
-            lock.unlock();
-            cv.notify_all();
-        })) {
-            return true;
+        auto deadline{std::chrono::steady_clock::now() + timeout};
+        futexWaiters.fetch_add(1, std::memory_order_seq_cst);
+
+        bool reached{};
+        while (true) {
+            // The futex only puts the thread to sleep if the value hasn't changed since it was loaded so increments can't be missed
+            u32 current{value.load(std::memory_order_seq_cst)};
+            if (current >= threshold) {
+                reached = true;
+                break;
+            }
+
+            auto remaining{deadline - std::chrono::steady_clock::now()};
+            if (remaining <= std::chrono::steady_clock::duration::zero())
+                break;
+
+            auto seconds{std::chrono::duration_cast<std::chrono::seconds>(remaining)};
+            timespec relativeTimeout{
+                .tv_sec = static_cast<time_t>(seconds.count()),
+                .tv_nsec = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining - seconds).count()),
+            };
+            syscall(SYS_futex, reinterpret_cast<u32 *>(&value), FUTEX_WAIT_PRIVATE, current, &relativeTimeout, nullptr, 0);
         }
 
-        std::unique_lock lock(mtx);
-        return cv.wait_for(lock, timeout, [&flag] { return flag; });
+        futexWaiters.fetch_sub(1, std::memory_order_relaxed);
+        return reached;
     }
 };
-
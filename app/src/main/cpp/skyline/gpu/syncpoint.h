@@ -17,16 +17,25 @@ namespace skyline {
         class Syncpoint {
           private:
             /**
-             * @brief This holds information about a single waiter on a syncpoint
+             * @brief This holds the position of a single waiter in the waiter heap
              */
             struct Waiter {
-                u32 threshold;
-                std::function<void()> callback;
+                u32 threshold; //!< The value of the syncpoint at which the waiter is signalled
+                u64 id; //!< The identifier of the waiter, this is used to look up its callback
+
+                /**
+                 * @note This is inverted so the standard heap algorithms create a min-heap with the lowest threshold at the top
+                 */
+                bool operator<(const Waiter &other) const {
+                    return threshold > other.threshold;
+                }
             };
 
             Mutex waiterLock{}; //!< Locks insertions and deletions of waiters
-            std::map<u64, Waiter> waiterMap{};
+            std::vector<Waiter> waiterHeap{}; //!< A min-heap of waiters ordered by their threshold so an increment only needs to look at the waiters it satisfies
+            std::unordered_map<u64, std::function<void()>> waiterCallbacks{}; //!< The callbacks of all registered waiters, deregistered waiters are only removed from here and are skipped once they reach the top of the heap or dropped when the heap is compacted
             u64 nextWaiterId{1};
+            std::atomic<u32> futexWaiters{}; //!< The amount of threads that are blocked in Wait, increments only wake them up when this is non-zero
 
           public:
             std::atomic<u32> value{};
@@ -50,7 +59,7 @@ namespace skyline {
             u32 Increment();
 
             /**
-             * @brief Waits for the syncpoint to reach given threshold
+             * @brief Waits for the syncpoint to reach given threshold, this blocks on a futex on the value directly and doesn't allocate
              * @return false if the timeout was reached, otherwise true
              */
             bool Wait(u32 threshold, std::chrono::steady_clock::duration timeout);
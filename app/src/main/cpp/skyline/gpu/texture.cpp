@@ -1,82 +1,205 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <bit>
 #include <android/native_window.h>
 #include <kernel/types/KProcess.h>
+#include <gpu.h>
 #include <unistd.h>
+#include "tiling.h"
+#include "format.h"
 #include "texture.h"
 
 namespace skyline::gpu {
+    namespace {
+        /**
+         * @brief Hashes a unit of a guest texture, this is used to detect if the unit was modified without keeping a copy of it
+         * @details This is a Fletcher checksum over 64-bit words split across four lanes, it only needs two additions per word so it's cheaper than comparing the unit against a copy as half the data is read, any reordering of words changes the weighted sum
+         * @note A collision only leaves the unit stale till its next modification
+         */
+        u64 HashGuestUnit(const u8 *data, size_t size) {
+            constexpr u64 Prime{0x9E3779B185EBCA87};
+
+            std::array<u64, 4> sums{}, weightedSums{};
+            auto end{data + size};
+            for (; data + sizeof(sums) <= end; data += sizeof(sums)) {
+                std::array<u64, 4> words;
+                std::memcpy(words.data(), data, sizeof(words));
+                for (size_t lane{}; lane < sums.size(); lane++) {
+                    sums[lane] += words[lane];
+                    weightedSums[lane] += sums[lane];
+                }
+            }
+
+            u64 hash{size};
+            for (size_t lane{}; lane < sums.size(); lane++)
+                hash = (std::rotl(hash ^ sums[lane], 29) ^ weightedSums[lane]) * Prime;
+            for (; data < end; data++)
+                hash = std::rotl(hash ^ *data, 11) * Prime;
+
+            return hash;
+        }
+    }
+
     GuestTexture::GuestTexture(const DeviceState &state, u64 address, texture::Dimensions dimensions, texture::Format format, texture::TileMode tiling, texture::TileConfig layout) : state(state), address(address), dimensions(dimensions), format(format), tileMode(tiling), tileConfig(layout) {}
 
-    Texture::Texture(const DeviceState &state, std::shared_ptr<GuestTexture> guest, texture::Dimensions dimensions, texture::Format format, texture::Swizzle swizzle) : state(state), guest(guest), dimensions(dimensions), format(format), swizzle(swizzle) {
-        SynchronizeHost();
+    std::shared_ptr<Texture> GuestTexture::InitializeTexture(std::optional<texture::Format> format, std::optional<texture::Dimensions> dimensions, texture::Swizzle swizzle) {
+        if (!host.expired())
+            throw exception("Trying to create multiple Texture objects from a single GuestTexture");
+        auto texture = std::make_shared<Texture>(state, shared_from_this(), dimensions ? *dimensions : this->dimensions, format ? *format : (this->format.decode ? format::RGBA8888Unorm : this->format), swizzle); // Formats which have a decoder are assumed to not be supported by the host
+        texture->SynchronizeHost();
+        host = texture;
+        return texture;
+    }
+
+    Texture::Texture(const DeviceState &state, std::shared_ptr<GuestTexture> guest, texture::Dimensions dimensions, texture::Format format, texture::Swizzle swizzle) : state(state), dirtyTracking(state.settings->GetBool("texture_dirty_tracking")), guest(guest), dimensions(dimensions), format(format), swizzle(swizzle) {}
+
+    Texture::GuestLayout Texture::GetGuestLayout() {
+        GuestLayout layout{};
+        auto &guestFormat{guest->format};
+        layout.blockDimensions = texture::Dimensions(util::DivideCeil(dimensions.width, guestFormat.blockWidth), util::DivideCeil(dimensions.height, guestFormat.blockHeight), dimensions.depth);
+        layout.lineSize = static_cast<size_t>(layout.blockDimensions.width) * guestFormat.bpb;
+
+        if (guest->tileMode == texture::TileMode::Block) {
+            // Every ROB (Row Of Blocks) is independent of the others on 2D surfaces, 3D surfaces are treated as a single unit as their ROBs are interleaved with the slices
+            layout.lineCount = layout.blockDimensions.height;
+            auto robLines = static_cast<u32>(constant::GobHeight * std::max<u8>(guest->tileConfig.blockHeight, 1));
+            layout.unitLines = (layout.blockDimensions.depth > 1) ? layout.lineCount : robLines;
+            layout.unitStride = texture::GetBlockLinearLevelSize(texture::Dimensions(util::DivideCeil<u32>(guest->tileConfig.surfaceWidth, guestFormat.blockWidth), layout.unitLines, layout.blockDimensions.depth), guestFormat.bpb, std::max<u8>(guest->tileConfig.blockHeight, 1), std::max<u8>(guest->tileConfig.blockDepth, 1));
+            layout.unitSize = layout.unitStride;
+        } else {
+            layout.lineCount = layout.blockDimensions.height * layout.blockDimensions.depth;
+            layout.unitLines = 1;
+            layout.unitStride = (guest->tileMode == texture::TileMode::Pitch) ? util::DivideCeil<u32>(guest->tileConfig.pitch, guestFormat.blockWidth) * guestFormat.bpb : layout.lineSize;
+            layout.unitSize = layout.lineSize;
+        }
+        layout.unitCount = (layout.lineCount + layout.unitLines - 1) / layout.unitLines;
+
+        return layout;
+    }
+
+    const u8 *Texture::GetGuestMemory(const GuestLayout &layout) {
+        auto size{layout.unitCount ? (layout.unitStride * (layout.unitCount - 1)) + layout.unitSize : 0};
+        auto hostSpan{state.process->GetHostSpan(guest->address, size)};
+        if (hostSpan.size() == size)
+            return hostSpan.data();
+
+        guestBuffer.resize(size);
+        for (size_t offset{}; offset < size; offset += hostSpan.size()) {
+            hostSpan = state.process->GetHostSpan(guest->address + offset, size - offset);
+            if (hostSpan.empty()) {
+                state.process->ReadMemory(guestBuffer.data() + offset, guest->address + offset, size - offset); // The rest of the texture isn't backed by host memory
+                break;
+            }
+            std::memcpy(guestBuffer.data() + offset, hostSpan.data(), hostSpan.size());
+        }
+        return guestBuffer.data();
+    }
+
+    void Texture::CopyGuestUnits(const GuestLayout &layout, const u8 *input, u8 *output, size_t outputPitch, size_t begin, size_t end) {
+        auto &guestFormat{guest->format};
+        bool decode{guestFormat.decode && format != guestFormat}; // If the guest format is decoded into the host format rather than being copied directly
+
+        auto firstLine = static_cast<u32>(begin * layout.unitLines);
+        input += begin * layout.unitStride;
+        output += firstLine * (decode ? guestFormat.blockHeight : 1U) * outputPitch;
+        auto lines = std::min<u32>(end * layout.unitLines, layout.lineCount) - firstLine;
+
+        // Decoded formats are first copied into a linear buffer of guest format blocks which is then decoded into the output
+        u8 *linear{output};
+        size_t linearPitch{outputPitch};
+        if (decode) {
+            decodeBuffer.resize(lines * layout.lineSize);
+            linear = decodeBuffer.data();
+            linearPitch = layout.lineSize;
+        }
+
+        if (guest->tileMode == texture::TileMode::Block)
+            texture::CopyBlockLinearToLinear(texture::Dimensions(layout.blockDimensions.width, lines, layout.blockDimensions.depth), guestFormat.bpb, util::DivideCeil<u32>(guest->tileConfig.surfaceWidth, guestFormat.blockWidth), guest->tileConfig.blockHeight, guest->tileConfig.blockDepth, input, linear, linearPitch, &state.gpu->textureWorkers);
+        else
+            texture::CopyPitchLinearToLinear({}, texture::Dimensions(layout.blockDimensions.width, lines), guestFormat.bpb, layout.unitStride, input, linear, linearPitch);
+
+        if (decode) {
+            // The decoders are passed the real size of the texture in texels as they clip the partial blocks at the right and bottom edges
+            auto TexelLines = [&](u32 lineBegin, u32 lineEnd) {
+                auto texelLines = (lineEnd - lineBegin) * guestFormat.blockHeight;
+                if (firstLine + lineEnd == layout.lineCount)
+                    texelLines -= (layout.blockDimensions.height * guestFormat.blockHeight) - dimensions.height;
+                return texelLines;
+            };
+
+            auto &pool{state.gpu->textureWorkers};
+            if (lines > 1 && static_cast<size_t>(lines) * guestFormat.blockHeight * outputPitch >= constant::ParallelDecodeThreshold) {
+                // Block rows are decoded independently of each other so they're split across the pool
+                auto taskCount = std::min<size_t>(lines, pool.GetThreadCount() * 4);
+                pool.ParallelFor(taskCount, [&](size_t task) {
+                    auto lineBegin = (lines * task) / taskCount, lineEnd = (lines * (task + 1)) / taskCount;
+                    guestFormat.decode(linear + (lineBegin * layout.lineSize), output + (lineBegin * guestFormat.blockHeight * outputPitch), dimensions.width, TexelLines(static_cast<u32>(lineBegin), static_cast<u32>(lineEnd)), outputPitch);
+                });
+            } else {
+                guestFormat.decode(linear, output, dimensions.width, TexelLines(0, lines), outputPitch);
+            }
+        }
     }
 
     void Texture::SynchronizeHost() {
-        auto texture = state.process->GetPointer<u8>(guest->address);
         auto size = format.GetSize(dimensions);
-        backing.resize(size);
+        if (backing.size() != size) {
+            backing.resize(size);
+            unitHashes.clear(); // The entire texture needs to be converted again
+        }
         auto output = reinterpret_cast<u8 *>(backing.data());
+        auto outputPitch = format.GetSize(dimensions.width, format.blockHeight);
 
-        if (guest->tileMode == texture::TileMode::Block) {
-            // Reference on Block-linear tiling: https://gist.github.com/PixelyIon/d9c35050af0ef5690566ca9f0965bc32
-            constexpr u8 sectorWidth = 16; // The width of a sector in bytes
-            constexpr u8 sectorHeight = 2; // The height of a sector in lines
-            constexpr u8 gobWidth = 64; // The width of a GOB in bytes
-            constexpr u8 gobHeight = 8; // The height of a GOB in lines
-
-            auto blockHeight = guest->tileConfig.blockHeight; // The height of the blocks in GOBs
-            auto robHeight = gobHeight * blockHeight; // The height of a single ROB (Row of Blocks) in lines
-            auto surfaceHeight = dimensions.height / format.blockHeight; // The height of the surface in lines
-            auto surfaceHeightRobs = util::AlignUp(surfaceHeight, robHeight) / robHeight; // The height of the surface in ROBs (Row Of Blocks)
-            auto robWidthBytes = util::AlignUp((guest->tileConfig.surfaceWidth / format.blockWidth) * format.bpb, gobWidth); // The width of a ROB in bytes
-            auto robWidthBlocks = robWidthBytes / gobWidth; // The width of a ROB in blocks (and GOBs because block width == 1 on the Tegra X1)
-            auto robBytes = robWidthBytes * robHeight; // The size of a ROB in bytes
-            auto gobYOffset = robWidthBytes * gobHeight; // The offset of the next Y-axis GOB from the current one in linear space
-
-            auto inputSector = texture; // The address of the input sector
-            auto outputRob = output; // The address of the output block
-
-            for (u32 rob = 0, y = 0, paddingY = 0; rob < surfaceHeightRobs; rob++) { // Every Surface contains `surfaceHeightRobs` ROBs
-                auto outputBlock = outputRob; // We iterate through a block independently of the ROB
-                for (u32 block = 0; block < robWidthBlocks; block++) { // Every ROB contains `surfaceWidthBlocks` Blocks
-                    auto outputGob = outputBlock; // We iterate through a GOB independently of the block
-                    for (u32 gobY = 0; gobY < blockHeight; gobY++) { // Every Block contains `blockHeight` Y-axis GOBs
-                        for (u32 index = 0; index < sectorWidth * sectorHeight; index++) { // Every Y-axis GOB contains `sectorWidth * sectorHeight` sectors
-                            u32 xT = ((index << 3) & 0b10000) | ((index << 1) & 0b100000); // Morton-Swizzle on the X-axis
-                            u32 yT = ((index >> 1) & 0b110) | (index & 0b1); // Morton-Swizzle on the Y-axis
-                            std::memcpy(outputGob + (yT * robWidthBytes) + xT, inputSector, sectorWidth);
-                            inputSector += sectorWidth; // `sectorWidth` bytes are of sequential image data
-                        }
-                        outputGob += gobYOffset; // Increment the output GOB to the next Y-axis GOB
-                    }
-                    inputSector += paddingY; // Increment the input sector to the next sector
-                    outputBlock += gobWidth; // Increment the output block to the next block (As Block Width = 1 GOB Width)
-                }
-                outputRob += robBytes; // Increment the output block to the next ROB
+        // The guest texture is split into units which can be converted independently of each other, only the units that were modified since the last synchronization are converted
+        auto layout = GetGuestLayout();
+        auto texture = GetGuestMemory(layout);
 
-                y += robHeight; // Increment the Y position to the next ROB
-                blockHeight = static_cast<u8>(std::min(static_cast<u32>(blockHeight), (surfaceHeight - y) / gobHeight)); // Calculate the amount of Y GOBs which aren't padding
-                paddingY = (guest->tileConfig.blockHeight - blockHeight) * (sectorWidth * sectorWidth * sectorHeight); // Calculate the amount of padding between contiguous sectors
-            }
-        } else if (guest->tileMode == texture::TileMode::Pitch) {
-            auto sizeLine = guest->format.GetSize(dimensions.width, 1); // The size of a single line of pixel data
-            auto sizeStride = guest->format.GetSize(guest->tileConfig.pitch, 1); // The size of a single stride of pixel data
+        if (!dirtyTracking) {
+            CopyGuestUnits(layout, texture, output, outputPitch, 0, layout.unitCount);
+            return;
+        }
 
-            auto inputLine = texture; // The address of the input line
-            auto outputLine = output; // The address of the output line
+        if (unitHashes.size() != layout.unitCount) {
+            CopyGuestUnits(layout, texture, output, outputPitch, 0, layout.unitCount);
 
-            for (u32 line = 0; line < dimensions.height; line++) {
-                std::memcpy(outputLine, inputLine, sizeLine);
-                inputLine += sizeStride;
-                outputLine += sizeLine;
+            unitHashes.resize(layout.unitCount);
+            for (size_t unit{}; unit < layout.unitCount; unit++)
+                unitHashes[unit] = HashGuestUnit(texture + (unit * layout.unitStride), layout.unitSize);
+            return;
+        }
+
+        for (size_t unit{}; unit < layout.unitCount;) {
+            auto begin = unit;
+            for (; unit < layout.unitCount; unit++) {
+                auto hash{HashGuestUnit(texture + (unit * layout.unitStride), layout.unitSize)};
+                if (hash == unitHashes[unit])
+                    break;
+                unitHashes[unit] = hash;
             }
-        } else if (guest->tileMode == texture::TileMode::Linear) {
-            std::memcpy(output, texture, size);
+
+            if (unit != begin)
+                CopyGuestUnits(layout, texture, output, outputPitch, begin, unit); // Contiguous modified units are converted together
+            unit++; // The unit which ended the run is unmodified
         }
     }
 
+    void Texture::CopyToLinear(u8 *output, size_t outputPitch) {
+        auto linePitch = format.GetSize(dimensions.width, format.blockHeight);
+        if (!outputPitch)
+            outputPitch = linePitch;
+
+        if (dirtyTracking) {
+            // The backing only needs the modified units to be converted, copying lines out of it is cheaper than converting the entire texture
+            SynchronizeHost();
+            texture::CopyPitchLinearToLinear({}, texture::Dimensions(util::DivideCeil(dimensions.width, format.blockWidth), util::DivideCeil(dimensions.height, format.blockHeight) * dimensions.depth), format.bpb, linePitch, backing.data(), output, outputPitch);
+            return;
+        }
+
+        auto layout = GetGuestLayout();
+        CopyGuestUnits(layout, GetGuestMemory(layout), output, outputPitch, 0, layout.unitCount);
+    }
+
     PresentationTexture::PresentationTexture(const DeviceState &state, const std::shared_ptr<GuestTexture> &guest, const texture::Dimensions &dimensions, const texture::Format &format, const std::function<void()> &releaseCallback) : releaseCallback(releaseCallback), Texture(state, guest, dimensions, format, {}) {}
 
     i32 PresentationTexture::GetAndroidFormat() {
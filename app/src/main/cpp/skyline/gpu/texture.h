@@ -50,6 +50,18 @@ namespace skyline {
                 u16 blockWidth; //!< The width of a single block
                 vk::Format vkFormat; //!< The underlying Vulkan type of the format
 
+                /**
+                 * @brief A function which decodes a linear surface of blocks in this format into RGBA8888 texels
+                 * @param input The linear surface of blocks
+                 * @param output The RGBA8888 surface
+                 * @param width The width of the surface in texels
+                 * @param height The height of the surface in texels
+                 * @param outputPitch The distance between lines of the output in bytes
+                 */
+                using DecodeFunction = void (*)(const u8 *input, u8 *output, u32 width, u32 height, size_t outputPitch);
+
+                DecodeFunction decode{}; //!< The decoder of this format, this is only set for formats which the host might not support such as BCn
+
                 /**
                  * @return If this is a compressed texture format or not
                  */
@@ -64,7 +76,7 @@ namespace skyline {
                  * @return The size of the texture in bytes
                  */
                 inline constexpr size_t GetSize(u32 width, u32 height, u32 depth = 1) {
-                    return (((width / blockWidth) * (height / blockHeight)) * bpb) * depth;
+                    return ((static_cast<size_t>(util::DivideCeil(width, blockWidth)) * util::DivideCeil(height, blockHeight)) * bpb) * depth;
                 }
 
                 /**
@@ -153,7 +165,7 @@ namespace skyline {
 
           public:
             u64 address; //!< The address of the texture in guest memory
-            std::shared_ptr<Texture> host; //!< The corresponding host texture object
+            std::weak_ptr<Texture> host; //!< The corresponding host texture object, this is weak as the host texture holds a strong reference to this object
             texture::Dimensions dimensions; //!< The dimensions of the texture
             texture::Format format; //!< The format of the texture
             texture::TileMode tileMode; //!< The tiling mode of the texture
@@ -173,16 +185,14 @@ namespace skyline {
              * @return A shared pointer to the host texture object
              * @note There can only be one host texture for a corresponding guest texture
              */
-            std::shared_ptr<Texture> InitializeTexture(std::optional<texture::Format> format = std::nullopt, std::optional<texture::Dimensions> dimensions = std::nullopt, texture::Swizzle swizzle = {}) {
-                if (host)
-                    throw exception("Trying to create multiple Texture objects from a single GuestTexture");
-                host = std::make_shared<Texture>(state, shared_from_this(), dimensions ? *dimensions : this->dimensions, format ? *format : this->format, swizzle);
-                return host;
-            }
+            std::shared_ptr<Texture> InitializeTexture(std::optional<texture::Format> format = std::nullopt, std::optional<texture::Dimensions> dimensions = std::nullopt, texture::Swizzle swizzle = {});
 
           protected:
+            /**
+             * @note The PresentationTexture only has a backing with dirty tracking, it's written into the window buffer directly by GPU::Loop otherwise
+             */
             std::shared_ptr<PresentationTexture> InitializePresentationTexture() {
-                if (host)
+                if (!host.expired())
                     throw exception("Trying to create multiple PresentationTexture objects from a single GuestTexture");
                 auto presentation = std::make_shared<PresentationTexture>(state, shared_from_this(), dimensions, format);
                 host = std::static_pointer_cast<Texture>(presentation);
@@ -198,6 +208,41 @@ namespace skyline {
         class Texture {
           private:
             const DeviceState &state; //!< The state of the device
+            bool dirtyTracking; //!< If only the parts of the texture that were modified since the last synchronization are converted
+            std::vector<u64> unitHashes; //!< The hash of every unit of the guest texture at the last synchronization, units with a different hash were modified and are converted again (Only used with dirty tracking)
+            std::vector<u8> decodeBuffer; //!< A buffer which guest textures in a format that needs to be decoded are copied into before they're decoded
+            std::vector<u8> guestBuffer; //!< A buffer which holds a copy of the guest texture when it isn't contiguous in host memory
+
+            /**
+             * @brief This describes how the guest texture is split into units which can be converted independently of each other
+             */
+            struct GuestLayout {
+                texture::Dimensions blockDimensions; //!< The dimensions of the texture in format blocks, partial blocks at the edges are included
+                size_t lineSize; //!< The size of a single line of blocks in the linear texture
+                u32 lineCount; //!< The amount of lines of blocks in the texture
+                u32 unitLines; //!< The amount of lines of blocks in a single unit
+                size_t unitStride; //!< The distance between units in the guest texture
+                size_t unitSize; //!< The size of the guest data that a unit is converted from
+                size_t unitCount; //!< The amount of units in the texture
+            };
+
+            /**
+             * @return The layout of the guest texture, units are ROBs for block-linear textures and lines otherwise
+             */
+            GuestLayout GetGuestLayout();
+
+            /**
+             * @return A pointer to the guest texture in host memory, the texture is gathered into the guest buffer from the host spans that back it if it crosses host mappings
+             */
+            const u8 *GetGuestMemory(const GuestLayout &layout);
+
+            /**
+             * @brief This converts a range of units of the guest texture into a linear texture
+             * @param input The start of the guest texture
+             * @param output The start of the linear texture
+             * @param outputPitch The distance between lines of blocks in the linear texture
+             */
+            void CopyGuestUnits(const GuestLayout &layout, const u8 *input, u8 *output, size_t outputPitch, size_t begin, size_t end);
 
           public:
             std::vector<u8> backing; //!< The object that holds a host copy of the guest texture (Will be replaced with a vk::Image)
@@ -237,9 +282,18 @@ namespace skyline {
 
             /**
              * @brief This synchronizes the host texture with the guest after it has been modified
+             * @note With dirty tracking, only the ROBs (or lines for linear textures) with a different hash from the last synchronization are converted
              */
             void SynchronizeHost();
 
+            /**
+             * @brief This writes the entire texture into a linear buffer, such as a window buffer which needs to be written in full every time
+             * @param output The buffer to write the linear texture into
+             * @param outputPitch The distance between lines of blocks in the output in bytes, this is the width of the texture in bytes if it's 0
+             * @note With dirty tracking, the modified parts of the guest texture are converted into the backing and lines are copied from it, the guest texture is converted straight into the output without an intermediate copy otherwise
+             */
+            void CopyToLinear(u8 *output, size_t outputPitch = 0);
+
             /**
              * @brief This synchronizes the guest texture with the host texture after it has been modified
              */
@@ -252,6 +306,7 @@ namespace skyline {
         class PresentationTexture : public Texture {
           public:
             std::function<void()> releaseCallback; //!< The release callback after this texture has been displayed
+            u32 swapInterval{1}; //!< The amount of vsyncs that need to pass after the previous frame before this texture is displayed, it's displayed immediately if this is 0 (This is guarded by GPU::presentationMutex while the texture is queued)
 
             PresentationTexture(const DeviceState &state, const std::shared_ptr<GuestTexture> &guest, const texture::Dimensions &dimensions, const texture::Format &format, const std::function<void()> &releaseCallback = {});
 
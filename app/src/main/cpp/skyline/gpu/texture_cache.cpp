@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "texture_cache.h"
+
+namespace skyline::gpu {
+    size_t TextureCache::KeyHash::operator()(const Key &key) const {
+        size_t hash{std::hash<u64>{}(key.address)};
+        auto Combine = [&hash](u64 value) {
+            hash ^= std::hash<u64>{}(value) + 0x9E3779B97F4A7C15 + (hash << 6) + (hash >> 2);
+        };
+
+        Combine((static_cast<u64>(key.dimensions.width) << 32) | key.dimensions.height);
+        Combine((static_cast<u64>(key.dimensions.depth) << 32) | static_cast<u32>(key.format));
+        Combine((static_cast<u64>(key.tileMode) << 32) | key.tileConfig);
+        return hash;
+    }
+
+    TextureCache::TextureCache(const DeviceState &state) : state(state) {}
+
+    std::shared_ptr<GuestTexture> TextureCache::GetTexture(u64 address, texture::Dimensions dimensions, texture::Format format, texture::TileMode tileMode, texture::TileConfig tileConfig) {
+        Key key{address, dimensions, format.vkFormat, tileMode, tileConfig.pitch};
+
+        std::lock_guard guard(texturesLock);
+        auto &entry = textures[key];
+        if (auto texture = entry.lock())
+            return texture;
+
+        // Expired entries are only dropped when a new texture is created as that's the only time the cache grows
+        for (auto it = textures.begin(); it != textures.end();) {
+            if (it->second.expired() && &it->second != &entry)
+                it = textures.erase(it);
+            else
+                it++;
+        }
+
+        auto texture = std::make_shared<GuestTexture>(state, address, dimensions, format, tileMode, tileConfig);
+        entry = texture;
+        return texture;
+    }
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <unordered_map>
+#include "format.h"
+
+namespace skyline::gpu {
+    /**
+     * @brief The TextureCache class deduplicates GuestTexture objects so that a guest surface which is bound multiple times is only converted once and can reuse its host texture
+     * @details Textures are keyed by their guest address, dimensions, format and layout, a change in any of these results in a different texture
+     */
+    class TextureCache {
+      private:
+        /**
+         * @brief This holds all the attributes that identify a guest texture
+         */
+        struct Key {
+            u64 address; //!< The address of the texture in guest memory
+            texture::Dimensions dimensions; //!< The dimensions of the texture
+            vk::Format format; //!< The format of the texture
+            texture::TileMode tileMode; //!< The tiling mode of the texture
+            u32 tileConfig; //!< The raw value of the tiling configuration of the texture
+
+            inline bool operator==(const Key &key) const {
+                return address == key.address && dimensions.width == key.dimensions.width && dimensions.height == key.dimensions.height && dimensions.depth == key.dimensions.depth && format == key.format && tileMode == key.tileMode && tileConfig == key.tileConfig;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key &key) const;
+        };
+
+        const DeviceState &state;
+        Mutex texturesLock; //!< This mutex is used to ensure concurrent access to textures is safe
+        std::unordered_map<Key, std::weak_ptr<GuestTexture>, KeyHash> textures; //!< The textures that have been looked up, these are dropped from the cache once nothing else holds them
+
+      public:
+        TextureCache(const DeviceState &state);
+
+        /**
+         * @return The GuestTexture with the specified attributes, this is only created if there isn't an existing one that is still alive
+         */
+        std::shared_ptr<GuestTexture> GetTexture(u64 address, texture::Dimensions dimensions, texture::Format format, texture::TileMode tileMode = texture::TileMode::Linear, texture::TileConfig tileConfig = {});
+
+        /**
+         * @return The GuestTexture with the specified attributes, the format is looked up from the texture format of a Maxwell texture header
+         */
+        std::shared_ptr<GuestTexture> GetTexture(u64 address, texture::Dimensions dimensions, format::TextureFormat format, texture::TileMode tileMode = texture::TileMode::Linear, texture::TileConfig tileConfig = {}) {
+            return GetTexture(address, dimensions, format::GetFormat(format), tileMode, tileConfig);
+        }
+    };
+}
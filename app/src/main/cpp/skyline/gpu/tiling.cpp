@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+#include <nce/guest_common.h>
+#include <thread_pool.h>
+#include "tiling.h"
+
+namespace skyline::gpu::texture {
+    namespace {
+        /**
+         * @param dimensions The dimensions of the base level in texels
+         * @return The dimensions of a mip level in format blocks
+         * @note The texel dimensions are halved before they're rounded up to blocks, a 20 texel wide level of a format with 4 texel wide blocks is 5 blocks wide but its next level is 3 blocks wide rather than 2
+         */
+        Dimensions GetLevelDimensions(Dimensions dimensions, const Format &format, u32 level) {
+            return Dimensions(util::DivideCeil<u32>(std::max(dimensions.width >> level, 1U), format.blockWidth), util::DivideCeil<u32>(std::max(dimensions.height >> level, 1U), format.blockHeight), std::max(dimensions.depth >> level, 1U));
+        }
+
+        /**
+         * @brief The offsets of the first sector of each line of a GOB from the start of the GOB
+         * @details A GOB is made of 32 sectors of 16x2 bytes which are Morton-swizzled, the sector index bits are (from LSB) Y0, X4, Y1, Y2 and X5 so a line of 64 bytes is made of sectors at +0, +32, +256 and +288 from the first sector of the line
+         */
+        constexpr std::array<u16, constant::GobHeight> GobLineOffsets{[] {
+            std::array<u16, constant::GobHeight> offsets{};
+            for (u16 line{}; line < constant::GobHeight; line++)
+                offsets[line] = static_cast<u16>(((line & 0b1) | ((line & 0b110) << 1)) * constant::SectorWidth);
+            return offsets;
+        }()};
+
+        /**
+         * @brief The offsets of the sectors in a line of a GOB from the first sector of the line
+         */
+        constexpr std::array<u16, constant::GobWidth / constant::SectorWidth> GobSectorOffsets{0, 32, 256, 288};
+
+        /**
+         * @brief The type of the pointer to the block-linear surface, this is the input when deswizzling and the output when swizzling
+         */
+        template<bool Deswizzle>
+        using BlockLinearPointer = std::conditional_t<Deswizzle, const u8 *, u8 *>;
+
+        /**
+         * @brief The type of the pointer to the linear surface, this is the output when deswizzling and the input when swizzling
+         */
+        template<bool Deswizzle>
+        using LinearPointer = std::conditional_t<Deswizzle, u8 *, const u8 *>;
+
+        /**
+         * @brief Copies a whole GOB between a block-linear and a linear surface
+         * @tparam Deswizzle If the GOB is copied into the linear surface rather than from it
+         */
+        template<bool Deswizzle>
+        FORCE_INLINE void CopyGob(BlockLinearPointer<Deswizzle> gob, LinearPointer<Deswizzle> linear, size_t pitch) {
+            for (auto lineOffset : GobLineOffsets) {
+                auto line = gob + lineOffset;
+                #ifdef __ARM_NEON
+                if constexpr (Deswizzle) {
+                    uint8x16_t sector0{vld1q_u8(line + GobSectorOffsets[0])}, sector1{vld1q_u8(line + GobSectorOffsets[1])}, sector2{vld1q_u8(line + GobSectorOffsets[2])}, sector3{vld1q_u8(line + GobSectorOffsets[3])};
+                    vst1q_u8(linear, sector0);
+                    vst1q_u8(linear + constant::SectorWidth, sector1);
+                    vst1q_u8(linear + (constant::SectorWidth * 2), sector2);
+                    vst1q_u8(linear + (constant::SectorWidth * 3), sector3);
+                } else {
+                    uint8x16_t sector0{vld1q_u8(linear)}, sector1{vld1q_u8(linear + constant::SectorWidth)}, sector2{vld1q_u8(linear + (constant::SectorWidth * 2))}, sector3{vld1q_u8(linear + (constant::SectorWidth * 3))};
+                    vst1q_u8(line + GobSectorOffsets[0], sector0);
+                    vst1q_u8(line + GobSectorOffsets[1], sector1);
+                    vst1q_u8(line + GobSectorOffsets[2], sector2);
+                    vst1q_u8(line + GobSectorOffsets[3], sector3);
+                }
+                #else
+                for (size_t sector{}; sector < GobSectorOffsets.size(); sector++) {
+                    if constexpr (Deswizzle)
+                        std::memcpy(linear + (sector * constant::SectorWidth), line + GobSectorOffsets[sector], constant::SectorWidth);
+                    else
+                        std::memcpy(line + GobSectorOffsets[sector], linear + (sector * constant::SectorWidth), constant::SectorWidth);
+                }
+                #endif
+                linear += pitch;
+            }
+        }
+
+        /**
+         * @brief Copies a part of a GOB between a block-linear and a linear surface, this is used for GOBs on the edges of a region
+         * @param linear The position of the part in the linear surface
+         * @param x The X-axis position of the part inside of the GOB in bytes
+         * @param y The Y-axis position of the part inside of the GOB in lines
+         * @param width The width of the part in bytes
+         * @param height The height of the part in lines
+         */
+        template<bool Deswizzle>
+        void CopyPartialGob(BlockLinearPointer<Deswizzle> gob, LinearPointer<Deswizzle> linear, size_t pitch, u32 x, u32 y, u32 width, u32 height) {
+            for (u32 line{y}; line < y + height; line++) {
+                auto gobLine = gob + GobLineOffsets[line];
+                for (u32 offset{}; offset < width;) {
+                    u32 gobX{x + offset};
+                    u32 size{std::min<u32>(constant::SectorWidth - (gobX % constant::SectorWidth), width - offset)}; // Copies can't cross sectors as they aren't contiguous
+                    auto sector = gobLine + GobSectorOffsets[gobX / constant::SectorWidth] + (gobX % constant::SectorWidth);
+
+                    if constexpr (Deswizzle)
+                        std::memcpy(linear + offset, sector, size);
+                    else
+                        std::memcpy(sector, linear + offset, size);
+                    offset += size;
+                }
+                linear += pitch;
+            }
+        }
+
+        /**
+         * @brief Copies a region of a block-linear surface to or from a linear one, GOB by GOB in linear order
+         * @tparam Deswizzle If the region is copied into the linear surface rather than from it
+         * @details Every ROB of every slice is independent of the others so large regions are split across the thread pool by ranges of ROBs
+         * @note The bytes per block only determine the bounds of the region in bytes, GOBs are always copied as 64x8 bytes regardless of the format
+         */
+        template<bool Deswizzle>
+        void CopySurface(Dimensions surface, Origin origin, Dimensions region, u32 bpb, u8 blockHeight, u8 blockDepth, BlockLinearPointer<Deswizzle> blockLinear, LinearPointer<Deswizzle> linear, size_t pitch, ThreadPool *pool) {
+            blockHeight = std::max<u8>(blockHeight, 1);
+            blockDepth = std::max<u8>(blockDepth, 1);
+
+            const u32 xBegin{origin.x * bpb}, xEnd{xBegin + (region.width * bpb)}; // The horizontal bounds of the region in bytes
+            const u32 yBegin{origin.y}, yEnd{origin.y + region.height}; // The vertical bounds of the region in lines
+            if (!pitch)
+                pitch = region.width * bpb;
+
+            const size_t blockSize{static_cast<size_t>(constant::GobSize) * blockHeight * blockDepth}; // The size of a block in bytes
+            const size_t robSize{util::DivideCeil(surface.width * bpb, constant::GobWidth) * blockSize}; // The size of a ROB in bytes
+            const u32 robLines{static_cast<u32>(constant::GobHeight) * blockHeight}; // The height of a ROB in lines
+            const size_t sliceSize{util::DivideCeil(surface.height, robLines) * robSize}; // The size of a slice of blocks in bytes, this contains `blockDepth` slices of the surface
+            const size_t linearSliceSize{pitch * region.height};
+
+            const u32 robBegin{yBegin / robLines}, robCount{util::DivideCeil(yEnd, robLines) - robBegin}; // The ROBs which intersect the region
+            const u32 gobYBegin{yBegin / constant::GobHeight}, gobYEnd{util::DivideCeil(yEnd, constant::GobHeight)};
+            const u32 gobXBegin{xBegin / constant::GobWidth}, gobXEnd{util::DivideCeil(xEnd, constant::GobWidth)};
+
+            auto CopyRobs = [&](size_t begin, size_t end) {
+                for (auto index{begin}; index < end; index++) {
+                    u32 z{origin.z + static_cast<u32>(index / robCount)}, rob{robBegin + static_cast<u32>(index % robCount)};
+                    auto blockLinearRob = blockLinear + ((z / blockDepth) * sliceSize) + ((z % blockDepth) * blockHeight * constant::GobSize) + (rob * robSize);
+                    auto linearSlice = linear + ((z - origin.z) * linearSliceSize);
+
+                    for (u32 gobY{std::max(rob * blockHeight, gobYBegin)}, gobYLast{std::min((rob + 1) * blockHeight, gobYEnd)}; gobY < gobYLast; gobY++) {
+                        u32 lineBegin{std::max(gobY * constant::GobHeight, yBegin)}, lineEnd{std::min((gobY + 1) * constant::GobHeight, yEnd)};
+                        auto blockLinearGob = blockLinearRob + ((gobY % blockHeight) * constant::GobSize) + (gobXBegin * blockSize);
+                        auto linearLine = linearSlice + ((lineBegin - yBegin) * pitch);
+
+                        for (u32 gobX{gobXBegin}; gobX < gobXEnd; gobX++) {
+                            u32 byteBegin{std::max(gobX * constant::GobWidth, xBegin)}, byteEnd{std::min((gobX + 1) * constant::GobWidth, xEnd)};
+                            auto linearGob = linearLine + (byteBegin - xBegin);
+
+                            if (byteEnd - byteBegin == constant::GobWidth && lineEnd - lineBegin == constant::GobHeight) [[likely]]
+                                CopyGob<Deswizzle>(blockLinearGob, linearGob, pitch);
+                            else
+                                CopyPartialGob<Deswizzle>(blockLinearGob, linearGob, pitch, byteBegin - (gobX * constant::GobWidth), lineBegin - (gobY * constant::GobHeight), byteEnd - byteBegin, lineEnd - lineBegin);
+
+                            blockLinearGob += blockSize; // Blocks are a single GOB wide so the next GOB on the X-axis is in the next block
+                        }
+                    }
+                }
+            };
+
+            size_t robTotal{static_cast<size_t>(robCount) * region.depth};
+            if (pool && robTotal > 1 && (linearSliceSize * region.depth) >= constant::ParallelDeswizzleThreshold) {
+                // More tasks than threads are used so that threads which get descheduled don't hold up the others
+                auto taskCount = std::min(robTotal, pool->GetThreadCount() * 4);
+                pool->ParallelFor(taskCount, [&](size_t task) {
+                    CopyRobs((robTotal * task) / taskCount, (robTotal * (task + 1)) / taskCount);
+                });
+            } else {
+                CopyRobs(0, robTotal);
+            }
+        }
+
+        /**
+         * @brief Copies every mip level of every array layer of a texture between block-linear and linear layouts
+         */
+        template<bool Deswizzle>
+        void CopyTexture(Dimensions dimensions, const Format &format, u8 blockHeight, u8 blockDepth, u32 levelCount, u32 layerCount, BlockLinearPointer<Deswizzle> blockLinear, LinearPointer<Deswizzle> linear, ThreadPool *pool) {
+            blockHeight = std::max<u8>(blockHeight, 1);
+            blockDepth = std::max<u8>(blockDepth, 1);
+            auto bpb{format.bpb};
+            auto layerSize = GetBlockLinearLayerSize(dimensions, format, blockHeight, blockDepth, levelCount);
+
+            for (u32 layer{}; layer < layerCount; layer++) {
+                auto blockLinearLevel = blockLinear + (layer * layerSize);
+                for (u32 level{}; level < levelCount; level++) {
+                    auto levelDimensions = GetLevelDimensions(dimensions, format, level);
+                    u8 levelBlockHeight{blockHeight}, levelBlockDepth{blockDepth};
+                    GetBlockLinearLevelBlockSize(levelDimensions, levelBlockHeight, levelBlockDepth);
+
+                    CopySurface<Deswizzle>(levelDimensions, {}, levelDimensions, bpb, levelBlockHeight, levelBlockDepth, blockLinearLevel, linear, 0, pool);
+
+                    blockLinearLevel += GetBlockLinearLevelSize(levelDimensions, bpb, levelBlockHeight, levelBlockDepth);
+                    linear += static_cast<size_t>(levelDimensions.width) * levelDimensions.height * levelDimensions.depth * bpb;
+                }
+            }
+        }
+    }
+
+    size_t GetBlockLinearLevelSize(Dimensions dimensions, u8 bpb, u8 blockHeight, u8 blockDepth) {
+        auto widthGobs = util::DivideCeil(dimensions.width * bpb, constant::GobWidth);
+        auto heightBlocks = util::DivideCeil(util::DivideCeil(dimensions.height, constant::GobHeight), blockHeight);
+        auto depthBlocks = util::DivideCeil(dimensions.depth, blockDepth);
+        return static_cast<size_t>(widthGobs) * heightBlocks * depthBlocks * constant::GobSize * blockHeight * blockDepth;
+    }
+
+    void GetBlockLinearLevelBlockSize(Dimensions dimensions, u8 &blockHeight, u8 &blockDepth) {
+        auto heightGobs = util::DivideCeil(dimensions.height, constant::GobHeight);
+        while (blockHeight > 1 && heightGobs <= (blockHeight / 2U))
+            blockHeight /= 2;
+
+        while (blockDepth > 1 && dimensions.depth <= (blockDepth / 2U))
+            blockDepth /= 2;
+    }
+
+    size_t GetBlockLinearLayerSize(Dimensions dimensions, const Format &format, u8 blockHeight, u8 blockDepth, u32 levelCount) {
+        size_t size{};
+        for (u32 level{}; level < levelCount; level++) {
+            auto levelDimensions = GetLevelDimensions(dimensions, format, level);
+            u8 levelBlockHeight{blockHeight}, levelBlockDepth{blockDepth};
+            GetBlockLinearLevelBlockSize(levelDimensions, levelBlockHeight, levelBlockDepth);
+            size += GetBlockLinearLevelSize(levelDimensions, format.bpb, levelBlockHeight, levelBlockDepth);
+        }
+
+        // Array layers are aligned to the size of a block of the base level
+        u8 baseBlockHeight{blockHeight}, baseBlockDepth{blockDepth};
+        GetBlockLinearLevelBlockSize(GetLevelDimensions(dimensions, format, 0), baseBlockHeight, baseBlockDepth);
+        size_t blockSize{static_cast<size_t>(constant::GobSize) * baseBlockHeight * baseBlockDepth};
+        return ((size + blockSize - 1) / blockSize) * blockSize;
+    }
+
+    void CopyBlockLinearToLinear(Dimensions dimensions, u8 bpb, u32 surfaceWidth, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t outputPitch, ThreadPool *pool) {
+        CopySurface<true>(Dimensions(surfaceWidth, dimensions.height, dimensions.depth), {}, dimensions, bpb, blockHeight, blockDepth, input, output, outputPitch, pool);
+    }
+
+    void CopyBlockLinearToLinear(Dimensions surface, Origin origin, Dimensions region, u8 bpb, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t outputPitch, ThreadPool *pool) {
+        CopySurface<true>(surface, origin, region, bpb, blockHeight, blockDepth, input, output, outputPitch, pool);
+    }
+
+    void CopyLinearToBlockLinear(Dimensions dimensions, u8 bpb, u32 surfaceWidth, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t inputPitch, ThreadPool *pool) {
+        CopySurface<false>(Dimensions(surfaceWidth, dimensions.height, dimensions.depth), {}, dimensions, bpb, blockHeight, blockDepth, output, input, inputPitch, pool);
+    }
+
+    void CopyLinearToBlockLinear(Dimensions surface, Origin origin, Dimensions region, u8 bpb, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t inputPitch, ThreadPool *pool) {
+        CopySurface<false>(surface, origin, region, bpb, blockHeight, blockDepth, output, input, inputPitch, pool);
+    }
+
+    void CopyBlockLinearToLinear(Dimensions dimensions, const Format &format, u8 blockHeight, u8 blockDepth, u32 levelCount, u32 layerCount, const u8 *input, u8 *output, ThreadPool *pool) {
+        CopyTexture<true>(dimensions, format, blockHeight, blockDepth, levelCount, layerCount, input, output, pool);
+    }
+
+    void CopyLinearToBlockLinear(Dimensions dimensions, const Format &format, u8 blockHeight, u8 blockDepth, u32 levelCount, u32 layerCount, const u8 *input, u8 *output, ThreadPool *pool) {
+        CopyTexture<false>(dimensions, format, blockHeight, blockDepth, levelCount, layerCount, output, input, pool);
+    }
+
+    void CopyPitchLinearToLinear(Origin origin, Dimensions region, u8 bpb, size_t inputPitch, const u8 *input, u8 *output, size_t outputPitch) {
+        size_t lineSize{static_cast<size_t>(region.width) * bpb};
+        if (!outputPitch)
+            outputPitch = lineSize;
+
+        input += (origin.y * inputPitch) + (origin.x * bpb);
+        if (inputPitch == lineSize && outputPitch == lineSize) {
+            std::memcpy(output, input, lineSize * region.height);
+            return;
+        }
+
+        for (u32 line{}; line < region.height; line++, input += inputPitch, output += outputPitch)
+            std::memcpy(output, input, lineSize);
+    }
+
+    void CopyLinearToPitchLinear(Origin origin, Dimensions region, u8 bpb, size_t outputPitch, const u8 *input, u8 *output, size_t inputPitch) {
+        size_t lineSize{static_cast<size_t>(region.width) * bpb};
+        if (!inputPitch)
+            inputPitch = lineSize;
+
+        output += (origin.y * outputPitch) + (origin.x * bpb);
+        if (inputPitch == lineSize && outputPitch == lineSize) {
+            std::memcpy(output, input, lineSize * region.height);
+            return;
+        }
+
+        for (u32 line{}; line < region.height; line++, input += inputPitch, output += outputPitch)
+            std::memcpy(output, input, lineSize);
+    }
+}
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "texture.h"
+
+namespace skyline {
+    namespace constant {
+        constexpr u8 SectorWidth = 16; //!< The width of a sector in bytes
+        constexpr u8 SectorHeight = 2; //!< The height of a sector in lines
+        constexpr u8 GobWidth = 64; //!< The width of a GOB in bytes
+        constexpr u8 GobHeight = 8; //!< The height of a GOB in lines
+        constexpr u16 GobSize = GobWidth * GobHeight; //!< The size of a GOB in bytes
+        constexpr size_t ParallelDeswizzleThreshold = 0x100000; //!< The size of a surface in bytes from which its conversion is split across a thread pool, smaller surfaces aren't worth the synchronization
+        constexpr size_t ParallelDecodeThreshold = 0x40000; //!< The size of a decoded surface in bytes from which its decoding is split across a thread pool, this is lower than the deswizzle threshold as decoding is far more expensive per byte
+    }
+
+    class ThreadPool;
+
+    /**
+     * @brief This namespace holds functions to convert between block-linear, pitch-linear and linear textures in both directions
+     * @note Reference on Block-linear tiling: https://gist.github.com/PixelyIon/d9c35050af0ef5690566ca9f0965bc32
+     */
+    namespace gpu::texture {
+        /**
+         * @brief This is used to hold the position of a region inside of a surface
+         */
+        struct Origin {
+            u32 x{}; //!< The X-axis position of the region in format blocks
+            u32 y{}; //!< The Y-axis position of the region in format blocks
+            u32 z{}; //!< The Z-axis position of the region in slices
+        };
+
+        /**
+         * @param dimensions The dimensions of the mip level in format blocks
+         * @param bpb The bytes per format block
+         * @param blockHeight The height of the blocks of the level in GOBs
+         * @param blockDepth The depth of the blocks of the level in GOBs
+         * @return The size of a single block-linear mip level in bytes
+         */
+        size_t GetBlockLinearLevelSize(Dimensions dimensions, u8 bpb, u8 blockHeight, u8 blockDepth);
+
+        /**
+         * @brief Calculates the block height and depth of a mip level, smaller levels use smaller blocks once a block would be more than twice the size of the level
+         * @param dimensions The dimensions of the mip level in format blocks
+         * @param blockHeight The height of the blocks of the base level in GOBs, this is replaced with the height for the mip level
+         * @param blockDepth The depth of the blocks of the base level in GOBs, this is replaced with the depth for the mip level
+         */
+        void GetBlockLinearLevelBlockSize(Dimensions dimensions, u8 &blockHeight, u8 &blockDepth);
+
+        /**
+         * @param dimensions The dimensions of the base level in texels, the dimensions of the mip levels are derived from these before they're rounded up to format blocks
+         * @return The size of a single array layer including all of its mip levels in bytes
+         */
+        size_t GetBlockLinearLayerSize(Dimensions dimensions, const Format &format, u8 blockHeight, u8 blockDepth, u32 levelCount);
+
+        /**
+         * @brief Copies a single mip level of a block-linear surface into a linear one
+         * @param dimensions The dimensions of the region to copy in format blocks, this starts at the origin of the surface
+         * @param bpb The bytes per format block
+         * @param surfaceWidth The width of the block-linear surface in format blocks, this determines the width of a ROB (Row Of Blocks) and can be larger than the copied region
+         * @param blockHeight The height of the blocks in GOBs
+         * @param blockDepth The depth of the blocks in GOBs
+         * @param input The block-linear surface
+         * @param output The linear surface
+         * @param outputPitch The distance between lines of the linear surface in bytes, this is the width of the region in bytes if it's 0
+         * @param pool A thread pool to split the copy across by ROBs, this is only used for surfaces larger than constant::ParallelDeswizzleThreshold
+         */
+        void CopyBlockLinearToLinear(Dimensions dimensions, u8 bpb, u32 surfaceWidth, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t outputPitch = 0, ThreadPool *pool = nullptr);
+
+        /**
+         * @brief Copies a region of a single mip level of a block-linear surface into a linear one
+         * @param surface The dimensions of the entire block-linear mip level in format blocks
+         * @param origin The position of the region inside of the block-linear surface
+         * @param region The dimensions of the region to copy in format blocks, this must be inside of the surface
+         * @param output The linear surface, this only contains the region
+         */
+        void CopyBlockLinearToLinear(Dimensions surface, Origin origin, Dimensions region, u8 bpb, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t outputPitch = 0, ThreadPool *pool = nullptr);
+
+        /**
+         * @brief Copies a linear surface into a single mip level of a block-linear one, this is the inverse of CopyBlockLinearToLinear
+         * @param inputPitch The distance between lines of the linear surface in bytes, this is the width of the region in bytes if it's 0
+         * @note Parts of GOBs outside of the copied region are left untouched
+         */
+        void CopyLinearToBlockLinear(Dimensions dimensions, u8 bpb, u32 surfaceWidth, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t inputPitch = 0, ThreadPool *pool = nullptr);
+
+        /**
+         * @brief Copies a linear surface into a region of a single mip level of a block-linear one
+         * @param input The linear surface, this only contains the region
+         */
+        void CopyLinearToBlockLinear(Dimensions surface, Origin origin, Dimensions region, u8 bpb, u8 blockHeight, u8 blockDepth, const u8 *input, u8 *output, size_t inputPitch = 0, ThreadPool *pool = nullptr);
+
+        /**
+         * @brief Copies every mip level of every array layer of a block-linear texture into a linear one
+         * @param dimensions The dimensions of the base level in texels
+         * @param blockHeight The height of the blocks of the base level in GOBs
+         * @param blockDepth The depth of the blocks of the base level in GOBs
+         * @param output The linear texture, all levels of a layer are tightly packed after each other followed by the next layer
+         * @param pool A thread pool to split the copies of large levels across
+         */
+        void CopyBlockLinearToLinear(Dimensions dimensions, const Format &format, u8 blockHeight, u8 blockDepth, u32 levelCount, u32 layerCount, const u8 *input, u8 *output, ThreadPool *pool = nullptr);
+
+        /**
+         * @brief Copies every mip level of every array layer of a linear texture into a block-linear one, this is the inverse of CopyBlockLinearToLinear
+         * @param input The linear texture, all levels of a layer are tightly packed after each other followed by the next layer
+         */
+        void CopyLinearToBlockLinear(Dimensions dimensions, const Format &format, u8 blockHeight, u8 blockDepth, u32 levelCount, u32 layerCount, const u8 *input, u8 *output, ThreadPool *pool = nullptr);
+
+        /**
+         * @brief Copies a region of a pitch-linear surface into a linear one
+         * @param origin The position of the region inside of the pitch-linear surface, pitch-linear surfaces are always 2D so the Z-axis is ignored
+         * @param region The dimensions of the region to copy in format blocks
+         * @param inputPitch The distance between lines of the pitch-linear surface in bytes
+         * @param outputPitch The distance between lines of the linear surface in bytes, this is the width of the region in bytes if it's 0
+         */
+        void CopyPitchLinearToLinear(Origin origin, Dimensions region, u8 bpb, size_t inputPitch, const u8 *input, u8 *output, size_t outputPitch = 0);
+
+        /**
+         * @brief Copies a linear surface into a region of a pitch-linear one, this is the inverse of CopyPitchLinearToLinear
+         * @param outputPitch The distance between lines of the pitch-linear surface in bytes
+         * @param inputPitch The distance between lines of the linear surface in bytes, this is the width of the region in bytes if it's 0
+         */
+        void CopyLinearToPitchLinear(Origin origin, Dimensions region, u8 bpb, size_t outputPitch, const u8 *input, u8 *output, size_t inputPitch = 0);
+    }
+}
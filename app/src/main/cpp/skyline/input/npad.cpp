@@ -2,6 +2,7 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <input.h>
+#include <jvm.h>
 #include "npad.h"
 
 namespace skyline::input {
@@ -11,7 +12,202 @@ namespace skyline::input {
          {*this, hid->npad[4], NpadId::Player5}, {*this, hid->npad[5], NpadId::Player6},
          {*this, hid->npad[6], NpadId::Player7}, {*this, hid->npad[7], NpadId::Player8},
          {*this, hid->npad[8], NpadId::Unknown}, {*this, hid->npad[9], NpadId::Handheld},
-        } {}
+        } {
+        samplerThread = std::thread(&NpadManager::SamplerLoop, this);
+        vibrationThread = std::thread(&NpadManager::VibrationLoop, this);
+    }
+
+    NpadManager::~NpadManager() {
+        samplerExit = true;
+        if (samplerThread.joinable())
+            samplerThread.join();
+
+        {
+            std::lock_guard guard(vibrationMutex);
+            vibrationExit = true;
+        }
+        vibrationCondition.notify_all();
+        if (vibrationThread.joinable())
+            vibrationThread.join();
+    }
+
+    struct VibrationInfo {
+        jlong period;
+        jint amplitude;
+        jlong start;
+        jlong end;
+
+        VibrationInfo(float frequency, float amplitude) : period(constant::MsInSecond / frequency), amplitude(amplitude), start(0), end(period) {}
+    };
+
+    template<size_t Size>
+    void VibrateDevice(const std::shared_ptr<JvmManager> &jvm, i8 index, std::array<VibrationInfo, Size> vibrations) {
+        jlong totalTime{};
+        std::sort(vibrations.begin(), vibrations.end(), [](const VibrationInfo &a, const VibrationInfo &b) {
+            return a.period < b.period;
+        });
+
+        jint totalAmplitude{};
+        for (const auto &vibration : vibrations)
+            totalAmplitude += vibration.amplitude;
+
+        // If this vibration is essentially null then we don't play rather clear any running vibrations
+        if (totalAmplitude == 0 || vibrations.back().period == 0) {
+            jvm->ClearVibrationDevice(index);
+            return;
+        }
+
+        // We output an approximation of the combined + linearized vibration data into these arrays, larger arrays would allow for more accurate reproduction of data
+        std::array<jlong, 50> timings;
+        std::array<jint, 50> amplitudes;
+
+        // We are essentially unrolling the bands into a linear sequence, due to the data not being always linearizable there will be inaccuracies at the ends unless there's a pattern that's repeatable which will happen when all band's frequencies are factors of each other
+        u8 i{};
+        for (; i < timings.size(); i++) {
+            jlong time{};
+
+            u8 startCycleCount{};
+            for (u8 n{}; n < vibrations.size(); n++) {
+                auto &vibration = vibrations[n];
+                if (totalTime <= vibration.start) {
+                    vibration.start = vibration.end + vibration.period;
+                    totalAmplitude += vibration.amplitude;
+                    time = std::max(vibration.period, time);
+                    startCycleCount++;
+                } else if (totalTime <= vibration.start) {
+                    vibration.end = vibration.start + vibration.period;
+                    totalAmplitude -= vibration.amplitude;
+                    time = std::max(vibration.period, time);
+                }
+            }
+
+            // If all bands start again at this point then we can end the pattern here as a loop to the front will be flawless
+            if (i && startCycleCount == vibrations.size())
+                break;
+
+            timings[i] = time;
+            totalTime += time;
+
+            amplitudes[i] = std::min(totalAmplitude, constant::AmplitudeMax);
+        }
+
+        jvm->VibrateDevice(index, std::span(timings.begin(), timings.begin() + i), std::span(amplitudes.begin(), amplitudes.begin() + i));
+    }
+
+    void VibrateDevice(const std::shared_ptr<JvmManager> &jvm, i8 index, const NpadVibrationRequest &request) {
+        if (request.right) {
+            const auto &left{request.left};
+            const auto &right{*request.right};
+            std::array<VibrationInfo, 4> vibrations{
+                VibrationInfo{left.frequencyLow, left.amplitudeLow * (constant::AmplitudeMax / 4)},
+                {left.frequencyHigh, left.amplitudeHigh * (constant::AmplitudeMax / 4)},
+                {right.frequencyLow, right.amplitudeLow * (constant::AmplitudeMax / 4)},
+                {right.frequencyHigh, right.amplitudeHigh * (constant::AmplitudeMax / 4)},
+            };
+            VibrateDevice<4>(jvm, index, vibrations);
+        } else {
+            const auto &value{request.left};
+            std::array<VibrationInfo, 2> vibrations{
+                VibrationInfo{value.frequencyLow, value.amplitudeLow * (constant::AmplitudeMax / 2)},
+                {value.frequencyHigh, value.amplitudeHigh * (constant::AmplitudeMax / 2)},
+            };
+            VibrateDevice<2>(jvm, index, vibrations);
+        }
+    }
+
+    void NpadManager::VibrationLoop() {
+        pthread_setname_np(pthread_self(), "HidVibration");
+
+        auto jvm{state.jvm};
+        jvm->AttachThread();
+
+        std::unique_lock lock(vibrationMutex);
+        while (!vibrationExit) {
+            auto now{util::GetTimeNs()};
+            auto wakeup{std::numeric_limits<u64>::max()};
+            bool dispatched{};
+
+            for (size_t index{}; index < vibrationSlots.size(); index++) {
+                auto &slot{vibrationSlots[index]};
+                if (!slot.pending)
+                    continue;
+
+                if (slot.pending == slot.current) {
+                    slot.pending.reset();
+                    continue;
+                }
+
+                if (now < slot.lastUpdate + constant::VibrationUpdatePeriod) {
+                    wakeup = std::min(wakeup, slot.lastUpdate + constant::VibrationUpdatePeriod);
+                    continue;
+                }
+
+                auto request{*slot.pending};
+                slot.pending.reset();
+                slot.current = request;
+                slot.lastUpdate = now;
+
+                lock.unlock();
+                VibrateDevice(jvm, static_cast<i8>(index), request);
+                lock.lock();
+                dispatched = true;
+            }
+
+            // Any requests which were queued while the lock was released need to be checked again before waiting
+            if (dispatched)
+                continue;
+
+            if (wakeup == std::numeric_limits<u64>::max())
+                vibrationCondition.wait(lock);
+            else
+                vibrationCondition.wait_for(lock, std::chrono::nanoseconds(wakeup - now));
+        }
+        lock.unlock();
+
+        jvm->DetachThread();
+    }
+
+    void NpadManager::QueueVibration(i8 index, const NpadVibrationRequest &request) {
+        if (index < 0 || static_cast<size_t>(index) >= vibrationSlots.size())
+            return;
+
+        {
+            std::lock_guard guard(vibrationMutex);
+            vibrationSlots[index].pending = request;
+        }
+        vibrationCondition.notify_one();
+    }
+
+    void NpadManager::SamplerLoop() {
+        pthread_setname_np(pthread_self(), "HidSampler");
+
+        timespec time{};
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        u64 deadline{(static_cast<u64>(time.tv_sec) * constant::NsInSecond) + static_cast<u64>(time.tv_nsec)};
+
+        while (!samplerExit) {
+            deadline += constant::NpadSamplingPeriod;
+            timespec deadlineTime{
+                .tv_sec = static_cast<time_t>(deadline / constant::NsInSecond),
+                .tv_nsec = static_cast<long>(deadline % constant::NsInSecond),
+            };
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadlineTime, nullptr) == EINTR);
+
+            // Samples that were missed are skipped rather than written in a burst which would flush the ring of entries
+            clock_gettime(CLOCK_MONOTONIC, &time);
+            u64 now{(static_cast<u64>(time.tv_sec) * constant::NsInSecond) + static_cast<u64>(time.tv_nsec)};
+            if (now > deadline + constant::NpadSamplingPeriod)
+                deadline += ((now - deadline) / constant::NpadSamplingPeriod) * constant::NpadSamplingPeriod;
+
+            std::lock_guard guard(mutex);
+            if (!activated)
+                continue;
+
+            for (auto &npad : npads)
+                npad.Sample();
+            samplingNumber++;
+        }
+    }
 
     void NpadManager::Update() {
         std::lock_guard guard(mutex);
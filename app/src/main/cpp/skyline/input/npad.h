@@ -22,9 +22,37 @@ namespace skyline::input {
       private:
         const DeviceState &state;
         bool activated{false}; //!< If this NpadManager is activated or not
+        u64 samplingNumber{}; //!< An incrementing sample counter that's common across all NPads, this is used as the global timestamp of entries
+        std::thread samplerThread; //!< The thread which samples pending host input into shared memory at a fixed rate
+        std::atomic<bool> samplerExit{}; //!< If the sampler thread should exit
+
+        /**
+         * @brief The state of vibration for a single host controller
+         */
+        struct VibrationSlot {
+            std::optional<NpadVibrationRequest> pending; //!< The latest request which hasn't been sent to the host yet, this replaces any older pending request
+            std::optional<NpadVibrationRequest> current; //!< The request which was last sent to the host
+            u64 lastUpdate{}; //!< The time at which the last request was sent to the host in nanoseconds
+        };
+
+        std::array<VibrationSlot, constant::ControllerCount> vibrationSlots; //!< The vibration state of every host controller, this is indexed by the index of the host controller
+        std::mutex vibrationMutex; //!< Synchronizes all accesses to vibrationSlots and vibrationExit
+        std::condition_variable vibrationCondition; //!< Signalled when a request is queued or the vibration thread should exit
+        std::thread vibrationThread; //!< The thread which sends vibration requests to the host, this keeps the JNI calls off guest threads
+        bool vibrationExit{}; //!< If the vibration thread should exit
 
         friend NpadDevice;
 
+        /**
+         * @brief The entry point of the sampler thread, this writes a single entry for every connected NPad each sampling period regardless of how many host input events occurred
+         */
+        void SamplerLoop();
+
+        /**
+         * @brief The entry point of the vibration thread, this sends pending vibration requests to the host while skipping any that are identical to the current vibration and rate-limiting updates to constant::VibrationUpdatePeriod
+         */
+        void VibrationLoop();
+
         /**
          * @brief This translates an NPad's ID into it's index in the array
          * @param id The ID of the NPad to translate
@@ -54,6 +82,8 @@ namespace skyline::input {
          */
         NpadManager(const DeviceState &state, input::HidSharedMemory *hid);
 
+        ~NpadManager();
+
         /**
          * @return A reference to the NPad with the specified ID
          */
@@ -83,5 +113,12 @@ namespace skyline::input {
          * @brief This disables any activate mappings from guest controllers -> players till Activate has been called
          */
         void Deactivate();
+
+        /**
+         * @brief This queues a vibration request for a host controller, it replaces any request for the same controller that hasn't been sent yet
+         * @param index The index of the host controller
+         * @note This doesn't block on the host as the request is sent by the vibration thread
+         */
+        void QueueVibration(i8 index, const NpadVibrationRequest &request);
     };
 }
@@ -1,7 +1,6 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
-#include <jvm.h>
 #include "npad_device.h"
 #include "npad.h"
 
@@ -142,9 +141,17 @@ namespace skyline::input {
         type = newType;
         controllerInfo = &GetControllerInfo();
 
+        pending.buttons = 0;
+        pending.defaultButtons = 0;
+        pending.latchedButtons = 0;
+        pending.latchedDefaultButtons = 0;
+        for (auto &axis : pending.axes)
+            axis = 0;
+        for (auto &axis : pending.defaultAxes)
+            axis = 0;
+
         GetNextEntry(*controllerInfo);
         GetNextEntry(section.defaultController);
-        globalTimestamp++;
 
         updateEvent->Signal();
     }
@@ -154,7 +161,6 @@ namespace skyline::input {
             return;
 
         section = {};
-        globalTimestamp = 0;
 
         index = -1;
         partnerIndex = -1;
@@ -191,7 +197,7 @@ namespace skyline::input {
 
         auto &entry = info.state.at(info.header.currentEntry);
 
-        entry.globalTimestamp = globalTimestamp;
+        entry.globalTimestamp = manager.samplingNumber;
         entry.localTimestamp = lastEntry.localTimestamp + 1;
         entry.buttons = lastEntry.buttons;
         entry.leftX = lastEntry.leftX;
@@ -203,16 +209,48 @@ namespace skyline::input {
         return entry;
     }
 
-    void NpadDevice::SetButtonState(NpadButton mask, bool pressed) {
+    void NpadDevice::WriteEntry(NpadControllerInfo &info, u64 buttons, const std::array<std::atomic<i32>, 4> &axes) {
+        constexpr i32 threshold = std::numeric_limits<i16>::max() / 2; // A 50% deadzone for the stick buttons
+
+        auto &entry = GetNextEntry(info);
+
+        entry.leftX = axes[static_cast<size_t>(NpadAxisId::LX)].load(std::memory_order_relaxed);
+        entry.leftY = axes[static_cast<size_t>(NpadAxisId::LY)].load(std::memory_order_relaxed);
+        entry.rightX = axes[static_cast<size_t>(NpadAxisId::RX)].load(std::memory_order_relaxed);
+        entry.rightY = axes[static_cast<size_t>(NpadAxisId::RY)].load(std::memory_order_relaxed);
+
+        entry.buttons.raw = buttons;
+        entry.buttons.leftStickLeft = entry.leftX <= -threshold;
+        entry.buttons.leftStickRight = entry.leftX >= threshold;
+        entry.buttons.leftStickUp = entry.leftY >= threshold;
+        entry.buttons.leftStickDown = entry.leftY <= -threshold;
+        entry.buttons.rightStickLeft = entry.rightX <= -threshold;
+        entry.buttons.rightStickRight = entry.rightX >= threshold;
+        entry.buttons.rightStickUp = entry.rightY >= threshold;
+        entry.buttons.rightStickDown = entry.rightY <= -threshold;
+    }
+
+    void NpadDevice::Sample() {
         if (!connectionState.connected)
             return;
 
-        auto &entry = GetNextEntry(*controllerInfo);
+        // A press that's released before the next sample would be missed by the guest entirely, so presses are latched till they've been sampled once
+        auto latchedButtons{pending.latchedButtons.exchange(0, std::memory_order_relaxed)};
+        auto latchedDefaultButtons{pending.latchedDefaultButtons.exchange(0, std::memory_order_relaxed)};
+        WriteEntry(*controllerInfo, pending.buttons.load(std::memory_order_relaxed) | latchedButtons, pending.axes);
+        WriteEntry(section.defaultController, pending.defaultButtons.load(std::memory_order_relaxed) | latchedDefaultButtons, pending.defaultAxes);
+    }
 
-        if (pressed)
-            entry.buttons.raw |= mask.raw;
-        else
-            entry.buttons.raw &= ~mask.raw;
+    void NpadDevice::SetButtonState(NpadButton mask, bool pressed) {
+        if (!connectionState.connected)
+            return;
+
+        if (pressed) {
+            pending.buttons.fetch_or(mask.raw, std::memory_order_relaxed);
+            pending.latchedButtons.fetch_or(mask.raw, std::memory_order_relaxed);
+        } else {
+            pending.buttons.fetch_and(~mask.raw, std::memory_order_relaxed);
+        }
 
         if (manager.orientation == NpadJoyOrientation::Horizontal && (type == NpadControllerType::JoyconLeft || type == NpadControllerType::JoyconRight)) {
             NpadButton orientedMask{};
@@ -247,180 +285,39 @@ namespace skyline::input {
             mask = orientedMask;
         }
 
-        auto &defaultEntry = GetNextEntry(section.defaultController);
-        if (pressed)
-            defaultEntry.buttons.raw |= mask.raw;
-        else
-            defaultEntry.buttons.raw &= ~mask.raw;
-
-        globalTimestamp++;
+        if (pressed) {
+            pending.defaultButtons.fetch_or(mask.raw, std::memory_order_relaxed);
+            pending.latchedDefaultButtons.fetch_or(mask.raw, std::memory_order_relaxed);
+        } else {
+            pending.defaultButtons.fetch_and(~mask.raw, std::memory_order_relaxed);
+        }
     }
 
     void NpadDevice::SetAxisValue(NpadAxisId axis, i32 value) {
         if (!connectionState.connected)
             return;
 
-        auto &controllerEntry = GetNextEntry(*controllerInfo);
-        auto &defaultEntry = GetNextEntry(section.defaultController);
-
-        constexpr i16 threshold = std::numeric_limits<i16>::max() / 2; // A 50% deadzone for the stick buttons
+        pending.defaultAxes[static_cast<size_t>(axis)].store(value, std::memory_order_relaxed);
 
         if (manager.orientation == NpadJoyOrientation::Vertical || (type != NpadControllerType::JoyconLeft && type != NpadControllerType::JoyconRight)) {
-            switch (axis) {
-                case NpadAxisId::LX:
-                    controllerEntry.leftX = value;
-                    defaultEntry.leftX = value;
-
-                    controllerEntry.buttons.leftStickLeft = controllerEntry.leftX <= -threshold;
-                    defaultEntry.buttons.leftStickLeft = controllerEntry.buttons.leftStickLeft;
-
-                    controllerEntry.buttons.leftStickRight = controllerEntry.leftX >= threshold;
-                    defaultEntry.buttons.leftStickRight = controllerEntry.buttons.leftStickRight;
-                    break;
-                case NpadAxisId::LY:
-                    controllerEntry.leftY = value;
-                    defaultEntry.leftY = value;
-
-                    defaultEntry.buttons.leftStickUp = controllerEntry.buttons.leftStickUp;
-                    controllerEntry.buttons.leftStickUp = controllerEntry.leftY >= threshold;
-
-                    controllerEntry.buttons.leftStickDown = controllerEntry.leftY <= -threshold;
-                    defaultEntry.buttons.leftStickDown = controllerEntry.buttons.leftStickDown;
-                    break;
-                case NpadAxisId::RX:
-                    controllerEntry.rightX = value;
-                    defaultEntry.rightX = value;
-
-                    controllerEntry.buttons.rightStickLeft = controllerEntry.rightX <= -threshold;
-                    defaultEntry.buttons.rightStickLeft = controllerEntry.buttons.rightStickLeft;
-
-                    controllerEntry.buttons.rightStickRight = controllerEntry.rightX >= threshold;
-                    defaultEntry.buttons.rightStickRight = controllerEntry.buttons.rightStickRight;
-                    break;
-                case NpadAxisId::RY:
-                    controllerEntry.rightY = value;
-                    defaultEntry.rightY = value;
-
-                    controllerEntry.buttons.rightStickUp = controllerEntry.rightY >= threshold;
-                    defaultEntry.buttons.rightStickUp = controllerEntry.buttons.rightStickUp;
-
-                    controllerEntry.buttons.rightStickDown = controllerEntry.rightY <= -threshold;
-                    defaultEntry.buttons.rightStickDown = controllerEntry.buttons.rightStickDown;
-                    break;
-            }
+            pending.axes[static_cast<size_t>(axis)].store(value, std::memory_order_relaxed);
         } else {
+            // The sticks of horizontal Joy-Cons are rotated in their own layout
             switch (axis) {
                 case NpadAxisId::LX:
-                    controllerEntry.leftY = value;
-                    controllerEntry.buttons.leftStickUp = controllerEntry.leftY >= threshold;
-                    controllerEntry.buttons.leftStickDown = controllerEntry.leftY <= -threshold;
-
-                    defaultEntry.leftX = value;
-                    defaultEntry.buttons.leftStickLeft = defaultEntry.leftX <= -threshold;
-                    defaultEntry.buttons.leftStickRight = defaultEntry.leftX >= threshold;
+                    pending.axes[static_cast<size_t>(NpadAxisId::LY)].store(value, std::memory_order_relaxed);
                     break;
                 case NpadAxisId::LY:
-                    controllerEntry.leftX = -value;
-                    controllerEntry.buttons.leftStickLeft = controllerEntry.leftX <= -threshold;
-                    controllerEntry.buttons.leftStickRight = controllerEntry.leftX >= threshold;
-
-                    defaultEntry.leftY = value;
-                    defaultEntry.buttons.leftStickUp = defaultEntry.leftY >= threshold;
-                    defaultEntry.buttons.leftStickDown = defaultEntry.leftY <= -threshold;
+                    pending.axes[static_cast<size_t>(NpadAxisId::LX)].store(-value, std::memory_order_relaxed);
                     break;
                 case NpadAxisId::RX:
-                    controllerEntry.rightY = value;
-                    controllerEntry.buttons.rightStickUp = controllerEntry.rightY >= threshold;
-                    controllerEntry.buttons.rightStickDown = controllerEntry.rightY <= -threshold;
-
-                    defaultEntry.rightX = value;
-                    defaultEntry.buttons.rightStickLeft = defaultEntry.rightX <= -threshold;
-                    defaultEntry.buttons.rightStickRight = defaultEntry.rightX >= threshold;
+                    pending.axes[static_cast<size_t>(NpadAxisId::RY)].store(value, std::memory_order_relaxed);
                     break;
                 case NpadAxisId::RY:
-                    controllerEntry.rightX = -value;
-                    controllerEntry.buttons.rightStickLeft = controllerEntry.rightX <= -threshold;
-                    controllerEntry.buttons.rightStickRight = controllerEntry.rightX >= threshold;
-
-                    defaultEntry.rightY = value;
-                    defaultEntry.buttons.rightStickUp = defaultEntry.rightY >= threshold;
-                    defaultEntry.buttons.rightStickDown = defaultEntry.rightY <= -threshold;
+                    pending.axes[static_cast<size_t>(NpadAxisId::RX)].store(-value, std::memory_order_relaxed);
                     break;
             }
         }
-
-        globalTimestamp++;
-    }
-
-    struct VibrationInfo {
-        jlong period;
-        jint amplitude;
-        jlong start;
-        jlong end;
-
-        VibrationInfo(float frequency, float amplitude) : period(constant::MsInSecond / frequency), amplitude(amplitude), start(0), end(period) {}
-    };
-
-    template<size_t Size>
-    void VibrateDevice(const std::shared_ptr<JvmManager> &jvm, i8 index, std::array<VibrationInfo, Size> vibrations) {
-        jlong totalTime{};
-        std::sort(vibrations.begin(), vibrations.end(), [](const VibrationInfo &a, const VibrationInfo &b) {
-            return a.period < b.period;
-        });
-
-        jint totalAmplitude{};
-        for (const auto &vibration : vibrations)
-            totalAmplitude += vibration.amplitude;
-
-        // If this vibration is essentially null then we don't play rather clear any running vibrations
-        if (totalAmplitude == 0 || vibrations[3].period == 0) {
-            jvm->ClearVibrationDevice(index);
-            return;
-        }
-
-        // We output an approximation of the combined + linearized vibration data into these arrays, larger arrays would allow for more accurate reproduction of data
-        std::array<jlong, 50> timings;
-        std::array<jint, 50> amplitudes;
-
-        // We are essentially unrolling the bands into a linear sequence, due to the data not being always linearizable there will be inaccuracies at the ends unless there's a pattern that's repeatable which will happen when all band's frequencies are factors of each other
-        u8 i{};
-        for (; i < timings.size(); i++) {
-            jlong time{};
-
-            u8 startCycleCount{};
-            for (u8 n{}; n < vibrations.size(); n++) {
-                auto &vibration = vibrations[n];
-                if (totalTime <= vibration.start) {
-                    vibration.start = vibration.end + vibration.period;
-                    totalAmplitude += vibration.amplitude;
-                    time = std::max(vibration.period, time);
-                    startCycleCount++;
-                } else if (totalTime <= vibration.start) {
-                    vibration.end = vibration.start + vibration.period;
-                    totalAmplitude -= vibration.amplitude;
-                    time = std::max(vibration.period, time);
-                }
-            }
-
-            // If all bands start again at this point then we can end the pattern here as a loop to the front will be flawless
-            if (i && startCycleCount == vibrations.size())
-                break;
-
-            timings[i] = time;
-            totalTime += time;
-
-            amplitudes[i] = std::min(totalAmplitude, constant::AmplitudeMax);
-        }
-
-        jvm->VibrateDevice(index, std::span(timings.begin(), timings.begin() + i), std::span(amplitudes.begin(), amplitudes.begin() + i));
-    }
-
-    void VibrateDevice(const std::shared_ptr<JvmManager> &jvm, i8 index, const NpadVibrationValue &value) {
-        std::array<VibrationInfo, 2> vibrations{
-            VibrationInfo{value.frequencyLow, value.amplitudeLow * (constant::AmplitudeMax / 2)},
-            {value.frequencyHigh, value.amplitudeHigh * (constant::AmplitudeMax / 2)},
-        };
-        VibrateDevice(jvm, index, vibrations);
     }
 
     void NpadDevice::Vibrate(bool isRight, const NpadVibrationValue &value) {
@@ -432,21 +329,15 @@ namespace skyline::input {
         if (vibrationRight)
             Vibrate(vibrationLeft, *vibrationRight);
         else
-            VibrateDevice(manager.state.jvm, index, value);
+            manager.QueueVibration(index, {value});
     }
 
     void NpadDevice::Vibrate(const NpadVibrationValue &left, const NpadVibrationValue &right) {
         if (partnerIndex == constant::NullIndex) {
-            std::array<VibrationInfo, 4> vibrations{
-                VibrationInfo{left.frequencyLow, left.amplitudeLow * (constant::AmplitudeMax / 4)},
-                {left.frequencyHigh, left.amplitudeHigh * (constant::AmplitudeMax / 4)},
-                {right.frequencyLow, right.amplitudeLow * (constant::AmplitudeMax / 4)},
-                {right.frequencyHigh, right.amplitudeHigh * (constant::AmplitudeMax / 4)},
-            };
-            VibrateDevice<4>(manager.state.jvm, index, vibrations);
+            manager.QueueVibration(index, {left, right});
         } else {
-            VibrateDevice(manager.state.jvm, index, left);
-            VibrateDevice(manager.state.jvm, partnerIndex, right);
+            manager.QueueVibration(index, {left});
+            manager.QueueVibration(partnerIndex, {right});
         }
     }
 }
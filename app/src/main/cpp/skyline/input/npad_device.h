@@ -10,6 +10,8 @@ namespace skyline::constant {
     constexpr jlong MsInSecond = 1000; //!< The amount of milliseconds in a single second of time
     constexpr jint AmplitudeMax = std::numeric_limits<u8>::max(); //!< The maximum amplitude for Android Vibration APIs
     constexpr i8 NullIndex = -1; //!< The placeholder index value when there is no device present
+    constexpr u64 NpadSamplingPeriod = 5'000'000; //!< The time between two samples of NPad input being written to shared memory in nanoseconds (200 Hz)
+    constexpr u64 VibrationUpdatePeriod = 20'000'000; //!< The minimum time between two vibrations being sent to a single host controller in nanoseconds, any requests in between are coalesced into the latest one
 }
 
 namespace skyline::input {
@@ -108,9 +110,21 @@ namespace skyline::input {
         float frequencyLow;
         float amplitudeHigh;
         float frequencyHigh;
+
+        bool operator==(const NpadVibrationValue &) const = default;
     };
     static_assert(sizeof(NpadVibrationValue) == 0x10);
 
+    /**
+     * @brief A vibration that should be played on a host controller, this is either a single value or the values of a left and right LRA which are combined
+     */
+    struct NpadVibrationRequest {
+        NpadVibrationValue left;
+        std::optional<NpadVibrationValue> right; //!< The value of the right LRA, if it's combined with the left one on the same host controller
+
+        bool operator==(const NpadVibrationRequest &) const = default;
+    };
+
     class NpadManager;
 
     /**
@@ -121,7 +135,19 @@ namespace skyline::input {
         NpadManager &manager; //!< The manager responsible for managing this NpadDevice
         NpadSection &section; //!< The section in HID shared memory for this controller
         NpadControllerInfo *controllerInfo; //!< The NpadControllerInfo for this controller's type
-        u64 globalTimestamp{}; //!< An incrementing timestamp that's common across all sections
+
+        /**
+         * @brief The latest host input which hasn't been sampled into shared memory yet
+         * @note This is only written to by the host input thread and read by the sampler thread, it's lock-free so that input events never contend with the sampler
+         */
+        struct PendingState {
+            std::atomic<u64> buttons{}; //!< The buttons of the controller's own layout, this doesn't contain the stick buttons as they're derived from the axes
+            std::atomic<u64> defaultButtons{}; //!< The buttons of the default layout, these differ from the controller's own layout for horizontal Joy-Cons
+            std::atomic<u64> latchedButtons{}; //!< The buttons of the controller's own layout which were pressed since the last sample, these are sampled as pressed even if they were released in the meantime
+            std::atomic<u64> latchedDefaultButtons{}; //!< The buttons of the default layout which were pressed since the last sample
+            std::array<std::atomic<i32>, 4> axes{}; //!< The stick axes of the controller's own layout in the order LX, LY, RX, RY
+            std::array<std::atomic<i32>, 4> defaultAxes{}; //!< The stick axes of the default layout
+        } pending;
 
         /**
          * @brief This updates the headers and creates a new entry in HID Shared Memory
@@ -130,6 +156,11 @@ namespace skyline::input {
          */
         NpadControllerState &GetNextEntry(NpadControllerInfo &info);
 
+        /**
+         * @brief This writes a single entry with the pending input into the shared memory of a layout
+         */
+        void WriteEntry(NpadControllerInfo &info, u64 buttons, const std::array<std::atomic<i32>, 4> &axes);
+
         /**
         * @return The NpadControllerInfo for this controller based on it's type
         */
@@ -173,10 +204,17 @@ namespace skyline::input {
          */
         void Disconnect();
 
+        /**
+         * @brief This writes the pending host input of this controller into shared memory as a new sample, buttons which were pressed since the last sample are written as pressed even if they've been released already
+         * @note This is called by the sampler thread of the NpadManager while holding its mutex
+         */
+        void Sample();
+
         /**
          * @brief This changes the state of buttons to the specified state
          * @param mask A bit-field mask of all the buttons to change
          * @param pressed If the buttons were pressed or released
+         * @note This only updates the pending state, it's written to shared memory on the next sample
          */
         void SetButtonState(NpadButton mask, bool pressed);
 
@@ -184,11 +222,20 @@ namespace skyline::input {
          * @brief This sets the value of an axis to the specified value
          * @param axis The axis to set the value of
          * @param value The value to set
+         * @note This only updates the pending state, it's written to shared memory on the next sample
          */
         void SetAxisValue(NpadAxisId axis, i32 value);
 
+        /**
+         * @brief This queues a vibration value for a single LRA of this controller
+         * @note The vibration is played asynchronously by the vibration thread of the NpadManager
+         */
         void Vibrate(bool isRight, const NpadVibrationValue &value);
 
+        /**
+         * @brief This queues vibration values for both LRAs of this controller
+         * @note The vibration is played asynchronously by the vibration thread of the NpadManager
+         */
         void Vibrate(const NpadVibrationValue &left, const NpadVibrationValue &right);
     };
 }
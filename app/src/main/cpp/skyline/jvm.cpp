@@ -13,6 +13,13 @@ namespace skyline {
     }
 
     JvmManager::~JvmManager() {
+        for (auto &[timings, amplitudes] : vibrationArrays) {
+            if (timings) {
+                env->DeleteGlobalRef(timings);
+                env->DeleteGlobalRef(amplitudes);
+            }
+        }
+
         env->DeleteGlobalRef(instanceClass);
         env->DeleteGlobalRef(instance);
     }
@@ -48,15 +55,24 @@ namespace skyline {
     }
 
     void JvmManager::VibrateDevice(jint index, const std::span<jlong> &timings, const std::span<jint> &amplitudes) {
-        auto jTimings = env->NewLongArray(timings.size());
+        if (vibrationArrays.size() <= timings.size())
+            vibrationArrays.resize(timings.size() + 1);
+
+        auto &[jTimings, jAmplitudes]{vibrationArrays[timings.size()]};
+        if (!jTimings) {
+            auto localTimings{env->NewLongArray(timings.size())};
+            jTimings = reinterpret_cast<jlongArray>(env->NewGlobalRef(localTimings));
+            env->DeleteLocalRef(localTimings);
+
+            auto localAmplitudes{env->NewIntArray(amplitudes.size())};
+            jAmplitudes = reinterpret_cast<jintArray>(env->NewGlobalRef(localAmplitudes));
+            env->DeleteLocalRef(localAmplitudes);
+        }
+
         env->SetLongArrayRegion(jTimings, 0, timings.size(), timings.data());
-        auto jAmplitudes = env->NewIntArray(amplitudes.size());
         env->SetIntArrayRegion(jAmplitudes, 0, amplitudes.size(), amplitudes.data());
 
         env->CallVoidMethod(instance, vibrateDeviceId, index, jTimings, jAmplitudes);
-
-        env->DeleteLocalRef(jTimings);
-        env->DeleteLocalRef(jAmplitudes);
     }
 
     void JvmManager::ClearVibrationDevice(jint index) {
@@ -96,6 +96,7 @@ namespace skyline {
 
         /**
          * @brief A call to EmulationActivity.vibrateDevice in Kotlin
+         * @note The Java arrays are cached by their length and reused across calls, this must only be called from a single thread at a time
          */
         void VibrateDevice(jint index, const std::span<jlong> &timings, const std::span<jint> &amplitudes);
 
@@ -108,5 +109,7 @@ namespace skyline {
         jmethodID initializeControllersId;
         jmethodID vibrateDeviceId;
         jmethodID clearVibrationDeviceId;
+
+        std::vector<std::pair<jlongArray, jintArray>> vibrationArrays; //!< Global references to the timing and amplitude arrays passed to EmulationActivity.vibrateDevice, indexed by their length
     };
 }
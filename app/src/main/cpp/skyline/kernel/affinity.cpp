@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <kernel/types/KProcess.h>
+#include "affinity.h"
+
+namespace skyline::kernel {
+    AffinityManager::AffinityManager(const DeviceState &state) : state(state), policy(GetPolicy()) {
+        cpu_set_t allowedCpus; // We should only use CPUs that are in the cpuset we've been assigned by Android
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &allowedCpus) == -1)
+            throw exception("Couldn't retrieve the CPU affinity of the process: {}", strerror(errno));
+
+        struct HostCpu {
+            u32 index; //!< The index of the CPU
+            u64 maxFrequency; //!< The maximum frequency of the CPU in kHz
+        };
+        std::vector<HostCpu> hostCpus;
+
+        auto cpuCount = static_cast<u32>(sysconf(_SC_NPROCESSORS_CONF));
+        for (u32 cpu{}; cpu < cpuCount; cpu++) {
+            if (!CPU_ISSET(cpu, &allowedCpus))
+                continue;
+
+            u64 maxFrequency{};
+            std::ifstream frequencyFile(fmt::format("/sys/devices/system/cpu/cpu{}/cpufreq/cpuinfo_max_freq", cpu));
+            frequencyFile >> maxFrequency;
+            hostCpus.push_back({cpu, maxFrequency});
+        }
+
+        if (hostCpus.empty())
+            throw exception("Couldn't find any host CPUs to schedule guest cores on");
+
+        // The fastest CPUs are sorted first, ties are broken by the CPU index as the performance cluster is enumerated last on big.LITTLE SoCs
+        std::sort(hostCpus.begin(), hostCpus.end(), [](const HostCpu &a, const HostCpu &b) {
+            return a.maxFrequency != b.maxFrequency ? a.maxFrequency > b.maxFrequency : a.index > b.index;
+        });
+
+        auto fastestCount = std::min(hostCpus.size(), static_cast<size_t>(constant::CoreCount));
+        for (u8 core{}; core < constant::CoreCount; core++) {
+            auto &hostSet = coreMap[core];
+            CPU_ZERO(&hostSet);
+
+            switch (policy) {
+                case AffinityPolicy::FastestPinned:
+                    CPU_SET(hostCpus[core % fastestCount].index, &hostSet);
+                    break;
+
+                case AffinityPolicy::FastestShared:
+                    for (size_t index{}; index < fastestCount; index++)
+                        CPU_SET(hostCpus[index].index, &hostSet);
+                    break;
+
+                default:
+                    hostSet = allowedCpus;
+                    break;
+            }
+        }
+
+        for (u8 core{}; core < constant::CoreCount; core++) {
+            std::string hostCpuList;
+            for (const auto &hostCpu : hostCpus)
+                if (CPU_ISSET(hostCpu.index, &coreMap[core]))
+                    hostCpuList += fmt::format("{} ", hostCpu.index);
+            state.logger->Debug("Guest Core {} -> Host CPUs: {}", core, hostCpuList);
+        }
+    }
+
+    AffinityPolicy AffinityManager::GetPolicy() {
+        try {
+            auto policy = std::stoi(state.settings->GetString("affinity_policy"));
+            if (policy >= static_cast<int>(AffinityPolicy::None) && policy <= static_cast<int>(AffinityPolicy::FastestShared))
+                return static_cast<AffinityPolicy>(policy);
+        } catch (const std::exception &) {
+            // A missing or non-numeric setting is handled the same way as an out of range one
+        }
+
+        state.logger->Warn("Invalid CPU affinity policy setting, falling back to sharing the fastest cores");
+        return AffinityPolicy::FastestShared;
+    }
+
+    cpu_set_t AffinityManager::GetHostMask(u64 coreMask) {
+        cpu_set_t hostMask;
+        CPU_ZERO(&hostMask);
+
+        for (u8 core{}; core < constant::CoreCount; core++)
+            if (coreMask & (1ULL << core))
+                CPU_OR(&hostMask, &hostMask, &coreMap[core]);
+
+        return hostMask;
+    }
+
+    void AffinityManager::SetAffinity(pid_t tid, u64 coreMask) {
+        auto hostMask = GetHostMask(coreMask);
+        if (!CPU_COUNT(&hostMask))
+            return;
+
+        // A failure here isn't fatal as the thread will still run correctly, albeit with the default host scheduling
+        if (sched_setaffinity(tid, sizeof(cpu_set_t), &hostMask) == -1)
+            state.logger->Warn("Couldn't set the CPU affinity of TID {} to guest core mask 0x{:X}: {}", tid, coreMask, strerror(errno));
+    }
+
+    void AffinityManager::TrackMigrations(pid_t tid) {
+        perf_event_attr migrationAttr{
+            .type = PERF_TYPE_SOFTWARE,
+            .size = sizeof(perf_event_attr),
+            .config = PERF_COUNT_SW_CPU_MIGRATIONS,
+        };
+        auto fd = static_cast<int>(syscall(__NR_perf_event_open, &migrationAttr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+
+        std::lock_guard guard(migrationLock);
+        migrationFds[tid] = fd;
+    }
+
+    void AffinityManager::UntrackMigrations(pid_t tid) {
+        std::lock_guard guard(migrationLock);
+        auto it = migrationFds.find(tid);
+        if (it == migrationFds.end())
+            return;
+
+        if (it->second != -1)
+            close(it->second);
+        migrationFds.erase(it);
+    }
+
+    u64 AffinityManager::ReadMigrationCount(pid_t tid, int fd) {
+        u64 count{};
+        if (fd != -1 && read(fd, &count, sizeof(count)) == sizeof(count))
+            return count;
+
+        // The scheduler statistics are only exposed on kernels built with CONFIG_SCHED_DEBUG
+        std::ifstream schedFile(fmt::format("/proc/{}/task/{}/sched", state.process->pid, tid));
+        std::string line;
+        while (std::getline(schedFile, line)) {
+            if (line.starts_with("se.nr_migrations")) {
+                auto separator = line.find(':');
+                if (separator != std::string::npos)
+                    return std::stoull(line.substr(separator + 1));
+            }
+        }
+
+        return 0;
+    }
+
+    u64 AffinityManager::GetMigrationCount(pid_t tid) {
+        std::lock_guard guard(migrationLock);
+        auto it = migrationFds.find(tid);
+        return ReadMigrationCount(tid, it != migrationFds.end() ? it->second : -1);
+    }
+
+    std::vector<std::pair<pid_t, u64>> AffinityManager::GetMigrationCounts() {
+        std::lock_guard guard(migrationLock);
+        std::vector<std::pair<pid_t, u64>> counts;
+        counts.reserve(migrationFds.size());
+        for (const auto &[tid, fd] : migrationFds)
+            counts.emplace_back(tid, ReadMigrationCount(tid, fd));
+        return counts;
+    }
+}
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <sched.h>
+#include <common.h>
+
+namespace skyline {
+    namespace constant {
+        constexpr u8 CoreCount = 4; //!< The amount of CPU cores a HOS process can be scheduled on
+        constexpr u64 CoreMask = (1ULL << CoreCount) - 1; //!< A mask of all the CPU cores a HOS process can be scheduled on
+        constexpr u8 DefaultCore = 0; //!< The ideal core of the main thread of a process (This is read from the NPDM on HOS)
+        constexpr i32 IdealCoreDontCare = -1; //!< An ideal core value which denotes that the thread has no preference for a core
+        constexpr i32 IdealCoreUseProcessValue = -2; //!< An ideal core value which denotes that the default core of the process should be used
+        constexpr i32 IdealCoreNoUpdate = -3; //!< An ideal core value which denotes that the current ideal core should be retained
+    }
+
+    namespace kernel {
+        /**
+         * @brief This enumerates the policies that can be used to map guest cores onto host CPUs
+         */
+        enum class AffinityPolicy : u8 {
+            None = 0, //!< Guest threads aren't restricted and can be scheduled on any host CPU
+            FastestPinned = 1, //!< Every guest core is pinned to a single host CPU out of the fastest host CPUs
+            FastestShared = 2, //!< All guest cores share the fastest host CPUs and are balanced amongst them by the host scheduler
+        };
+
+        /**
+         * @brief The AffinityManager class maps the CPU cores of the guest onto CPUs of the host, this is used to apply guest core masks to host threads
+         */
+        class AffinityManager {
+          private:
+            const DeviceState &state;
+            AffinityPolicy policy; //!< The policy used to map guest cores onto host CPUs
+            std::array<cpu_set_t, constant::CoreCount> coreMap{}; //!< The set of host CPUs that each guest core is mapped onto
+            Mutex migrationLock; //!< This mutex is used to ensure concurrent access to migrationFds is safe
+            std::unordered_map<pid_t, int> migrationFds; //!< A map from the TID of a host thread to a perf event FD which counts the amount of times it was migrated between host CPUs, this is -1 if perf events aren't available
+
+            /**
+             * @return The policy set in the settings, this falls back to the default policy if the setting is missing or invalid
+             */
+            AffinityPolicy GetPolicy();
+
+            /**
+             * @return The amount of times the host thread was migrated between host CPUs
+             * @note migrationLock must be locked when calling this
+             */
+            u64 ReadMigrationCount(pid_t tid, int fd);
+
+          public:
+            /**
+             * @param state The state of the device
+             */
+            AffinityManager(const DeviceState &state);
+
+            /**
+             * @param coreMask A mask of guest cores
+             * @return The set of host CPUs that the supplied guest cores map onto
+             */
+            cpu_set_t GetHostMask(u64 coreMask);
+
+            /**
+             * @brief This restricts a host thread to the host CPUs which correspond to the supplied guest cores
+             * @param tid The TID of the host thread
+             * @param coreMask A mask of guest cores the thread is allowed to run on
+             */
+            void SetAffinity(pid_t tid, u64 coreMask);
+
+            /**
+             * @brief This starts counting the amount of times a host thread is migrated between host CPUs
+             * @param tid The TID of the host thread
+             */
+            void TrackMigrations(pid_t tid);
+
+            /**
+             * @brief This stops counting the migrations of a host thread
+             * @param tid The TID of the host thread
+             */
+            void UntrackMigrations(pid_t tid);
+
+            /**
+             * @param tid The TID of a tracked host thread
+             * @return The amount of times the host thread was migrated between host CPUs
+             * @note This uses a perf event counter when it's available and falls back to the scheduler statistics in procfs otherwise
+             */
+            u64 GetMigrationCount(pid_t tid);
+
+            /**
+             * @return The TID of every tracked host thread alongside the amount of times it was migrated between host CPUs
+             */
+            std::vector<std::pair<pid_t, u64>> GetMigrationCounts();
+        };
+    }
+}
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "profiler.h"
+
+namespace skyline::kernel {
+    SvcProfiler::SvcProfiler(const DeviceState &state) : state(state), enabled(state.settings->GetBool("svc_profiling")) {}
+
+    SvcProfiler::ThreadCounters &SvcProfiler::RegisterThread() {
+        std::lock_guard guard(threadCountersLock);
+        return threadCounters.emplace_back();
+    }
+
+    std::array<SvcProfiler::SvcStatistics, constant::SvcCount> SvcProfiler::Collect() {
+        std::array<SvcStatistics, constant::SvcCount> statistics{};
+
+        std::lock_guard guard(threadCountersLock);
+        for (const auto &counters : threadCounters) {
+            for (size_t svc{}; svc < constant::SvcCount; svc++) {
+                auto &svcStatistics = statistics[svc];
+                svcStatistics.calls += counters.calls[svc].load(std::memory_order_relaxed);
+                svcStatistics.totalTime += counters.totalTime[svc].load(std::memory_order_relaxed);
+                for (size_t bucket{}; bucket < constant::SvcLatencyBuckets; bucket++)
+                    svcStatistics.histogram[bucket] += counters.histogram[svc][bucket].load(std::memory_order_relaxed);
+            }
+        }
+
+        return statistics;
+    }
+
+    void SvcProfiler::Dump() {
+        auto statistics = Collect();
+
+        for (size_t svc{}; svc < constant::SvcCount; svc++) {
+            const auto &svcStatistics = statistics[svc];
+            if (!svcStatistics.calls)
+                continue;
+
+            std::string histogram;
+            for (size_t bucket{}; bucket < constant::SvcLatencyBuckets; bucket++)
+                if (svcStatistics.histogram[bucket])
+                    histogram += fmt::format(" [2^{} ns: {}]", bucket, svcStatistics.histogram[bucket]);
+
+            state.logger->Info("SVC 0x{:X}: {} calls, {} ns total, {} ns average -{}", svc, svcStatistics.calls, svcStatistics.totalTime, svcStatistics.totalTime / svcStatistics.calls, histogram);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <list>
+#include <common.h>
+
+namespace skyline {
+    namespace constant {
+        constexpr size_t SvcCount = 0x80; //!< The amount of SVC IDs that can be dispatched
+        constexpr size_t SvcLatencyBuckets = 32; //!< The amount of log2 buckets in an SVC latency histogram, the last bucket holds all latencies above 2^31 ns
+    }
+
+    namespace kernel {
+        /**
+         * @brief The SvcProfiler class collects per-SVC call counts and latency histograms from all kernel threads
+         * @details Every kernel thread writes to its own set of counters which avoids any contention on the dispatch path, the counters of all threads are only merged when they're read
+         */
+        class SvcProfiler {
+          public:
+            /**
+             * @brief This holds the counters of a single kernel thread, they're only ever written to by that thread
+             */
+            struct ThreadCounters {
+                std::array<std::atomic<u64>, constant::SvcCount> calls; //!< The amount of calls to each SVC
+                std::array<std::atomic<u64>, constant::SvcCount> totalTime; //!< The total time spent in each SVC in nanoseconds
+                std::array<std::array<std::atomic<u64>, constant::SvcLatencyBuckets>, constant::SvcCount> histogram; //!< A log2 histogram of the latency of each SVC in nanoseconds
+            };
+
+            /**
+             * @brief This holds the merged statistics of a single SVC
+             */
+            struct SvcStatistics {
+                u64 calls; //!< The amount of calls to the SVC
+                u64 totalTime; //!< The total time spent in the SVC in nanoseconds
+                std::array<u64, constant::SvcLatencyBuckets> histogram; //!< A log2 histogram of the latency of the SVC, bucket N holds latencies in the range [2^N, 2^(N + 1)) ns
+            };
+
+          private:
+            const DeviceState &state;
+            Mutex threadCountersLock; //!< This mutex is used to ensure concurrent access to threadCounters is safe
+            std::list<ThreadCounters> threadCounters; //!< The counters of every kernel thread, a list is used as the references must remain stable
+
+          public:
+            std::atomic<bool> enabled; //!< If SVC calls should be profiled, the dispatch path only pays for a relaxed load of this when it's disabled
+
+            /**
+             * @param state The state of the device
+             */
+            SvcProfiler(const DeviceState &state);
+
+            /**
+             * @brief This allocates a set of counters for the calling kernel thread
+             * @return A reference to the counters which remains valid for the lifetime of the profiler
+             */
+            ThreadCounters &RegisterThread();
+
+            /**
+             * @brief This records a single SVC call into the counters of the calling kernel thread
+             * @param counters The counters of the calling kernel thread
+             * @param svc The ID of the SVC
+             * @param latency The time spent in the SVC in nanoseconds
+             */
+            static inline void Record(ThreadCounters &counters, u16 svc, u64 latency) {
+                auto bucket = latency ? std::min(static_cast<size_t>(63 - __builtin_clzll(latency)), constant::SvcLatencyBuckets - 1) : 0;
+
+                // Relaxed stores are used rather than atomic RMW operations as only the owning thread writes to the counters
+                counters.calls[svc].store(counters.calls[svc].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                counters.totalTime[svc].store(counters.totalTime[svc].load(std::memory_order_relaxed) + latency, std::memory_order_relaxed);
+                counters.histogram[svc][bucket].store(counters.histogram[svc][bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief This merges the counters of all kernel threads
+             * @return The statistics of every SVC, indexed by the SVC ID
+             */
+            std::array<SvcStatistics, constant::SvcCount> Collect();
+
+            /**
+             * @brief This writes the statistics of every SVC that was called to the log
+             */
+            void Dump();
+        };
+    }
+}
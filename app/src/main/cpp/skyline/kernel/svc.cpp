@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <sys/resource.h>
 #include <os.h>
 #include "results.h"
 #include "svc.h"
@@ -222,6 +223,7 @@ namespace skyline::kernel::svc {
         auto entryArgument = state.ctx->registers.x2;
         auto stackTop = state.ctx->registers.x3;
         auto priority = static_cast<i8>(state.ctx->registers.w4);
+        auto idealCore = static_cast<i32>(state.ctx->registers.w5);
 
         if (!state.thread->switchPriority.Valid(priority)) {
             state.ctx->registers.w0 = result::InvalidAddress;
@@ -229,8 +231,17 @@ namespace skyline::kernel::svc {
             return;
         }
 
-        auto thread = state.process->CreateThread(entryAddress, entryArgument, stackTop, priority);
-        state.logger->Debug("svcCreateThread: Created thread with handle 0x{:X} (Entry Point: 0x{:X}, Argument: 0x{:X}, Stack Pointer: 0x{:X}, Priority: {}, TID: {})", thread->handle, entryAddress, entryArgument, stackTop, priority, thread->tid);
+        if (idealCore == constant::IdealCoreUseProcessValue)
+            idealCore = constant::DefaultCore;
+
+        if (idealCore < 0 || idealCore >= constant::CoreCount) {
+            state.ctx->registers.w0 = result::InvalidCoreId;
+            state.logger->Warn("svcCreateThread: 'idealCore' invalid: {}", idealCore);
+            return;
+        }
+
+        auto thread = state.process->CreateThread(entryAddress, entryArgument, stackTop, priority, static_cast<i8>(idealCore));
+        state.logger->Debug("svcCreateThread: Created thread with handle 0x{:X} (Entry Point: 0x{:X}, Argument: 0x{:X}, Stack Pointer: 0x{:X}, Priority: {}, Ideal Core: {}, TID: {})", thread->handle, entryAddress, entryArgument, stackTop, priority, idealCore, thread->tid);
 
         state.ctx->registers.w1 = thread->handle;
         state.ctx->registers.w0 = Result{};
@@ -255,22 +266,29 @@ namespace skyline::kernel::svc {
     }
 
     void SleepThread(DeviceState &state) {
-        auto in = state.ctx->registers.x0;
+        auto in = static_cast<i64>(state.ctx->registers.x0);
 
-        switch (in) {
-            case 0:
-            case 1:
-            case 2:
-                state.logger->Debug("svcSleepThread: Yielding thread: {}", in);
-                break;
-            default:
-                state.logger->Debug("svcSleepThread: Thread sleeping for {} ns", in);
-                struct timespec spec = {
-                    .tv_sec = static_cast<time_t>(state.ctx->registers.x0 / 1000000000),
-                    .tv_nsec = static_cast<long>(state.ctx->registers.x0 % 1000000000)
-                };
-                nanosleep(&spec, nullptr);
+        // The yield variants are handled by the guest's SVC handler, HOS ignores any negative values which aren't a yield type rather than treating them as a sleep
+        if (in <= 0) {
+            state.logger->Debug("svcSleepThread: Ignoring invalid sleep duration: {}", in);
+            return;
+        }
+
+        state.logger->Debug("svcSleepThread: Thread sleeping for {} ns", in);
+
+        // An absolute deadline is used so that the sleep isn't extended by interruptions or by the time spent setting it up
+        struct timespec deadline{};
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+        auto duration = static_cast<u64>(in);
+        deadline.tv_sec += static_cast<time_t>(duration / constant::NsInSecond);
+        deadline.tv_nsec += static_cast<long>(duration % constant::NsInSecond);
+        if (deadline.tv_nsec >= static_cast<long>(constant::NsInSecond)) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= constant::NsInSecond;
         }
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR);
     }
 
     void GetThreadPriority(DeviceState &state) {
@@ -301,6 +319,67 @@ namespace skyline::kernel::svc {
         }
     }
 
+    void GetThreadCoreMask(DeviceState &state) {
+        auto handle = state.ctx->registers.w2;
+        try {
+            auto thread = handle == constant::ThreadSelf ? state.thread : state.process->GetHandle<type::KThread>(handle);
+            state.logger->Debug("svcGetThreadCoreMask: Writing thread core mask (Ideal Core: {}, Affinity Mask: 0x{:X})", thread->idealCore, thread->affinityMask);
+
+            state.ctx->registers.w1 = static_cast<u32>(thread->idealCore);
+            state.ctx->registers.x2 = thread->affinityMask;
+            state.ctx->registers.w0 = Result{};
+        } catch (const std::exception &) {
+            state.logger->Warn("svcGetThreadCoreMask: 'handle' invalid: 0x{:X}", handle);
+            state.ctx->registers.w0 = result::InvalidHandle;
+        }
+    }
+
+    void SetThreadCoreMask(DeviceState &state) {
+        auto handle = state.ctx->registers.w0;
+        auto idealCore = static_cast<i32>(state.ctx->registers.w1);
+        auto affinityMask = state.ctx->registers.x2;
+
+        try {
+            auto thread = handle == constant::ThreadSelf ? state.thread : state.process->GetHandle<type::KThread>(handle);
+
+            if (idealCore == constant::IdealCoreUseProcessValue) {
+                idealCore = constant::DefaultCore;
+                affinityMask = 1ULL << idealCore;
+            }
+
+            if (!affinityMask || (affinityMask & ~constant::CoreMask)) {
+                state.ctx->registers.w0 = result::InvalidCoreId;
+                state.logger->Warn("svcSetThreadCoreMask: 'affinityMask' invalid: 0x{:X}", affinityMask);
+                return;
+            }
+
+            if (idealCore == constant::IdealCoreNoUpdate) {
+                idealCore = thread->idealCore;
+                if (idealCore != constant::IdealCoreDontCare && !(affinityMask & (1ULL << idealCore)))
+                    idealCore = 63 - __builtin_clzll(affinityMask); // The highest core in the new mask is used if the current ideal core isn't contained in it
+            }
+
+            if (idealCore < constant::IdealCoreDontCare || idealCore >= constant::CoreCount) {
+                state.ctx->registers.w0 = result::InvalidCoreId;
+                state.logger->Warn("svcSetThreadCoreMask: 'idealCore' invalid: {}", idealCore);
+                return;
+            }
+
+            if (idealCore != constant::IdealCoreDontCare && !(affinityMask & (1ULL << idealCore))) {
+                state.ctx->registers.w0 = result::InvalidCombination;
+                state.logger->Warn("svcSetThreadCoreMask: 'affinityMask' 0x{:X} doesn't contain 'idealCore' {}", affinityMask, idealCore);
+                return;
+            }
+
+            state.logger->Debug("svcSetThreadCoreMask: Setting thread core mask (Ideal Core: {}, Affinity Mask: 0x{:X})", idealCore, affinityMask);
+            thread->UpdateAffinity(static_cast<i8>(idealCore), affinityMask);
+            state.ctx->registers.w0 = Result{};
+        } catch (const std::exception &) {
+            state.logger->Warn("svcSetThreadCoreMask: 'handle' invalid: 0x{:X}", handle);
+            state.ctx->registers.w0 = result::InvalidHandle;
+        }
+    }
+
     void ClearEvent(DeviceState &state) {
         auto object = state.process->GetHandle<type::KEvent>(state.ctx->registers.w0);
         object->signalled = false;
@@ -608,11 +687,10 @@ namespace skyline::kernel::svc {
     }
 
     void GetThreadId(DeviceState &state) {
-        constexpr KHandle threadSelf = 0xFFFF8000; // This is the handle used by threads to refer to themselves
         auto handle = state.ctx->registers.w1;
         pid_t pid{};
 
-        if (handle != threadSelf)
+        if (handle != constant::ThreadSelf)
             pid = state.process->GetHandle<type::KThread>(handle)->tid;
         else
             pid = state.thread->tid;
@@ -644,6 +722,9 @@ namespace skyline::kernel::svc {
 
         switch (id0) {
             case constant::infoState::AllowedCpuIdBitmask:
+                out = constant::CoreMask;
+                break;
+
             case constant::infoState::AllowedThreadPriorityMask:
             case constant::infoState::IsCurrentProcessBeingDebugged:
             case constant::infoState::TitleId:
@@ -87,6 +87,7 @@ namespace skyline {
 
         /**
          * @brief Sleep for a specified amount of time, or yield thread (https://switchbrew.org/wiki/SVC#SleepThread)
+         * @note The yield variants are handled by the SVC handler in the guest as the guest thread itself needs to yield, they never reach this
          */
         void SleepThread(DeviceState &state);
 
@@ -100,6 +101,16 @@ namespace skyline {
          */
         void SetThreadPriority(DeviceState &state);
 
+        /**
+         * @brief Get the ideal core and the affinity mask of provided thread handle (https://switchbrew.org/wiki/SVC#GetThreadCoreMask)
+         */
+        void GetThreadCoreMask(DeviceState &state);
+
+        /**
+         * @brief Set the ideal core and the affinity mask of provided thread handle (https://switchbrew.org/wiki/SVC#SetThreadCoreMask)
+         */
+        void SetThreadCoreMask(DeviceState &state);
+
         /**
          * @brief Clears a KEvent of it's signal (https://switchbrew.org/wiki/SVC#ClearEvent)
          */
@@ -203,8 +214,8 @@ namespace skyline {
             SleepThread, // 0x0B
             GetThreadPriority, // 0x0C
             SetThreadPriority, // 0x0D
-            nullptr, // 0x0E
-            nullptr, // 0x0F
+            GetThreadCoreMask, // 0x0E
+            SetThreadCoreMask, // 0x0F
             nullptr, // 0x10
             nullptr, // 0x11
             ClearEvent, // 0x12
@@ -64,7 +64,7 @@ namespace skyline::kernel::type {
     KProcess::KProcess(const DeviceState &state, pid_t pid, u64 entryPoint, std::shared_ptr<type::KSharedMemory> &stack, std::shared_ptr<type::KSharedMemory> &tlsMemory) : pid(pid), stack(stack), KSyncObject(state, KType::KProcess) {
         constexpr auto DefaultPriority = 44; // The default priority of a process
 
-        auto thread = NewHandle<KThread>(pid, entryPoint, 0x0, stack->guest.address + stack->guest.size, 0, DefaultPriority, this, tlsMemory).item;
+        auto thread = NewHandle<KThread>(pid, entryPoint, 0x0, stack->guest.address + stack->guest.size, 0, DefaultPriority, constant::DefaultCore, this, tlsMemory).item;
         threads[pid] = thread;
         state.nce->WaitThreadInit(thread);
 
@@ -78,7 +78,7 @@ namespace skyline::kernel::type {
         status = Status::Exiting;
     }
 
-    std::shared_ptr<KThread> KProcess::CreateThread(u64 entryPoint, u64 entryArg, u64 stackTop, i8 priority) {
+    std::shared_ptr<KThread> KProcess::CreateThread(u64 entryPoint, u64 entryArg, u64 stackTop, i8 priority, i8 idealCore) {
         auto size = (sizeof(ThreadContext) + (PAGE_SIZE - 1)) & ~(PAGE_SIZE - 1);
         auto tlsMem = std::make_shared<type::KSharedMemory>(state, 0, size, memory::Permission{true, true, false}, memory::states::Reserved);
 
@@ -96,7 +96,7 @@ namespace skyline::kernel::type {
             throw exception("Cannot create thread: Address: 0x{:X}, Stack Top: 0x{:X}", entryPoint, stackTop);
 
         auto pid = static_cast<pid_t>(fregs.x0);
-        auto process = NewHandle<KThread>(pid, entryPoint, entryArg, stackTop, GetTlsSlot(), priority, this, tlsMem).item;
+        auto process = NewHandle<KThread>(pid, entryPoint, entryArg, stackTop, GetTlsSlot(), priority, idealCore, this, tlsMem).item;
         threads[pid] = process;
 
         return process;
@@ -107,6 +107,19 @@ namespace skyline::kernel::type {
         return (chunk && chunk->host) ? chunk->host + (address - chunk->address) : 0;
     }
 
+    u64 KProcess::GetHostAddress(u64 address, size_t size) {
+        auto chunk = state.os->memory.GetChunk(address);
+        return (chunk && chunk->host && (address + size) <= (chunk->address + chunk->size)) ? chunk->host + (address - chunk->address) : 0;
+    }
+
+    std::span<u8> KProcess::GetHostSpan(u64 address, size_t size) {
+        auto chunk = state.os->memory.GetChunk(address);
+        if (!chunk || !chunk->host)
+            return {};
+
+        return std::span(reinterpret_cast<u8 *>(chunk->host + (address - chunk->address)), std::min<size_t>(size, (chunk->address + chunk->size) - address));
+    }
+
     void KProcess::ReadMemory(void *destination, u64 offset, size_t size, bool forceGuest) {
         if (!forceGuest) {
             auto source = GetHostAddress(offset);
@@ -17,6 +17,7 @@ namespace skyline {
         constexpr auto TlsSlotSize = 0x200; //!< The size of a single TLS slot
         constexpr auto TlsSlots = PAGE_SIZE / TlsSlotSize; //!< The amount of TLS slots in a single page
         constexpr KHandle BaseHandleIndex = 0xD000; // The index of the base handle
+        constexpr KHandle ThreadSelf = 0xFFFF8000; //!< This is the handle used by threads to refer to themselves
         constexpr u32 MtxOwnerMask = 0xBFFFFFFF; //!< The mask of values which contain the owner of a mutex
     }
 
@@ -144,9 +145,10 @@ namespace skyline {
             * @param entryArg An argument to the function
             * @param stackTop The top of the stack
             * @param priority The priority of the thread
+            * @param idealCore The ideal guest core of the thread
             * @return An instance of KThread class for the corresponding thread
             */
-            std::shared_ptr<KThread> CreateThread(u64 entryPoint, u64 entryArg, u64 stackTop, i8 priority);
+            std::shared_ptr<KThread> CreateThread(u64 entryPoint, u64 entryArg, u64 stackTop, i8 priority, i8 idealCore);
 
             /**
             * @brief This returns the host address for a specific address in guest memory
@@ -155,6 +157,22 @@ namespace skyline {
             */
             u64 GetHostAddress(u64 address);
 
+            /**
+            * @brief This returns the host address for a region in guest memory if it's contiguous in host memory
+            * @param address The corresponding guest address
+            * @param size The size of the region
+            * @return The corresponding host address or 0 if the region isn't entirely within a single host mapping
+            */
+            u64 GetHostAddress(u64 address, size_t size);
+
+            /**
+            * @brief This returns the largest span of host memory that backs the start of a region in guest memory
+            * @param address The corresponding guest address
+            * @param size The size of the region
+            * @return A span over at most the size of the region or an empty span if the address isn't backed by host memory
+            */
+            std::span<u8> GetHostSpan(u64 address, size_t size);
+
             /**
             * @tparam Type The type of the pointer to return
             * @param address The address on the guest
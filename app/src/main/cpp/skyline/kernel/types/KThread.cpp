@@ -3,17 +3,21 @@
 
 #include <sys/resource.h>
 #include <nce.h>
+#include <os.h>
 #include "KThread.h"
 #include "KProcess.h"
 
 namespace skyline::kernel::type {
-    KThread::KThread(const DeviceState &state, KHandle handle, pid_t selfTid, u64 entryPoint, u64 entryArg, u64 stackTop, u64 tls, i8 priority, KProcess *parent, const std::shared_ptr<type::KSharedMemory> &tlsMemory) : handle(handle), tid(selfTid), entryPoint(entryPoint), entryArg(entryArg), stackTop(stackTop), tls(tls), priority(priority), parent(parent), ctxMemory(tlsMemory), KSyncObject(state,
+    KThread::KThread(const DeviceState &state, KHandle handle, pid_t selfTid, u64 entryPoint, u64 entryArg, u64 stackTop, u64 tls, i8 priority, i8 idealCore, KProcess *parent, const std::shared_ptr<type::KSharedMemory> &tlsMemory) : handle(handle), tid(selfTid), entryPoint(entryPoint), entryArg(entryArg), stackTop(stackTop), tls(tls), priority(priority), parent(parent), ctxMemory(tlsMemory), KSyncObject(state,
         KType::KThread) {
         UpdatePriority(priority);
+        UpdateAffinity(idealCore, 1ULL << idealCore);
+        state.os->affinity->TrackMigrations(tid);
     }
 
     KThread::~KThread() {
         Kill();
+        state.os->affinity->UntrackMigrations(tid);
     }
 
     void KThread::Start() {
@@ -31,6 +35,7 @@ namespace skyline::kernel::type {
             status = Status::Dead;
             Signal();
 
+            state.logger->Debug("Thread with TID {} was migrated between host CPUs {} times", tid, GetMigrationCount());
             tgkill(parent->pid, tid, SIGTERM);
         }
     }
@@ -42,4 +47,15 @@ namespace skyline::kernel::type {
         if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), priorityValue) == -1)
             throw exception("Couldn't set process priority to {} for PID: {}", priorityValue, tid);
     }
+
+    void KThread::UpdateAffinity(i8 idealCore, u64 affinityMask) {
+        this->idealCore = idealCore;
+        this->affinityMask = affinityMask;
+
+        state.os->affinity->SetAffinity(tid, affinityMask);
+    }
+
+    u64 KThread::GetMigrationCount() {
+        return state.os->affinity->GetMigrationCount(tid);
+    }
 }
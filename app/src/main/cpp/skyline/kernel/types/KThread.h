@@ -54,6 +54,8 @@ namespace skyline::kernel::type {
         u64 stackTop; //!< The top of the stack (Where it starts growing downwards from)
         u64 tls; //!< The address of TLS (Thread Local Storage) slot assigned to the current thread
         i8 priority; //!< The priority of a thread in Nintendo format
+        i8 idealCore; //!< The ideal guest core this thread should be scheduled on
+        u64 affinityMask; //!< A mask of the guest cores this thread can be scheduled on
 
         Priority androidPriority{19, -8}; //!< The range of priorities for Android
         Priority switchPriority{0, 63}; //!< The range of priorities for the Nintendo Switch
@@ -67,10 +69,11 @@ namespace skyline::kernel::type {
          * @param stackTop The top of the stack
          * @param tls The address of the TLS slot assigned
          * @param priority The priority of the thread in Nintendo format
+         * @param idealCore The ideal guest core of the thread
          * @param parent The parent process of this thread
          * @param tlsMemory The KSharedMemory object for TLS memory allocated by the guest process
          */
-        KThread(const DeviceState &state, KHandle handle, pid_t selfTid, u64 entryPoint, u64 entryArg, u64 stackTop, u64 tls, i8 priority, KProcess *parent, const std::shared_ptr<type::KSharedMemory> &tlsMemory);
+        KThread(const DeviceState &state, KHandle handle, pid_t selfTid, u64 entryPoint, u64 entryArg, u64 stackTop, u64 tls, i8 priority, i8 idealCore, KProcess *parent, const std::shared_ptr<type::KSharedMemory> &tlsMemory);
 
         /**
          * @brief Kills the thread and deallocates the memory allocated for stack.
@@ -93,5 +96,18 @@ namespace skyline::kernel::type {
          * @param priority The priority of the thread in Nintendo format
          */
         void UpdatePriority(i8 priority);
+
+        /**
+         * @brief Update the ideal core and the affinity mask of the thread
+         * @details The guest core mask is translated into a set of host CPUs by the AffinityManager which is applied using sched_setaffinity [https://linux.die.net/man/2/sched_setaffinity]
+         * @param idealCore The ideal guest core of the thread, this should be a valid core or IdealCoreDontCare
+         * @param affinityMask A mask of the guest cores the thread can be scheduled on
+         */
+        void UpdateAffinity(i8 idealCore, u64 affinityMask);
+
+        /**
+         * @return The amount of times the host thread was migrated between host CPUs
+         */
+        u64 GetMigrationCount();
     };
 }
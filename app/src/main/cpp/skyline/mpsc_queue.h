@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <condition_variable>
+#include "common.h"
+
+namespace skyline {
+    /**
+     * @brief A bounded lock-free multi-producer single-consumer queue, the consumer can sleep on it while it's empty
+     * @details Every slot holds a sequence number which denotes if it's free for the producer at a position or filled for the consumer at a position, this avoids any locking on the producer or consumer fast paths
+     * @tparam Type The type of the elements in the queue, this should be trivially copyable
+     * @tparam Size The amount of elements the queue can hold, this must be a power of two
+     */
+    template<typename Type, size_t Size>
+    class MpscQueue {
+      private:
+        static_assert(Size && !(Size & (Size - 1)), "The size of an MpscQueue must be a power of two");
+
+        /**
+         * @brief A single slot in the queue
+         */
+        struct Slot {
+            std::atomic<size_t> sequence; //!< The position this slot can be written at when it's equal to the position, or read at when it's one ahead of the position
+            Type value;
+        };
+
+        std::array<Slot, Size> slots;
+        alignas(64) std::atomic<size_t> enqueuePosition{}; //!< The position the next element will be pushed at
+        alignas(64) size_t dequeuePosition{}; //!< The position the next element will be popped from, this is only accessed by the consumer
+        std::atomic<bool> consumerWaiting{}; //!< If the consumer is sleeping or about to sleep on the condition variable
+        std::mutex waitMutex; //!< This mutex is only used for sleeping on and waking the consumer
+        std::condition_variable waitCondition;
+
+        /**
+         * @return If the element at the dequeue position has been published by a producer
+         */
+        inline bool Ready() {
+            return slots[dequeuePosition & (Size - 1)].sequence.load(std::memory_order_acquire) == dequeuePosition + 1;
+        }
+
+      public:
+        MpscQueue() {
+            for (size_t index{}; index < Size; index++)
+                slots[index].sequence.store(index, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Pushes an element into the queue if there's space in it
+         * @return If the element was pushed, this will be false when the queue is full
+         */
+        bool TryPush(const Type &value) {
+            auto position = enqueuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                auto &slot = slots[position & (Size - 1)];
+                auto difference = static_cast<ssize_t>(slot.sequence.load(std::memory_order_acquire) - position);
+
+                if (difference == 0) {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        slot.value = value;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        break;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            // The fence orders the publication of the slot before the check of consumerWaiting, the consumer does the opposite so one side is guaranteed to observe the other
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (consumerWaiting.load(std::memory_order_relaxed))
+                Notify();
+
+            return true;
+        }
+
+        /**
+         * @brief Pops an element from the queue if there's one in it
+         * @return If an element was popped
+         * @note This must only be called from the consumer thread
+         */
+        bool TryPop(Type &value) {
+            if (!Ready())
+                return false;
+
+            auto &slot = slots[dequeuePosition & (Size - 1)];
+            value = slot.value;
+            slot.sequence.store(dequeuePosition + Size, std::memory_order_release);
+            dequeuePosition++;
+            return true;
+        }
+
+        /**
+         * @brief Pops an element from the queue, sleeping while it's empty
+         * @param cancel A predicate that's checked before sleeping, it should return true when the consumer should stop waiting
+         * @return If an element was popped, this will only be false when the wait was cancelled
+         * @note This must only be called from the consumer thread
+         */
+        template<typename Predicate>
+        bool Pop(Type &value, Predicate cancel) {
+            while (!TryPop(value)) {
+                std::unique_lock lock(waitMutex);
+                consumerWaiting.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (!Ready()) {
+                    if (cancel()) {
+                        consumerWaiting.store(false, std::memory_order_relaxed);
+                        return false;
+                    }
+                    waitCondition.wait(lock);
+                }
+
+                consumerWaiting.store(false, std::memory_order_relaxed);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Wakes up the consumer if it's sleeping, this is used to make it re-evaluate the cancellation predicate
+         */
+        void Notify() {
+            std::lock_guard lock(waitMutex);
+            waitCondition.notify_one();
+        }
+    };
+}
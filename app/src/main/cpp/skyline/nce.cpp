@@ -20,6 +20,7 @@ namespace skyline {
         try {
             state.thread = state.process->threads.at(thread);
             state.ctx = reinterpret_cast<ThreadContext *>(state.thread->ctxMemory->kernel.address);
+            auto &svcCounters = svcProfiler->RegisterThread();
 
             while (true) {
                 asm("yield");
@@ -42,7 +43,13 @@ namespace skyline {
                     try {
                         if (kernel::svc::SvcTable[svc]) {
                             state.logger->Debug("SVC called 0x{:X}", svc);
-                            (*kernel::svc::SvcTable[svc])(state);
+                            if (svcProfiler->enabled.load(std::memory_order_relaxed)) {
+                                auto start = util::GetTimeNs();
+                                (*kernel::svc::SvcTable[svc])(state);
+                                kernel::SvcProfiler::Record(svcCounters, svc, util::GetTimeNs() - start);
+                            } else {
+                                (*kernel::svc::SvcTable[svc])(state);
+                            }
                         } else {
                             throw exception("Unimplemented SVC 0x{:X}", svc);
                         }
@@ -81,7 +88,7 @@ namespace skyline {
         state.jvm->DetachThread();
     }
 
-    NCE::NCE(DeviceState &state) : state(state) {}
+    NCE::NCE(DeviceState &state) : state(state), svcProfiler(std::make_shared<kernel::SvcProfiler>(state)) {}
 
     NCE::~NCE() {
         for (auto &thread : threadMap)
@@ -90,7 +97,11 @@ namespace skyline {
 
     void NCE::Execute() {
         try {
+            state.gpu->gpfifo.Initialize();
+
             while (true) {
+                state.gpu->WaitForSwapInterval(); // This is done without holding JniMtx so the frontend isn't blocked on it
+
                 std::lock_guard guard(JniMtx);
                 if (Halt)
                     break;
@@ -107,6 +118,11 @@ namespace skyline {
             Halt = true;
             JniMtx.unlock();
         }
+
+        if (svcProfiler->enabled)
+            svcProfiler->Dump();
+
+        state.gpu->maxwell3D->macroHle.Dump();
     }
 
     /**
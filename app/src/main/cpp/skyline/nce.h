@@ -10,6 +10,7 @@
 #include <unordered_map>
 #include "common.h"
 #include "kernel/types/KSharedMemory.h"
+#include "kernel/profiler.h"
 
 namespace skyline {
     /**
@@ -27,6 +28,8 @@ namespace skyline {
         void KernelThread(pid_t thread);
 
       public:
+        std::shared_ptr<kernel::SvcProfiler> svcProfiler; //!< This collects statistics about the SVCs dispatched by the kernel threads
+
         NCE(DeviceState &state);
 
         /**
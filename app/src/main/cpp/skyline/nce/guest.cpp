@@ -6,6 +6,7 @@
 #include <initializer_list> // This is used implicitly
 #include <asm/siginfo.h>
 #include <unistd.h>
+#include <sys/resource.h>
 #include <asm/unistd.h>
 #include "guest_common.h"
 
@@ -95,6 +96,18 @@ namespace skyline::guest {
         );
     }
 
+    /**
+     * @brief This calls a Linux syscall directly rather than through libc so that it can be used from code which is placed at an arbitrary address in the guest
+     */
+    FORCE_INLINE i64 Syscall(u64 number, u64 arg0 = 0, u64 arg1 = 0, u64 arg2 = 0) {
+        register u64 x0 asm("x0") = arg0;
+        register u64 x1 asm("x1") = arg1;
+        register u64 x2 asm("x2") = arg2;
+        register u64 x8 asm("x8") = number;
+        asm volatile("SVC #0" : "+r"(x0) : "r"(x1), "r"(x2), "r"(x8) : "memory");
+        return static_cast<i64>(x0);
+    }
+
     /**
      * @note Do not use any functions that cannot be inlined from this, as this function is placed at an arbitrary address in the guest. In addition, do not use any static variables or globals as the .bss section is not copied into the guest.
      */
@@ -125,6 +138,51 @@ namespace skyline::guest {
                 "LDR Q0, [SP], #16\n\t"
                 "LDP X1, X2, [SP], #16"::"r"(ctx->registers.x0));
             return;
+        } else if (svc == 0x0B) { // svcSleepThread
+            // The yield variants are handled here rather than in the kernel as the guest thread itself needs to yield, this also avoids blocking on the kernel
+            auto in = static_cast<i64>(ctx->registers.x0);
+            if (in == constant::yieldType::WithoutCoreMigration) {
+                Syscall(__NR_sched_yield);
+                return;
+            } else if (in == constant::yieldType::WithCoreMigration) {
+                // The thread is forced off its current CPU by temporarily removing it from its affinity mask, it isn't migrated back when the mask is restored
+                u64 mask[16];
+                u32 cpu{};
+                auto maskSize = Syscall(__NR_sched_getaffinity, 0, sizeof(mask), reinterpret_cast<u64>(mask));
+                if (maskSize > 0 && !Syscall(__NR_getcpu, reinterpret_cast<u64>(&cpu)) && cpu < (static_cast<u64>(maskSize) * 8)) {
+                    auto &word = mask[cpu / 64];
+                    auto bit = 1ULL << (cpu % 64);
+
+                    bool otherCpus{};
+                    word &= ~bit;
+                    for (i64 index{}; index < maskSize / 8; index++)
+                        otherCpus |= mask[index] != 0;
+
+                    if (otherCpus) {
+                        Syscall(__NR_sched_setaffinity, 0, static_cast<u64>(maskSize), reinterpret_cast<u64>(mask));
+                        Syscall(__NR_sched_yield);
+                        word |= bit;
+                        Syscall(__NR_sched_setaffinity, 0, static_cast<u64>(maskSize), reinterpret_cast<u64>(mask));
+                        return;
+                    }
+                }
+
+                Syscall(__NR_sched_yield);
+                return;
+            } else if (in == constant::yieldType::ToAnyThread) {
+                // Threads of any priority should be able to run, so the thread is temporarily dropped down to the lowest priority
+                constexpr u64 LowestNice{19};
+                constexpr i64 NiceOffset{20}; // The raw getpriority syscall returns 20 - nice so that it's always positive
+                auto priority = Syscall(__NR_getpriority, PRIO_PROCESS, 0);
+                if (priority > 0) {
+                    Syscall(__NR_setpriority, PRIO_PROCESS, 0, LowestNice);
+                    Syscall(__NR_sched_yield);
+                    Syscall(__NR_setpriority, PRIO_PROCESS, 0, static_cast<u64>(NiceOffset - priority));
+                } else {
+                    Syscall(__NR_sched_yield);
+                }
+                return;
+            }
         }
 
         while (true) {
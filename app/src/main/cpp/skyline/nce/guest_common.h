@@ -122,6 +122,12 @@ namespace skyline {
         };
     };
 
+    namespace constant::yieldType {
+        constexpr i64 WithoutCoreMigration = 0; //!< Yields to a thread of the same priority on the same core
+        constexpr i64 WithCoreMigration = -1; //!< Yields to a thread of the same priority and allows the thread to be migrated to another core
+        constexpr i64 ToAnyThread = -2; //!< Yields to any other thread regardless of priority
+    }
+
     /**
      * @brief This enumeration is used to convey the state of a thread to the kernel
      */
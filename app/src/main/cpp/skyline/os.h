@@ -8,6 +8,7 @@
 #include "common.h"
 #include "loader/loader.h"
 #include "kernel/ipc.h"
+#include "kernel/affinity.h"
 #include "kernel/types/KProcess.h"
 #include "kernel/types/KThread.h"
 #include "services/serviceman.h"
@@ -20,6 +21,7 @@ namespace skyline::kernel {
     class OS {
       public:
         DeviceState state; //!< The state of the device
+        std::shared_ptr<AffinityManager> affinity; //!< The AffinityManager object which maps guest cores onto host CPUs, this is declared before the process so it outlives all of its threads
         std::shared_ptr<type::KProcess> process; //!< The KProcess object for the emulator, representing the guest process
         service::ServiceManager serviceManager; //!< This manages all of the service functions
         MemoryManager memory; //!< The MemoryManager object for this process
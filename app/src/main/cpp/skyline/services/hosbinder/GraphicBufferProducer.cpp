@@ -9,6 +9,9 @@
 #include <gpu/format.h>
 #include "GraphicBufferProducer.h"
 
+extern skyline::u32 dequeueWaitTime;
+extern skyline::GroupMutex JniMtx;
+
 namespace skyline::service::hosbinder {
     Buffer::Buffer(const GbpBuffer &gbpBuffer, const std::shared_ptr<gpu::PresentationTexture> &texture) : gbpBuffer(gbpBuffer), texture(texture) {}
 
@@ -17,36 +20,67 @@ namespace skyline::service::hosbinder {
     void GraphicBufferProducer::RequestBuffer(Parcel &in, Parcel &out) {
         u32 slot{in.Pop<u32>()};
 
+        std::unique_lock lock(queueMutex);
+        auto gbpBuffer = queue.at(slot)->gbpBuffer;
+        lock.unlock();
+
         out.Push<u32>(1);
         out.Push<u32>(sizeof(GbpBuffer));
         out.Push<u32>(0);
-        out.Push(queue.at(slot)->gbpBuffer);
+        out.Push(gbpBuffer);
 
         state.logger->Debug("RequestBuffer: Slot: {}", slot, sizeof(GbpBuffer));
     }
 
     void GraphicBufferProducer::DequeueBuffer(Parcel &in, Parcel &out) {
-        u32 format{in.Pop<u32>()};
+        u32 async{in.Pop<u32>()};
         u32 width{in.Pop<u32>()};
         u32 height{in.Pop<u32>()};
-        u32 timestamp{in.Pop<u32>()};
+        u32 format{in.Pop<u32>()};
         u32 usage{in.Pop<u32>()};
 
         std::optional<u32> slot{std::nullopt};
-        while (!slot) {
+        auto FindFreeBuffer = [&] {
             for (auto &buffer : queue) {
-                if (buffer.second->status == BufferStatus::Free && buffer.second->gbpBuffer.format == format && buffer.second->gbpBuffer.width == width && buffer.second->gbpBuffer.height == height && (buffer.second->gbpBuffer.usage & usage) == usage) {
+                if (buffer.second->status == BufferStatus::Free && (!format || buffer.second->gbpBuffer.format == format) && buffer.second->gbpBuffer.width == width && buffer.second->gbpBuffer.height == height && (buffer.second->gbpBuffer.usage & usage) == usage) {
                     slot = buffer.first;
                     buffer.second->status = BufferStatus::Dequeued;
-                    break;
+                    return true;
                 }
             }
+            return false;
+        };
+
+        // Like Android's BufferQueue, an asynchronous dequeue with no free buffers fails immediately while a synchronous one waits for the consumer to release one
+        auto waitStart = util::GetTimeNs();
+        std::unique_lock lock(queueMutex);
+        bool found{FindFreeBuffer()};
+        if (!found && !async) {
+            // The SVC handler holds JniMtx, it's released during the wait as a frontend request for it would otherwise stall till the wait ends and hold off the presentation loop which frees buffers
+            JniMtx.unlock();
+            found = bufferFreed.wait_for(lock, std::chrono::nanoseconds(constant::DequeueBufferTimeout), FindFreeBuffer);
+            lock.unlock(); // JniMtx is reacquired without holding the queue mutex as the presentation loop acquires them in the opposite order
+            JniMtx.lock();
+        } else {
+            lock.unlock();
+        }
+
+        dequeueWaitTime = static_cast<u32>((util::GetTimeNs() - waitStart) / 10000); // The wait time / 100 is the real ms value, this is to retain the first two decimals
+
+        if (!found) {
+            auto status = async ? AndroidStatus::WouldBlock : AndroidStatus::TimedOut;
+            out.Push<u32>(0);
+            out.Push<u32>(0); // There's no fence
+            out.Push(status);
+
+            state.logger->Debug("DequeueBuffer: No free buffer: Width: {}, Height: {}, Format: {}, Usage: {}, Async: {}, Status: {}", width, height, format, usage, async, static_cast<i32>(status));
+            return;
         }
 
         out.Push(*slot);
         out.Push(std::array<u32, 13>{1, 0x24}); // Unknown
 
-        state.logger->Debug("DequeueBuffer: Width: {}, Height: {}, Format: {}, Usage: {}, Timestamp: {}, Slot: {}", width, height, format, usage, timestamp, *slot);
+        state.logger->Debug("DequeueBuffer: Width: {}, Height: {}, Format: {}, Usage: {}, Async: {}, Slot: {}", width, height, format, usage, async, *slot);
     }
 
     void GraphicBufferProducer::QueueBuffer(Parcel &in, Parcel &out) {
@@ -63,18 +97,23 @@ namespace skyline::service::hosbinder {
             nvdrv::Fence fence[4];
         } &data = in.Pop<Data>();
 
+        std::unique_lock lock(queueMutex);
         auto buffer = queue.at(data.slot);
         buffer->status = BufferStatus::Queued;
+        lock.unlock();
 
         auto slot = data.slot;
         auto bufferEvent = state.gpu->bufferEvent;
         buffer->texture->releaseCallback = [this, slot, bufferEvent]() {
+            std::unique_lock lock(queueMutex);
             queue.at(slot)->status = BufferStatus::Free;
+            lock.unlock();
+
+            bufferFreed.notify_all();
             bufferEvent->Signal();
         };
 
-        buffer->texture->SynchronizeHost();
-        state.gpu->presentationQueue.push(buffer->texture);
+        state.gpu->QueuePresentation(buffer->texture, data.swapInterval); // The texture is converted when it's presented as the guest can't modify the buffer until it's released
 
         struct {
             u32 width;
@@ -93,7 +132,10 @@ namespace skyline::service::hosbinder {
         u32 slot{in.Pop<u32>()};
         //auto fences{in.Pop<std::array<nvdrv::Fence, 4>>()};
 
+        std::unique_lock lock(queueMutex);
         queue.at(slot)->status = BufferStatus::Free;
+        lock.unlock();
+        bufferFreed.notify_all();
 
         state.logger->Debug("CancelBuffer: Slot: {}", slot);
     }
@@ -151,9 +193,16 @@ namespace skyline::service::hosbinder {
                 throw exception("Unknown pixel format used for FB");
         }
 
-        auto texture = std::make_shared<gpu::GuestTexture>(state, nvBuffer->address + gbpBuffer.offset, gpu::texture::Dimensions(gbpBuffer.width, gbpBuffer.height), format, gpu::texture::TileMode::Block, gpu::texture::TileConfig{.surfaceWidth = static_cast<u16>(gbpBuffer.stride), .blockHeight = static_cast<u8>(1U << gbpBuffer.blockHeightLog2), .blockDepth = 1});
+        auto texture = state.gpu->textureCache.GetTexture(nvBuffer->address + gbpBuffer.offset, gpu::texture::Dimensions(gbpBuffer.width, gbpBuffer.height), format, gpu::texture::TileMode::Block, gpu::texture::TileConfig{.surfaceWidth = static_cast<u16>(gbpBuffer.stride), .blockHeight = static_cast<u8>(1U << gbpBuffer.blockHeightLog2), .blockDepth = 1});
+
+        // A buffer which is preallocated again with the same parameters reuses the host texture it had before
+        auto host = texture->host.lock();
+        auto buffer = std::make_shared<Buffer>(gbpBuffer, host ? std::static_pointer_cast<gpu::PresentationTexture>(host) : texture->InitializePresentationTexture());
+        std::unique_lock lock(queueMutex);
+        queue[data.slot] = buffer;
+        lock.unlock();
 
-        queue[data.slot] = std::make_shared<Buffer>(gbpBuffer, texture->InitializePresentationTexture());
+        bufferFreed.notify_all();
         state.gpu->bufferEvent->Signal();
 
         state.logger->Debug("SetPreallocatedBuffer: Slot: {}, Magic: 0x{:X}, Width: {}, Height: {}, Stride: {}, Format: {}, Usage: {}, Index: {}, ID: {}, Handle: {}, Offset: 0x{:X}, Block Height: {}, Size: 0x{:X}", data.slot, gbpBuffer.magic, gbpBuffer.width, gbpBuffer.height, gbpBuffer.stride, gbpBuffer.format, gbpBuffer.usage, gbpBuffer.index, gbpBuffer.nvmapId, gbpBuffer.nvmapHandle, gbpBuffer.offset, (1U << gbpBuffer.blockHeightLog2), gbpBuffer.size);
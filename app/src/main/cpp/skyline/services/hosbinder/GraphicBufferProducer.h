@@ -37,6 +37,15 @@ namespace skyline::service::hosbinder {
         Queued, //!< The buffer is queued to be displayed
     };
 
+    /**
+     * @brief The status codes returned by transactions, these are negated errno values (https://android.googlesource.com/platform/system/core/+/android-7.0.0_r1/include/utils/Errors.h)
+     */
+    enum class AndroidStatus : i32 {
+        Ok = 0, //!< The transaction was successful
+        WouldBlock = -11, //!< An asynchronous transaction would've had to block (-EWOULDBLOCK)
+        TimedOut = -110, //!< A synchronous transaction didn't complete in time (-ETIMEDOUT)
+    };
+
     /**
      * @brief A wrapper over GbpBuffer which contains additional state that we track for a buffer
      */
@@ -73,6 +82,8 @@ namespace skyline::service::hosbinder {
       private:
         const DeviceState &state;
         std::unordered_map<u32, std::shared_ptr<Buffer>> queue; //!< A vector of shared pointers to all the queued buffers
+        std::mutex queueMutex; //!< Synchronizes the status of the buffers as they're released on the presentation thread
+        std::condition_variable bufferFreed; //!< This is notified every time a buffer is freed so DequeueBuffer can stop waiting
 
         /**
          * @brief Request for the GbpBuffer of a buffer
@@ -80,7 +91,7 @@ namespace skyline::service::hosbinder {
         void RequestBuffer(Parcel &in, Parcel &out);
 
         /**
-         * @brief Try to dequeue a free graphics buffer that has been consumed
+         * @brief Dequeue a free graphics buffer, if none are free an asynchronous dequeue fails immediately while a synchronous one waits for the presentation side to release one
          */
         void DequeueBuffer(Parcel &in, Parcel &out);
 
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "thread_pool.h"
+
+namespace skyline {
+    ThreadPool::ThreadPool(size_t workerCount) {
+        threads.reserve(workerCount);
+        for (size_t index{}; index < workerCount; index++)
+            threads.emplace_back(&ThreadPool::Run, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(jobMutex);
+            exit = true;
+        }
+        jobCondition.notify_all();
+
+        for (auto &thread : threads)
+            if (thread.joinable())
+                thread.join();
+    }
+
+    void ThreadPool::Work() {
+        for (auto task = nextTask.fetch_add(1, std::memory_order_relaxed); task < taskCount; task = nextTask.fetch_add(1, std::memory_order_relaxed))
+            (*job)(task);
+    }
+
+    void ThreadPool::Run() {
+        pthread_setname_np(pthread_self(), "ThreadPool");
+
+        u64 lastGeneration{};
+        while (true) {
+            {
+                std::unique_lock lock(jobMutex);
+                jobCondition.wait(lock, [&] { return exit || generation != lastGeneration; });
+                if (exit)
+                    return;
+                lastGeneration = generation;
+            }
+
+            Work();
+
+            std::lock_guard lock(jobMutex);
+            if (--busyWorkers == 0)
+                doneCondition.notify_one();
+        }
+    }
+
+    void ThreadPool::ParallelFor(size_t taskCount, const std::function<void(size_t)> &function) {
+        if (threads.empty() || taskCount <= 1) {
+            for (size_t task{}; task < taskCount; task++)
+                function(task);
+            return;
+        }
+
+        std::lock_guard submitLock(submitMutex);
+        {
+            std::lock_guard lock(jobMutex);
+            job = &function;
+            this->taskCount = taskCount;
+            nextTask.store(0, std::memory_order_relaxed);
+            busyWorkers = threads.size();
+            generation++;
+        }
+        jobCondition.notify_all();
+
+        Work();
+
+        std::unique_lock lock(jobMutex);
+        doneCondition.wait(lock, [&] { return busyWorkers == 0; });
+        job = nullptr;
+    }
+}
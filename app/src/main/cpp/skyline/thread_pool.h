@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include "common.h"
+
+namespace skyline {
+    /**
+     * @brief A pool of worker threads which is used to split up data-parallel work, the calling thread participates in the work as well
+     */
+    class ThreadPool {
+      private:
+        std::vector<std::thread> threads;
+        std::mutex submitMutex; //!< This mutex is used to ensure only a single job is running at a time
+        std::mutex jobMutex; //!< This mutex is used to synchronize the job state between the submitter and the workers
+        std::condition_variable jobCondition; //!< This is signalled when a job is submitted or the pool is exiting
+        std::condition_variable doneCondition; //!< This is signalled when the last worker is done with the current job
+        const std::function<void(size_t)> *job{}; //!< The function of the current job, it's called with the index of a task
+        size_t taskCount{}; //!< The amount of tasks in the current job
+        std::atomic<size_t> nextTask{}; //!< The index of the next task in the current job that hasn't been picked up
+        size_t busyWorkers{}; //!< The amount of workers which haven't finished the current job
+        u64 generation{}; //!< A counter which is incremented for every job so workers can tell a new job apart from a spurious wakeup
+        bool exit{}; //!< If the workers should exit
+
+        /**
+         * @brief Runs tasks from the current job until there are none left
+         */
+        void Work();
+
+        /**
+         * @brief The entry point of the worker threads
+         */
+        void Run();
+
+      public:
+        /**
+         * @param workerCount The amount of worker threads to create in addition to the calling thread
+         */
+        ThreadPool(size_t workerCount);
+
+        ~ThreadPool();
+
+        /**
+         * @return The amount of threads that work on a job, this includes the calling thread
+         */
+        inline size_t GetThreadCount() {
+            return threads.size() + 1;
+        }
+
+        /**
+         * @brief Runs a function for every task index in [0, taskCount) across the pool and returns once all of them are done
+         * @note The function must not throw as exceptions can't be propagated from the workers
+         */
+        void ParallelFor(size_t taskCount, const std::function<void(size_t)> &function);
+    };
+}
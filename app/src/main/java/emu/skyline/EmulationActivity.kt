@@ -23,6 +23,11 @@ import kotlin.math.abs
 class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTouchListener {
     companion object {
         private val Tag = EmulationActivity::class.java.name
+
+        /**
+         * The amount of values returned by [getSvcStatistics] for every SVC
+         */
+        private const val SvcStatisticsStride = 34
     }
 
     init {
@@ -111,6 +116,32 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
      */
     private external fun getFrametime() : Float
 
+    /**
+     * This returns the time the application last spent waiting for a free buffer to render into
+     */
+    private external fun getDequeueWaitTime() : Float
+
+    /**
+     * This returns the statistics of vsync and frame pacing, it's empty when emulation isn't running
+     *
+     * @note The values are the vsync count, the missed vsync count, the maximum vsync lateness, the presented frame count, the average frame-time and the maximum frame-time, all times are in nanoseconds
+     */
+    private external fun getFrameStatistics() : LongArray
+
+    /**
+     * This returns the amount of times every guest thread was migrated between host CPUs, it's empty when emulation isn't running
+     *
+     * @note Every thread has 2 consecutive values: the TID of the thread and the amount of migrations
+     */
+    private external fun getThreadMigrations() : LongArray
+
+    /**
+     * This returns the statistics of every SVC dispatched by the guest, it's empty when emulation isn't running
+     *
+     * @note Every SVC ID has 34 consecutive values: the amount of calls, the total time spent in it in nanoseconds and a 32-bucket log2 latency histogram
+     */
+    private external fun getSvcStatistics() : LongArray
+
     /**
      * This initializes a guest controller in libskyline
      *
@@ -235,7 +266,19 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
         if (sharedPreferences.getBoolean("perf_stats", false)) {
             perf_stats.postDelayed(object : Runnable {
                 override fun run() {
-                    perf_stats.text = "${getFps()} FPS\n${getFrametime()}ms"
+                    val frameStatistics = getFrameStatistics()
+                    perf_stats.text = "${getFps()} FPS\n${getFrametime()}ms\n${getDequeueWaitTime()}ms wait"
+                    if (frameStatistics.size == 6)
+                        perf_stats.append("\n${frameStatistics[1]} missed vsyncs\n${frameStatistics[4] / 10000 / 100f}ms avg, ${frameStatistics[5] / 10000 / 100f}ms max")
+                    val threadMigrations = getThreadMigrations()
+                    if (threadMigrations.isNotEmpty())
+                        perf_stats.append("\n${threadMigrations.filterIndexed { index, _ -> index % 2 == 1 }.sum()} CPU migrations")
+                    val svcStatistics = getSvcStatistics()
+                    (0 until svcStatistics.size / SvcStatisticsStride).maxBy { svcStatistics[it * SvcStatisticsStride + 1] }?.let { svc ->
+                        val calls = svcStatistics[svc * SvcStatisticsStride]
+                        if (calls != 0L)
+                            perf_stats.append("\nSVC 0x${"%02X".format(svc)}: $calls calls, ${svcStatistics[svc * SvcStatisticsStride + 1] / 10000 / 100f}ms")
+                    }
                     perf_stats.postDelayed(this, 250)
                 }
             }, 250)
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <benchmark/benchmark.h>
+#include <gpu/engines/maxwell_3d.h>
+#include "support/host_state.h"
+#include "support/macro_assembler.h"
+
+namespace skyline::test {
+    using namespace macro;
+
+    /**
+     * @brief This holds a macro that's representative of those uploaded by titles along with a function to generate its arguments
+     */
+    struct RepresentativeMacro {
+        std::vector<u32> code;
+        std::vector<u32> (*arguments)(u32 count);
+    };
+
+    /**
+     * @brief A state macro which packs its two arguments into a register and writes their sum to another, it's straight-line code which is run once per state change
+     */
+    const RepresentativeMacro PackState{
+        {
+            AddImmediate(Assign::IgnoreAndFetch, 2, 0, 0),
+            Bitfield(Operation::BitfieldReplace, Assign::Move, 3, 1, 2, 0, 16, 16),
+            AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(0x300, 0)),
+            AddImmediate(Assign::MoveAndSend, 0, 3, 0),
+            AluRegister(Alu::Add, Assign::Move, 4, 1, 2),
+            AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(0x301, 0)),
+            AddImmediate(Assign::MoveAndSend, 0, 4, 0) | Exit,
+            Nop,
+        },
+        [](u32) -> std::vector<u32> {
+            return {0x1234, 0x5678};
+        },
+    };
+
+    /**
+     * @brief A macro which writes a variable amount of arguments to consecutive registers, this is how constant buffer updates and vertex attribute arrays are commonly bound
+     */
+    const RepresentativeMacro BindRegisters{
+        {
+            AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(0x200, 1)),
+            AddImmediate(Assign::Move, 1, 1, -1),
+            AddImmediate(Assign::IgnoreAndFetch, 2, 0, 0),
+            Branch(true, 1, -2),
+            AddImmediate(Assign::MoveAndSend, 0, 2, 0), // Delay slot
+            Nop | Exit,
+            Nop,
+        },
+        [](u32 count) {
+            std::vector<u32> arguments(count + 1);
+            arguments[0] = count;
+            for (u32 index{1}; index <= count; index++)
+                arguments[index] = index * 0x10;
+            return arguments;
+        },
+    };
+
+    /**
+     * @brief A macro which loops over draws like the instanced and indirect draw helpers do, every iteration reads a register and mixes ALU, bitfield and send operations
+     */
+    const RepresentativeMacro MultiDraw{
+        {
+            AddImmediate(Assign::MoveAndSetMethod, 2, 0, Method(0x100, 1)),
+            AddImmediate(Assign::IgnoreAndFetch, 3, 0, 0),
+            AluRegister(Alu::Add, Assign::MoveAndSend, 4, 3, 1),
+            Bitfield(Operation::BitfieldReplace, Assign::Move, 5, 4, 1, 0, 8, 8),
+            AluRegister(Alu::BitwiseXor, Assign::MoveAndSend, 6, 5, 4),
+            ReadImmediate(Assign::Move, 7, 0, 0x20),
+            AluRegister(Alu::BitwiseOr, Assign::Move, 7, 7, 6),
+            AddImmediate(Assign::Move, 1, 1, -1),
+            Branch(true, 1, -6),
+            AddImmediate(Assign::Move, 3, 3, 7), // Delay slot
+            Nop | Exit,
+            Nop,
+        },
+        [](u32 count) -> std::vector<u32> {
+            return {count, 5};
+        },
+    };
+
+    /**
+     * @brief The ways a macro can be executed in
+     */
+    enum class Executor {
+        Interpreter, //!< The decoding MacroInterpreter
+        Threaded, //!< The MacroThreadedInterpreter without high-level implementations
+        Hle, //!< The MacroThreadedInterpreter with high-level implementations
+    };
+
+    /**
+     * @brief This benchmarks executing a macro with one of the executors
+     * @note The argument of the benchmark is the amount of iterations for macros with a loop
+     */
+    void MacroExecution(benchmark::State &benchmark, const RepresentativeMacro &macro, Executor executor) {
+        BoolSettings["macro_hle"] = executor == Executor::Hle;
+        HostState host;
+        gpu::engine::Maxwell3D maxwell3D(host.state);
+        std::copy(macro.code.begin(), macro.code.end(), maxwell3D.macroCode.begin());
+
+        gpu::MacroInterpreter interpreter(maxwell3D);
+        gpu::MacroHle hle(host.state);
+        gpu::MacroThreadedInterpreter threadedInterpreter(host.state, maxwell3D, interpreter, hle);
+        BoolSettings.clear();
+
+        auto arguments{macro.arguments(static_cast<u32>(benchmark.range(0)))};
+        for (auto _ : benchmark) {
+            if (executor == Executor::Interpreter)
+                interpreter.Execute(0, arguments);
+            else
+                threadedInterpreter.Execute(0, arguments);
+            benchmark::DoNotOptimize(maxwell3D.registers.raw.data());
+        }
+
+        benchmark.SetItemsProcessed(benchmark.iterations());
+    }
+
+    BENCHMARK_CAPTURE(MacroExecution, PackStateInterpreted, PackState, Executor::Interpreter)->Arg(0);
+    BENCHMARK_CAPTURE(MacroExecution, PackStateThreaded, PackState, Executor::Threaded)->Arg(0);
+    BENCHMARK_CAPTURE(MacroExecution, BindRegistersInterpreted, BindRegisters, Executor::Interpreter)->Arg(4)->Arg(64);
+    BENCHMARK_CAPTURE(MacroExecution, BindRegistersThreaded, BindRegisters, Executor::Threaded)->Arg(4)->Arg(64);
+    BENCHMARK_CAPTURE(MacroExecution, BindRegistersHle, BindRegisters, Executor::Hle)->Arg(4)->Arg(64);
+    BENCHMARK_CAPTURE(MacroExecution, MultiDrawInterpreted, MultiDraw, Executor::Interpreter)->Arg(4)->Arg(64)->Arg(1000);
+    BENCHMARK_CAPTURE(MacroExecution, MultiDrawThreaded, MultiDraw, Executor::Threaded)->Arg(4)->Arg(64)->Arg(1000);
+
+    /**
+     * @brief This benchmarks decoding a macro after its code was rewritten, this is the cost of every macro upload
+     */
+    void MacroDecode(benchmark::State &benchmark) {
+        HostState host;
+        gpu::engine::Maxwell3D maxwell3D(host.state);
+        std::copy(MultiDraw.code.begin(), MultiDraw.code.end(), maxwell3D.macroCode.begin());
+
+        gpu::MacroInterpreter interpreter(maxwell3D);
+        auto arguments{MultiDraw.arguments(1)};
+        for (auto _ : benchmark) {
+            interpreter.InvalidateCode(0, MultiDraw.code.size());
+            interpreter.Execute(0, arguments);
+        }
+    }
+
+    BENCHMARK(MacroDecode);
+}
@@ -0,0 +1,279 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <random>
+#include <gtest/gtest.h>
+#include <gpu/engines/maxwell_3d.h>
+#include "support/host_state.h"
+#include "support/macro_assembler.h"
+
+namespace skyline::test {
+    using namespace macro;
+
+    /**
+     * @brief A macro which overwrites its own first opcode through the macro upload methods, this invalidates it while it's executing
+     */
+    const std::vector<u32> SelfModifyingMacro{
+        AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(MAXWELL3D_OFFSET(mme.instructionRamPointer), 0)),
+        AddImmediate(Assign::MoveAndSend, 0, 0, 0),
+        AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(MAXWELL3D_OFFSET(mme.instructionRamLoad), 0)),
+        AddImmediate(Assign::MoveAndSend, 0, 0, 0),
+        AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(0x300, 0)),
+        AddImmediate(Assign::MoveAndSend, 0, 0, 42) | Exit,
+        Nop,
+    };
+
+    /**
+     * @brief Uploads a macro into macro memory and binds it to a macro index in the same way as a pushbuffer would
+     */
+    void UploadMacro(gpu::engine::Maxwell3D &maxwell3D, u32 index, u32 offset, const std::vector<u32> &code) {
+        auto CallMethod{[&](u32 method, u32 argument) {
+            maxwell3D.CallMethod(gpu::MethodParams{static_cast<u16>(method), argument, 0, true});
+        }};
+
+        CallMethod(MAXWELL3D_OFFSET(mme.instructionRamPointer), offset);
+        for (auto opcode : code)
+            CallMethod(MAXWELL3D_OFFSET(mme.instructionRamLoad), opcode);
+
+        CallMethod(MAXWELL3D_OFFSET(mme.startAddressRamPointer), index);
+        CallMethod(MAXWELL3D_OFFSET(mme.startAddressRamLoad), offset);
+    }
+
+    /**
+     * @brief Calls a macro with the given arguments in the same way as a pushbuffer would
+     */
+    void CallMacro(gpu::engine::Maxwell3D &maxwell3D, u32 index, std::span<const u32> arguments) {
+        maxwell3D.CallMethodBatch(static_cast<u16>(constant::Maxwell3DRegisterCounter + (index * 2)), arguments, 0, gpu::IncrementMode::IncrementOnce);
+    }
+
+    TEST(MacroInterpreter, SelfModifyingMacro) {
+        for (bool threaded : {false, true}) {
+            BoolSettings["macro_threaded_interpreter"] = threaded;
+            HostState host;
+            gpu::engine::Maxwell3D maxwell3D(host.state);
+
+            UploadMacro(maxwell3D, 1, 0, SelfModifyingMacro);
+            CallMacro(maxwell3D, 1, std::array<u32, 1>{});
+
+            EXPECT_EQ(maxwell3D.macroCode[0], 0);
+            EXPECT_EQ(maxwell3D.registers.raw[0x300], 42);
+        }
+        BoolSettings.clear();
+    }
+
+    /**
+     * @brief This generates random macros which are valid and always exit, they only send to methods without side effects and end by sending all of their registers
+     * @details Branches only go forwards except for the branch of an optional loop around the random code which uses register 7 as its counter
+     */
+    class RandomMacroGenerator {
+      private:
+        static constexpr size_t BodySize{32}; //!< The amount of random opcodes in a macro
+        static constexpr u16 MethodBase{0x200}; //!< The lowest method the random code sends to, every method till 0x600 is free of side effects
+        static constexpr u16 ResultMethod{0x580}; //!< The method the registers are sent to at the end of a macro
+
+        std::mt19937 random;
+
+        u32 Pick(u32 max) {
+            return std::uniform_int_distribution<u32>(0, max)(random);
+        }
+
+        u8 PickRegister(bool loop) {
+            return static_cast<u8>(Pick(loop ? 6 : 7));
+        }
+
+        /**
+         * @brief Picks an assignment that doesn't set the method address as that's only set to known methods
+         */
+        Assign PickAssignment() {
+            constexpr std::array<Assign, 4> Assignments{Assign::IgnoreAndFetch, Assign::Move, Assign::FetchAndSend, Assign::MoveAndSend};
+            return Assignments[Pick(Assignments.size() - 1)];
+        }
+
+        i32 PickMethod() {
+            return Method(static_cast<u16>(MethodBase + Pick(0x1FF)), static_cast<u8>(Pick(3)));
+        }
+
+        /**
+         * @param position The position of the opcode in the body
+         * @param canBranch If the opcode is allowed to be a branch, it isn't inside delay slots or at the end of the body where its delay slot would be outside the body
+         */
+        std::vector<u32> Opcode(size_t position, bool canBranch, bool loop) {
+            auto dest{PickRegister(loop)}, srcA{PickRegister(loop)}, srcB{PickRegister(loop)};
+            switch (Pick(canBranch ? 8 : 7)) {
+                case 0: {
+                    constexpr std::array<Alu, 9> Operations{Alu::Add, Alu::AddWithCarry, Alu::Subtract, Alu::SubtractWithBorrow, Alu::BitwiseXor, Alu::BitwiseOr, Alu::BitwiseAnd, Alu::BitwiseAndNot, Alu::BitwiseNand};
+                    return {AluRegister(Operations[Pick(Operations.size() - 1)], PickAssignment(), dest, srcA, srcB)};
+                }
+                case 1:
+                    return {AddImmediate(PickAssignment(), dest, srcA, static_cast<i32>(Pick(0x3FFFF)) - 0x20000)};
+                case 2:
+                    return {Bitfield(Operation::BitfieldReplace, PickAssignment(), dest, srcA, srcB, static_cast<u8>(Pick(31)), static_cast<u8>(Pick(31)), static_cast<u8>(Pick(31)))};
+                case 3:
+                case 4: {
+                    // The shift amount is in a register so it's set to a valid amount first
+                    auto operation{Pick(1) ? Operation::BitfieldExtractShiftLeftImmediate : Operation::BitfieldExtractShiftLeftRegister};
+                    return {
+                        AddImmediate(Assign::Move, srcA, 0, static_cast<i32>(Pick(31))),
+                        Bitfield(operation, PickAssignment(), dest, srcA, srcB, static_cast<u8>(Pick(31)), static_cast<u8>(Pick(31)), static_cast<u8>(Pick(31))),
+                    };
+                }
+                case 5:
+                    return {ReadImmediate(PickAssignment(), dest, 0, static_cast<i32>(Pick(constant::Maxwell3DRegisterCounter - 1)))};
+                case 6: {
+                    constexpr std::array<Assign, 4> Assignments{Assign::MoveAndSetMethod, Assign::FetchAndSetMethod, Assign::MoveAndSetMethodThenFetchAndSend, Assign::MoveAndSetMethodThenSendHigh};
+                    return {AddImmediate(Assignments[Pick(Assignments.size() - 1)], dest, 0, PickMethod())};
+                }
+                case 7:
+                    return {AddImmediate(PickAssignment(), dest, srcA, 0) | (Pick(7) ? 0 : Exit)};
+                default:
+                    return {Branch(Pick(1), srcA, static_cast<i32>(1 + Pick(static_cast<u32>(BodySize - position - 1))), Pick(1))};
+            }
+        }
+
+      public:
+        RandomMacroGenerator(u32 seed) : random(seed) {}
+
+        std::vector<u32> Generate() {
+            bool loop{Pick(1) != 0};
+            std::vector<u32> code{AddImmediate(Assign::MoveAndSetMethod, 0, 0, PickMethod())};
+            if (loop)
+                code.push_back(AddImmediate(Assign::Move, 7, 0, static_cast<i32>(1 + Pick(3))));
+
+            size_t bodyStart{code.size()};
+            bool canBranch{true};
+            while (code.size() - bodyStart < BodySize) {
+                auto position{code.size() - bodyStart};
+                auto opcodes{Opcode(position, canBranch && position + 1 < BodySize, loop)};
+                canBranch = !(opcodes.back() & Exit) && (opcodes.back() & 0x7) != static_cast<u32>(Operation::Branch);
+                code.insert(code.end(), opcodes.begin(), opcodes.end());
+            }
+
+            if (loop) {
+                code.push_back(AddImmediate(Assign::Move, 7, 7, -1));
+                code.push_back(Branch(true, 7, -static_cast<i32>(code.size() - bodyStart)));
+                code.push_back(AddImmediate(PickAssignment(), PickRegister(true), PickRegister(true), static_cast<i32>(Pick(0xFF)))); // Delay slot
+            }
+
+            code.push_back(AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(ResultMethod, 1)));
+            for (u8 reg{1}; reg < 8; reg++)
+                code.push_back(AddImmediate(Assign::MoveAndSend, 0, reg, 0));
+            code.back() |= Exit;
+            code.push_back(Nop);
+
+            return code;
+        }
+    };
+
+    /**
+     * @brief This runs random macros through both the MacroInterpreter and the MacroThreadedInterpreter and checks that they have the same effect on the Maxwell 3D registers
+     */
+    TEST(MacroThreadedInterpreter, MatchesInterpreter) {
+        RandomMacroGenerator generator(0x5EED);
+        std::vector<u32> arguments(0x200);
+        std::iota(arguments.begin(), arguments.end(), 0x1000);
+
+        for (size_t iteration{}; iteration < 1000; iteration++) {
+            auto code{generator.Generate()};
+
+            std::array<std::array<u32, constant::Maxwell3DRegisterCounter>, 2> results{};
+            for (bool threaded : {false, true}) {
+                BoolSettings["macro_threaded_interpreter"] = threaded;
+                HostState host;
+                gpu::engine::Maxwell3D maxwell3D(host.state);
+
+                UploadMacro(maxwell3D, 1, 0x100, code);
+                CallMacro(maxwell3D, 1, arguments);
+                results[threaded] = maxwell3D.registers.raw;
+            }
+
+            ASSERT_EQ(results[0], results[1]) << "Macro " << iteration << " has different results";
+        }
+        BoolSettings.clear();
+    }
+
+    /**
+     * @brief A macro which can be replaced by a high-level implementation along with the arguments to call it with
+     */
+    struct HleMacroCase {
+        std::string_view implementation; //!< The name of the implementation that should replace the macro, this is empty if the macro shouldn't be replaced
+        std::vector<u32> code;
+        std::vector<u32> arguments;
+        u32 shadowRamControl{}; //!< The shadow RAM mode that's set before the macro is called
+    };
+
+    /**
+     * @return The code of a macro which writes a counted run of arguments to consecutive methods
+     */
+    std::vector<u32> WriteRegistersMacro(u16 method, u8 increment, u32 delaySlot = AddImmediate(Assign::MoveAndSend, 0, 2, 0)) {
+        return {
+            AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(method, increment)),
+            AddImmediate(Assign::Move, 1, 1, -1),
+            AddImmediate(Assign::IgnoreAndFetch, 2, 0, 0),
+            Branch(true, 1, -2),
+            delaySlot,
+            Nop | Exit,
+            Nop,
+        };
+    }
+
+    /**
+     * @return The arguments for WriteRegistersMacro that write a run of the supplied length
+     */
+    std::vector<u32> WriteRegistersArguments(u32 count) {
+        std::vector<u32> arguments(count + 1);
+        arguments[0] = count;
+        for (u32 index{1}; index <= count; index++)
+            arguments[index] = index * 0x101;
+        return arguments;
+    }
+
+    /**
+     * @brief This checks that high-level implementations replace the macros they're meant to and have the same effect on the Maxwell 3D as interpreting them
+     */
+    TEST(MacroHle, MatchesInterpreter) {
+        const std::vector<u32> writeRegister{
+            AddImmediate(Assign::MoveAndSetMethod, 0, 0, Method(0x345, 3)),
+            AddImmediate(Assign::MoveAndSend, 0, 1, 0) | Exit,
+            Nop,
+        };
+
+        const std::vector<HleMacroCase> cases{
+            {"WriteRegister", writeRegister, {0xCAFE}},
+            {"WriteRegister", writeRegister, {0xCAFE}, 1}, // MethodTrack
+            {"WriteRegisters", WriteRegistersMacro(0x200, 1), WriteRegistersArguments(1)},
+            {"WriteRegisters", WriteRegistersMacro(0x200, 1), WriteRegistersArguments(64)},
+            {"WriteRegisters", WriteRegistersMacro(0x200, 1), WriteRegistersArguments(64), 1}, // MethodTrack
+            {"WriteRegisters", WriteRegistersMacro(0x200, 1), WriteRegistersArguments(64), 2}, // MethodReplay
+            {"WriteRegisters", WriteRegistersMacro(0x300, 0), WriteRegistersArguments(16)},
+            {"WriteRegisters", WriteRegistersMacro(0x400, 3), WriteRegistersArguments(16)},
+            {"", WriteRegistersMacro(0x200, 1, AddImmediate(Assign::MoveAndSend, 0, 2, 1)), WriteRegistersArguments(8)},
+        };
+
+        for (const auto &macroCase : cases) {
+            std::array<std::array<u32, constant::Maxwell3DRegisterCounter>, 2> results{};
+            for (bool hle : {false, true}) {
+                BoolSettings["macro_hle"] = hle;
+                HostState host;
+                gpu::engine::Maxwell3D maxwell3D(host.state);
+
+                maxwell3D.CallMethod(gpu::MethodParams{static_cast<u16>(MAXWELL3D_OFFSET(mme.shadowRamControl)), macroCase.shadowRamControl, 0, true});
+                UploadMacro(maxwell3D, 1, 0x80, macroCase.code);
+                CallMacro(maxwell3D, 1, macroCase.arguments);
+                results[hle] = maxwell3D.registers.raw;
+
+                auto &entry{maxwell3D.macroHle.GetEntry(0, macroCase.code)};
+                EXPECT_EQ(entry.executions, 1);
+                if (hle && !macroCase.implementation.empty()) {
+                    ASSERT_NE(entry.implementation, nullptr);
+                    EXPECT_EQ(entry.implementation->name, macroCase.implementation);
+                    EXPECT_EQ(entry.hits, 1);
+                } else {
+                    EXPECT_EQ(entry.hits, 0);
+                }
+            }
+
+            EXPECT_EQ(results[0], results[1]) << "Macro replaced by '" << macroCase.implementation << "' has different results";
+        }
+        BoolSettings.clear();
+    }
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <benchmark/benchmark.h>
+#include "support/host_state.h"
+
+namespace skyline::test {
+    constexpr size_t MappedPages{64}; //!< The amount of GPU pages which are mapped for the benchmark
+
+    /**
+     * @brief This holds a region of the GPU address space which is backed by host memory
+     */
+    struct MappedRegion {
+        HostState host;
+        std::vector<u8> memory;
+        u64 address; //!< The address of the region in the GPU address space
+
+        /**
+         * @param fragmented If every GPU page is backed by a separate host mapping which isn't adjacent to the others, the region is a single host mapping otherwise
+         */
+        MappedRegion(bool fragmented) : memory(MappedPages * constant::GpuPageSize * (fragmented ? 2 : 1), 0xAB) {
+            auto &memoryManager{host.state.gpu->memoryManager};
+            auto cpuAddress{reinterpret_cast<u64>(memory.data())};
+            if (!fragmented) {
+                host.process->mappings[cpuAddress] = memory.size();
+                address = memoryManager.MapAllocate(cpuAddress, memory.size());
+                return;
+            }
+
+            address = memoryManager.ReserveSpace(MappedPages * constant::GpuPageSize);
+            for (size_t page{}; page < MappedPages; page++) {
+                auto pageAddress{cpuAddress + (page * 2 * constant::GpuPageSize)};
+                host.process->mappings[pageAddress] = constant::GpuPageSize;
+                memoryManager.MapFixed(address + (page * constant::GpuPageSize), pageAddress, constant::GpuPageSize);
+            }
+        }
+    };
+
+    /**
+     * @brief This benchmarks fetching a pushbuffer segment which starts in the middle of a GPU page, as GPFIFO::PushBuffer::Fetch does
+     * @param fragmented If the segment crosses host mappings, it has to be copied in that case
+     * @param hostSpans If the segment is fetched with GetHostSpans and only copied when it isn't contiguous, it's always copied with Read otherwise
+     * @note The argument of the benchmark is the size of the segment in bytes
+     */
+    void FetchSegment(benchmark::State &benchmark, bool fragmented, bool hostSpans) {
+        MappedRegion region(fragmented);
+        auto &memoryManager{region.host.state.gpu->memoryManager};
+        auto address{region.address + (constant::GpuPageSize / 2)};
+        auto size{static_cast<u64>(benchmark.range(0))};
+
+        std::vector<u8> segmentBuffer(size);
+        for (auto _ : benchmark) {
+            const u8 *segment{segmentBuffer.data()};
+            if (hostSpans) {
+                auto spans{memoryManager.GetHostSpans(address, size)};
+                if (spans.size() == 1) {
+                    segment = spans.front().data();
+                } else {
+                    auto destination{segmentBuffer.data()};
+                    for (auto span : spans) {
+                        std::memcpy(destination, span.data(), span.size());
+                        destination += span.size();
+                    }
+                }
+            } else {
+                memoryManager.Read(segmentBuffer.data(), address, size);
+            }
+            benchmark::DoNotOptimize(segment);
+            benchmark::ClobberMemory();
+        }
+
+        benchmark.SetBytesProcessed(static_cast<i64>(benchmark.iterations() * size));
+    }
+
+    BENCHMARK_CAPTURE(FetchSegment, ContiguousRead, false, false)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+    BENCHMARK_CAPTURE(FetchSegment, ContiguousHostSpans, false, true)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+    BENCHMARK_CAPTURE(FetchSegment, FragmentedRead, true, false)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+    BENCHMARK_CAPTURE(FetchSegment, FragmentedHostSpans, true, true)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+}
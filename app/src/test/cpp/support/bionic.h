@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+// This is included into every host translation unit, it supplies the bionic extensions that the sources use which aren't present in glibc
+
+#include <sys/cdefs.h>
+
+#ifndef __predict_false
+#define __predict_true(exp) __builtin_expect((exp) != 0, 1) // NOLINT(cppcoreguidelines-macro-usage)
+#define __predict_false(exp) __builtin_expect((exp) != 0, 0) // NOLINT(cppcoreguidelines-macro-usage)
+#endif
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 4096 // NOLINT(cppcoreguidelines-macro-usage)
+#endif
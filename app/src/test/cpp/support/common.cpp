@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <cstdio>
+#include <gpu.h>
+#include <kernel/types/KProcess.h>
+#include <common.h>
+#include "host_state.h"
+
+// This replaces common.cpp on the host, it doesn't read preferences or write log files and the device state only has a GPU
+namespace skyline {
+    namespace test {
+        std::unordered_map<std::string, bool> BoolSettings;
+    }
+
+    void Mutex::lock() {
+        while (flag.test_and_set(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    Settings::Settings(int fd) {}
+
+    bool Settings::GetBool(const std::string &key) {
+        auto setting{test::BoolSettings.find(key)};
+        return (setting != test::BoolSettings.end()) ? setting->second : true;
+    }
+
+    Logger::Logger(const std::string &path, LogLevel configLevel) : configLevel(configLevel) {}
+
+    Logger::~Logger() {}
+
+    void Logger::Write(LogLevel level, std::string str) {
+        std::lock_guard guard(mtx);
+        std::fprintf(stderr, "%s|%s\n", levelStr[static_cast<u8>(level)], str.c_str());
+    }
+
+    DeviceState::DeviceState(kernel::OS *os, std::shared_ptr<kernel::type::KProcess> &process, std::shared_ptr<JvmManager> jvmManager, std::shared_ptr<Settings> settings, std::shared_ptr<Logger> logger)
+        : os(os), jvm(std::move(jvmManager)), settings(std::move(settings)), logger(std::move(logger)), process(process) {
+        gpu = std::make_shared<gpu::GPU>(*this);
+    }
+
+    thread_local std::shared_ptr<kernel::type::KThread> DeviceState::thread = nullptr;
+    thread_local ThreadContext *DeviceState::ctx = nullptr;
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <gpu/memory_manager.h>
+#include <gpu/syncpoint.h>
+
+namespace skyline::gpu {
+    /**
+     * @brief A host replacement for the GPU class which only holds the state that the GPU code under test accesses, it has no presentation or Vulkan state
+     */
+    class GPU {
+      public:
+        vmm::MemoryManager memoryManager;
+        std::array<Syncpoint, constant::MaxHwSyncpointCount> syncpoints{};
+
+        GPU(const DeviceState &state) : memoryManager(state) {}
+    };
+}
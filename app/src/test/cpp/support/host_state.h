@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <gpu.h>
+#include <kernel/types/KProcess.h>
+
+namespace skyline::test {
+    extern std::unordered_map<std::string, bool> BoolSettings; //!< The values of boolean preferences on the host, any preference that isn't in here is enabled so optional paths are exercised by default
+
+    /**
+     * @brief This holds a device state for the code under test along with the objects that it refers to
+     */
+    struct HostState {
+        std::shared_ptr<kernel::type::KProcess> process{std::make_shared<kernel::type::KProcess>()};
+        DeviceState state{nullptr, process, nullptr, std::make_shared<Settings>(-1), std::make_shared<Logger>("", Logger::LogLevel::Warn)};
+    };
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::kernel::type {
+    /**
+     * @brief A host replacement for the KProcess class which backs guest memory with host memory at identical addresses
+     * @details Only the memory accessors the GPU code under test uses are provided, every mapping is a separate host mapping so a region that crosses mappings isn't contiguous even if the mappings are adjacent
+     */
+    class KProcess {
+      public:
+        std::map<u64, u64> mappings; //!< The size of every host mapping that backs guest memory keyed by its address
+
+        u64 GetHostAddress(u64 address) {
+            return GetHostSpan(address, 1).empty() ? 0 : address;
+        }
+
+        u64 GetHostAddress(u64 address, size_t size) {
+            return (GetHostSpan(address, size).size() == size) ? address : 0;
+        }
+
+        std::span<u8> GetHostSpan(u64 address, size_t size) {
+            auto mapping{mappings.upper_bound(address)};
+            if (mapping == mappings.begin() || address - std::prev(mapping)->first >= std::prev(mapping)->second)
+                return {};
+
+            mapping--;
+            return std::span(reinterpret_cast<u8 *>(address), std::min<u64>(size, mapping->first + mapping->second - address));
+        }
+
+        /**
+         * @note The mapping is looked up like KProcess does before copying so the cost of an access is comparable, there's no guest fallback for unmapped memory
+         */
+        void ReadMemory(void *destination, u64 offset, size_t size, bool forceGuest = false) {
+            if (!GetHostAddress(offset))
+                throw exception("Reading unmapped host memory: 0x{:X}", offset);
+            std::memcpy(destination, reinterpret_cast<void *>(offset), size);
+        }
+
+        void WriteMemory(const void *source, u64 offset, size_t size, bool forceGuest = false) {
+            if (!GetHostAddress(offset))
+                throw exception("Writing unmapped host memory: 0x{:X}", offset);
+            std::memcpy(reinterpret_cast<void *>(offset), source, size);
+        }
+    };
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+/**
+ * @brief This assembles Maxwell macro opcodes, the field layout matches MacroInterpreter::Opcode
+ */
+namespace skyline::test::macro {
+    enum class Operation : u32 {
+        AluRegister = 0,
+        AddImmediate = 1,
+        BitfieldReplace = 2,
+        BitfieldExtractShiftLeftImmediate = 3,
+        BitfieldExtractShiftLeftRegister = 4,
+        ReadImmediate = 5,
+        Branch = 7,
+    };
+
+    enum class Assign : u32 {
+        IgnoreAndFetch = 0,
+        Move = 1,
+        MoveAndSetMethod = 2,
+        FetchAndSend = 3,
+        MoveAndSend = 4,
+        FetchAndSetMethod = 5,
+        MoveAndSetMethodThenFetchAndSend = 6,
+        MoveAndSetMethodThenSendHigh = 7,
+    };
+
+    enum class Alu : u32 {
+        Add = 0,
+        AddWithCarry = 1,
+        Subtract = 2,
+        SubtractWithBorrow = 3,
+        BitwiseXor = 8,
+        BitwiseOr = 9,
+        BitwiseAnd = 10,
+        BitwiseAndNot = 11,
+        BitwiseNand = 12,
+    };
+
+    constexpr u32 Exit{1 << 7}; //!< This can be ORed into any opcode to exit after its delay slot
+
+    constexpr u32 Encode(Operation operation, Assign assign, u8 dest, u8 srcA) {
+        return static_cast<u32>(operation) | (static_cast<u32>(assign) << 4) | (static_cast<u32>(dest) << 8) | (static_cast<u32>(srcA) << 11);
+    }
+
+    constexpr u32 AluRegister(Alu alu, Assign assign, u8 dest, u8 srcA, u8 srcB) {
+        return Encode(Operation::AluRegister, assign, dest, srcA) | (static_cast<u32>(srcB) << 14) | (static_cast<u32>(alu) << 17);
+    }
+
+    constexpr u32 AddImmediate(Assign assign, u8 dest, u8 srcA, i32 immediate) {
+        return Encode(Operation::AddImmediate, assign, dest, srcA) | (static_cast<u32>(immediate) << 14);
+    }
+
+    constexpr u32 ReadImmediate(Assign assign, u8 dest, u8 srcA, i32 immediate) {
+        return Encode(Operation::ReadImmediate, assign, dest, srcA) | (static_cast<u32>(immediate) << 14);
+    }
+
+    constexpr u32 Bitfield(Operation operation, Assign assign, u8 dest, u8 srcA, u8 srcB, u8 srcBit, u8 size, u8 destBit) {
+        return Encode(operation, assign, dest, srcA) | (static_cast<u32>(srcB) << 14) | (static_cast<u32>(srcBit) << 17) | (static_cast<u32>(size) << 22) | (static_cast<u32>(destBit) << 27);
+    }
+
+    /**
+     * @param offset The offset of the target from the branch in opcodes
+     */
+    constexpr u32 Branch(bool nonZero, u8 srcA, i32 offset, bool noDelay = false) {
+        return static_cast<u32>(Operation::Branch) | (static_cast<u32>(nonZero) << 4) | (static_cast<u32>(noDelay) << 5) | (static_cast<u32>(srcA) << 11) | (static_cast<u32>(offset) << 14);
+    }
+
+    /**
+     * @return The value of a method address register which selects a method and how much it's incremented after each send
+     */
+    constexpr i32 Method(u16 method, u8 increment) {
+        return method | (increment << 12);
+    }
+
+    constexpr u32 Nop{AddImmediate(Assign::Move, 0, 0, 0)};
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <benchmark/benchmark.h>
+#include <gpu/syncpoint.h>
+
+namespace skyline::test {
+    /**
+     * @brief This benchmarks registering a waiter and deregistering it before it's signalled, as a wait that times out does, while other waiters are pending
+     * @note The argument of the benchmark is the amount of pending waiters, deregistered waiters accumulate in the heap till it's compacted
+     */
+    void WaiterChurn(benchmark::State &benchmark) {
+        gpu::Syncpoint syncpoint;
+        auto liveWaiters{static_cast<u32>(benchmark.range(0))};
+        for (u32 waiter{}; waiter < liveWaiters; waiter++)
+            syncpoint.RegisterWaiter(waiter + 1, [] {});
+
+        u32 threshold{};
+        for (auto _ : benchmark) {
+            auto id{syncpoint.RegisterWaiter(liveWaiters + 1 + (threshold++ % 1024), [] {})};
+            syncpoint.DeregisterWaiter(id);
+        }
+
+        benchmark.SetItemsProcessed(benchmark.iterations());
+    }
+
+    BENCHMARK(WaiterChurn)->Arg(1)->Arg(64)->Arg(4096);
+
+    /**
+     * @brief This benchmarks incrementing a syncpoint which signals one waiter per increment, half of the waiters were deregistered before being signalled
+     * @note The argument of the benchmark is the amount of waiters that are registered
+     */
+    void SignalWaiters(benchmark::State &benchmark) {
+        auto waiterCount{static_cast<u32>(benchmark.range(0))};
+        std::vector<u64> ids(waiterCount);
+        for (auto _ : benchmark) {
+            benchmark.PauseTiming();
+            gpu::Syncpoint syncpoint;
+            for (u32 waiter{}; waiter < waiterCount; waiter++)
+                ids[waiter] = syncpoint.RegisterWaiter(waiter + 1, [] {});
+            for (u32 waiter{}; waiter < waiterCount; waiter += 2)
+                syncpoint.DeregisterWaiter(ids[waiter]);
+            benchmark.ResumeTiming();
+
+            for (u32 waiter{}; waiter < waiterCount; waiter++)
+                syncpoint.Increment();
+        }
+
+        benchmark.SetItemsProcessed(benchmark.iterations() * waiterCount);
+    }
+
+    BENCHMARK(SignalWaiters)->Arg(64)->Arg(4096);
+}
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gtest/gtest.h>
+#include <gpu/syncpoint.h>
+
+namespace skyline::test {
+    TEST(Syncpoint, DeregisteredWaitersAreNotSignalled) {
+        // Most waiters are deregistered so the heap is compacted several times, the remaining waiters have to be signalled in order of their thresholds
+        constexpr u32 WaiterCount{1000};
+        gpu::Syncpoint syncpoint;
+        std::vector<u32> signalled;
+        std::vector<u64> ids;
+        for (u32 waiter{}; waiter < WaiterCount; waiter++)
+            ids.push_back(syncpoint.RegisterWaiter(WaiterCount - waiter, [&signalled, threshold = WaiterCount - waiter] { signalled.push_back(threshold); }));
+
+        std::vector<u32> expected;
+        for (u32 waiter{}; waiter < WaiterCount; waiter++) {
+            if (waiter % 7)
+                syncpoint.DeregisterWaiter(ids[waiter]);
+            else
+                expected.push_back(WaiterCount - waiter);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        for (u32 increment{}; increment < WaiterCount; increment++)
+            syncpoint.Increment();
+        EXPECT_EQ(signalled, expected);
+    }
+
+    TEST(Syncpoint, ReachedThresholdSignalsImmediately) {
+        gpu::Syncpoint syncpoint;
+        syncpoint.Increment();
+
+        bool signalled{};
+        EXPECT_EQ(syncpoint.RegisterWaiter(1, [&signalled] { signalled = true; }), 0);
+        EXPECT_TRUE(signalled);
+    }
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <random>
+#include <benchmark/benchmark.h>
+#include <gpu/format.h>
+
+namespace skyline::test {
+    using namespace gpu;
+
+    /**
+     * @return A surface of random blocks in the supplied format, blocks which are decoded as the ASTC error color are rerolled so the common path of the decoder is measured
+     */
+    std::vector<u8> RandomBlocks(texture::Format format, u32 width, u32 height) {
+        constexpr u32 ErrorColor{0xFFFF00FF};
+
+        std::mt19937_64 random(format.bpb * 0x100 + format.blockWidth * 0x10 + format.blockHeight);
+        std::vector<u8> blocks(format.GetSize(width, height));
+        std::vector<u32> texels(static_cast<size_t>(format.blockWidth) * format.blockHeight);
+        for (auto block{blocks.begin()}; block != blocks.end(); block += format.bpb) {
+            do {
+                for (u8 offset{}; offset < format.bpb; offset += sizeof(u64)) {
+                    u64 value{random()};
+                    std::memcpy(&*(block + offset), &value, sizeof(u64));
+                }
+                format.decode(&*block, reinterpret_cast<u8 *>(texels.data()), format.blockWidth, format.blockHeight, 0);
+            } while (texels[0] == ErrorColor);
+        }
+        return blocks;
+    }
+
+    /**
+     * @brief This benchmarks decoding a 1024x1024 surface of a compressed format into RGBA8888 texels
+     */
+    void DecodeSurface(benchmark::State &benchmark, texture::Format format) {
+        constexpr u32 Width{1024}, Height{1024};
+        auto blocks{RandomBlocks(format, Width, Height)};
+        std::vector<u8> texels(static_cast<size_t>(Width) * Height * sizeof(u32));
+        for (auto _ : benchmark) {
+            format.decode(blocks.data(), texels.data(), Width, Height, 0);
+            benchmark::ClobberMemory();
+        }
+
+        benchmark.SetBytesProcessed(static_cast<i64>(benchmark.iterations() * texels.size()));
+    }
+
+    BENCHMARK_CAPTURE(DecodeSurface, BC1, format::BC1RGBAUnorm);
+    BENCHMARK_CAPTURE(DecodeSurface, BC3, format::BC3Unorm);
+    BENCHMARK_CAPTURE(DecodeSurface, BC5, format::BC5Unorm);
+    BENCHMARK_CAPTURE(DecodeSurface, BC6H, format::BC6HUfloat);
+    BENCHMARK_CAPTURE(DecodeSurface, BC7, format::BC7Unorm);
+    BENCHMARK_CAPTURE(DecodeSurface, ASTC4x4, format::ASTC4x4Unorm);
+    BENCHMARK_CAPTURE(DecodeSurface, ASTC8x8, format::ASTC8x8Unorm);
+}
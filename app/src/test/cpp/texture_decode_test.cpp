@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gtest/gtest.h>
+#include <gpu/format.h>
+
+namespace skyline::test {
+    using namespace gpu;
+
+    /**
+     * @brief This assembles a 128-bit block from bit fields starting from the least significant bit of the first byte, it's the inverse of how decoders read blocks
+     */
+    class BlockWriter {
+      private:
+        std::array<u8, 16> block{};
+        size_t offset{};
+
+      public:
+        /**
+         * @brief Appends a field of the supplied width to the block
+         */
+        BlockWriter &Put(u64 value, size_t width) {
+            for (size_t bit{}; bit < width; bit++, offset++)
+                if ((value >> bit) & 1)
+                    block[offset / 8] |= static_cast<u8>(1 << (offset % 8));
+            return *this;
+        }
+
+        /**
+         * @return The block truncated to the supplied size in bytes
+         */
+        std::vector<u8> Get(size_t size = 16) const {
+            return std::vector<u8>(block.begin(), block.begin() + static_cast<ssize_t>(size));
+        }
+    };
+
+    /**
+     * @return The RGBA8888 texels of a surface which is decoded from the supplied blocks
+     */
+    std::vector<u32> Decode(const texture::Format &format, const std::vector<u8> &blocks, u32 width, u32 height) {
+        std::vector<u32> texels(static_cast<size_t>(width) * height, 0xDEADBEEF);
+        format.decode(blocks.data(), reinterpret_cast<u8 *>(texels.data()), width, height, 0);
+        return texels;
+    }
+
+    constexpr u32 Rgba(u8 red, u8 green, u8 blue, u8 alpha) {
+        return red | (green << 8) | (blue << 16) | (static_cast<u32>(alpha) << 24);
+    }
+
+    /**
+     * @return A BC1 color block with 2-bit indices for the 4 texels of every row, this is also the color half of BC2 and BC3 blocks
+     */
+    std::vector<u8> Bc1Block(u16 color0, u16 color1, u8 rowIndices) {
+        BlockWriter writer;
+        writer.Put(color0, 16).Put(color1, 16);
+        for (u8 row{}; row < 4; row++)
+            writer.Put(rowIndices, 8);
+        return writer.Get(8);
+    }
+
+    /**
+     * @return A BC3 alpha or BC4 block where every row uses the same 3-bit indices
+     */
+    std::vector<u8> InterpolatedBlock(u8 value0, u8 value1, std::array<u8, 4> rowIndices) {
+        BlockWriter writer;
+        writer.Put(value0, 8).Put(value1, 8);
+        for (u8 row{}; row < 4; row++)
+            for (auto index : rowIndices)
+                writer.Put(index, 3);
+        return writer.Get(8);
+    }
+
+    std::vector<u8> Concatenate(std::vector<u8> first, const std::vector<u8> &second) {
+        first.insert(first.end(), second.begin(), second.end());
+        return first;
+    }
+
+    TEST(TextureDecode, Bc1FourColors) {
+        auto texels{Decode(format::BC1RGBAUnorm, Bc1Block(0xFFFF, 0x0000, 0b11100100), 4, 4)};
+        for (size_t row{}; row < 4; row++) {
+            EXPECT_EQ(texels[row * 4], Rgba(255, 255, 255, 255));
+            EXPECT_EQ(texels[row * 4 + 1], Rgba(0, 0, 0, 255));
+            EXPECT_EQ(texels[row * 4 + 2], Rgba(170, 170, 170, 255));
+            EXPECT_EQ(texels[row * 4 + 3], Rgba(85, 85, 85, 255));
+        }
+    }
+
+    TEST(TextureDecode, Bc1ThreeColors) {
+        // The first color not being larger than the second selects the 3-color mode where the fourth index is transparent black
+        auto texels{Decode(format::BC1RGBAUnorm, Bc1Block(0x0000, 0xFFFF, 0b11010011), 4, 4)};
+        for (size_t row{}; row < 4; row++) {
+            EXPECT_EQ(texels[row * 4], Rgba(0, 0, 0, 0));
+            EXPECT_EQ(texels[row * 4 + 1], Rgba(0, 0, 0, 255));
+            EXPECT_EQ(texels[row * 4 + 2], Rgba(255, 255, 255, 255));
+            EXPECT_EQ(texels[row * 4 + 3], Rgba(0, 0, 0, 0));
+        }
+    }
+
+    TEST(TextureDecode, Bc1PartialBlocks) {
+        // A 6x5 surface has 2x2 blocks, only the texels inside the surface are written
+        std::vector<u8> blocks;
+        for (u16 color : {0xF800, 0x07E0, 0x001F, 0xFFFF})
+            blocks = Concatenate(blocks, Bc1Block(color, 0x0000, 0));
+
+        constexpr std::array<u32, 4> Colors{Rgba(255, 0, 0, 255), Rgba(0, 255, 0, 255), Rgba(0, 0, 255, 255), Rgba(255, 255, 255, 255)};
+        auto texels{Decode(format::BC1RGBAUnorm, blocks, 6, 5)};
+        for (u32 y{}; y < 5; y++)
+            for (u32 x{}; x < 6; x++)
+                EXPECT_EQ(texels[y * 6 + x], Colors[(y / 4) * 2 + (x / 4)]) << x << ", " << y;
+    }
+
+    TEST(TextureDecode, Bc2) {
+        // The explicit alpha of a texel is a 4-bit value which is expanded to 8 bits by replication
+        BlockWriter alpha;
+        for (u8 row{}; row < 4; row++)
+            alpha.Put(0x0, 4).Put(0x8, 4).Put(0xF, 4).Put(0x4, 4);
+
+        auto texels{Decode(format::BC2Unorm, Concatenate(alpha.Get(8), Bc1Block(0xFFFF, 0x0000, 0)), 4, 4)};
+        constexpr std::array<u8, 4> Alphas{0, 136, 255, 68};
+        for (size_t index{}; index < texels.size(); index++)
+            EXPECT_EQ(texels[index], Rgba(255, 255, 255, Alphas[index % 4]));
+    }
+
+    TEST(TextureDecode, Bc3) {
+        // The first alpha being larger than the second selects 6 interpolated values, otherwise there are 4 along with 0 and 255
+        auto eightValues{Decode(format::BC3Unorm, Concatenate(InterpolatedBlock(70, 0, {0, 1, 2, 3}), Bc1Block(0x0000, 0x0000, 0)), 4, 4)};
+        auto eightValuesHigh{Decode(format::BC3Unorm, Concatenate(InterpolatedBlock(70, 0, {4, 5, 6, 7}), Bc1Block(0x0000, 0x0000, 0)), 4, 4)};
+        auto sixValues{Decode(format::BC3Unorm, Concatenate(InterpolatedBlock(0, 50, {0, 1, 2, 3}), Bc1Block(0x0000, 0x0000, 0)), 4, 4)};
+        auto sixValuesHigh{Decode(format::BC3Unorm, Concatenate(InterpolatedBlock(0, 50, {4, 5, 6, 7}), Bc1Block(0x0000, 0x0000, 0)), 4, 4)};
+
+        constexpr std::array<u8, 8> EightValueAlphas{70, 0, 60, 50, 40, 30, 20, 10};
+        constexpr std::array<u8, 8> SixValueAlphas{0, 50, 10, 20, 30, 40, 0, 255};
+        for (size_t index{}; index < 16; index++) {
+            EXPECT_EQ(eightValues[index], Rgba(0, 0, 0, EightValueAlphas[index % 4]));
+            EXPECT_EQ(eightValuesHigh[index], Rgba(0, 0, 0, EightValueAlphas[index % 4 + 4]));
+            EXPECT_EQ(sixValues[index], Rgba(0, 0, 0, SixValueAlphas[index % 4]));
+            EXPECT_EQ(sixValuesHigh[index], Rgba(0, 0, 0, SixValueAlphas[index % 4 + 4]));
+        }
+    }
+
+    TEST(TextureDecode, Bc4AndBc5) {
+        auto red{Decode(format::BC4Unorm, InterpolatedBlock(70, 0, {0, 1, 2, 3}), 4, 4)};
+        auto redGreen{Decode(format::BC5Unorm, Concatenate(InterpolatedBlock(70, 0, {0, 1, 2, 3}), InterpolatedBlock(0, 50, {4, 5, 6, 7})), 4, 4)};
+
+        constexpr std::array<u8, 4> Reds{70, 0, 60, 50};
+        constexpr std::array<u8, 4> Greens{30, 40, 0, 255};
+        for (size_t index{}; index < 16; index++) {
+            EXPECT_EQ(red[index], Rgba(Reds[index % 4], 0, 0, 255));
+            EXPECT_EQ(redGreen[index], Rgba(Reds[index % 4], Greens[index % 4], 0, 255));
+        }
+    }
+
+    TEST(TextureDecode, Bc6hMode11) {
+        // Mode 11 has a single region with 10-bit endpoints, the largest value is the largest finite half-float which is clamped to 1
+        BlockWriter writer;
+        writer.Put(0b00011, 5);
+        writer.Put(1023, 10).Put(0, 10).Put(1023, 10); // Endpoint 0 (RGB)
+        writer.Put(1023, 10).Put(0, 10).Put(1023, 10); // Endpoint 1 (RGB)
+
+        auto texels{Decode(format::BC6HUfloat, writer.Get(), 4, 4)};
+        for (auto texel : texels)
+            EXPECT_EQ(texel, Rgba(255, 0, 255, 255));
+    }
+
+    TEST(TextureDecode, Bc7Mode6) {
+        // Mode 6 has a single subset with 7-bit RGBA endpoints and a P-bit per endpoint that's appended as the lowest bit
+        BlockWriter writer;
+        writer.Put(1 << 6, 7);
+        writer.Put(127, 7).Put(127, 7); // Red
+        writer.Put(0, 7).Put(0, 7); // Green
+        writer.Put(64, 7).Put(64, 7); // Blue
+        writer.Put(127, 7).Put(127, 7); // Alpha
+        writer.Put(1, 1).Put(1, 1); // P-bits
+        for (u8 index{}; index < 16; index++)
+            writer.Put(index, index ? 4 : 3);
+
+        auto texels{Decode(format::BC7Unorm, writer.Get(), 4, 4)};
+        for (auto texel : texels)
+            EXPECT_EQ(texel, Rgba(255, 1, 129, 255));
+    }
+
+    TEST(TextureDecode, Bc7ReservedMode) {
+        // A block without a mode bit is reserved and decodes to transparent black
+        auto texels{Decode(format::BC7Unorm, std::vector<u8>(16), 4, 4)};
+        for (auto texel : texels)
+            EXPECT_EQ(texel, Rgba(0, 0, 0, 0));
+    }
+
+    /**
+     * @brief The ASTC formats of every 2D footprint along with their block dimensions
+     */
+    const std::array<texture::Format, 14> AstcFormats{format::ASTC4x4Unorm, format::ASTC5x4Unorm, format::ASTC5x5Unorm, format::ASTC6x5Unorm, format::ASTC6x6Unorm, format::ASTC8x5Unorm, format::ASTC8x6Unorm, format::ASTC8x8Unorm, format::ASTC10x5Unorm, format::ASTC10x6Unorm, format::ASTC10x8Unorm, format::ASTC10x10Unorm, format::ASTC12x10Unorm, format::ASTC12x12Unorm};
+
+    TEST(TextureDecode, AstcVoidExtent) {
+        // A void-extent block has a single constant color of 16-bit UNORM components of which the top 8 bits are used
+        BlockWriter writer;
+        writer.Put(0xFFFFFFFFFFFFFDFC, 64);
+        writer.Put(0xFFFF, 16).Put(0x8000, 16).Put(0x0000, 16).Put(0xFFFF, 16);
+        auto block{writer.Get()};
+
+        for (auto format : AstcFormats) {
+            // The surface isn't a multiple of the block size so partial blocks at the edges are decoded as well
+            u32 width{format.blockWidth * 2U + 1}, height{format.blockHeight * 2U - 1};
+            std::vector<u8> blocks;
+            for (size_t index{}; index < format.GetSize(width, height) / block.size(); index++)
+                blocks = Concatenate(blocks, block);
+
+            auto texels{Decode(format, blocks, width, height)};
+            for (auto texel : texels)
+                ASSERT_EQ(texel, Rgba(255, 128, 0, 255)) << static_cast<u32>(format.blockWidth) << "x" << static_cast<u32>(format.blockHeight);
+        }
+    }
+
+    TEST(TextureDecode, AstcReservedBlockMode) {
+        // A block mode of zero is reserved so the block is decoded as the error color
+        for (const auto &format : AstcFormats) {
+            auto texels{Decode(format, std::vector<u8>(16), format.blockWidth, format.blockHeight)};
+            for (auto texel : texels)
+                ASSERT_EQ(texel, Rgba(255, 0, 255, 255));
+        }
+    }
+
+    TEST(TextureDecode, GuestFormats) {
+        EXPECT_EQ(format::GetFormat(format::TextureFormat::A8R8G8B8).vkFormat, format::RGBA8888Unorm.vkFormat);
+        EXPECT_EQ(format::GetFormat(format::TextureFormat::BC1).vkFormat, format::BC1RGBAUnorm.vkFormat);
+        EXPECT_EQ(format::GetFormat(format::TextureFormat::BC6HUfloat).vkFormat, format::BC6HUfloat.vkFormat);
+        EXPECT_EQ(format::GetFormat(format::TextureFormat::BC7).vkFormat, format::BC7Unorm.vkFormat);
+
+        constexpr std::array<format::TextureFormat, 14> AstcTextureFormats{format::TextureFormat::ASTC4x4, format::TextureFormat::ASTC5x4, format::TextureFormat::ASTC5x5, format::TextureFormat::ASTC6x5, format::TextureFormat::ASTC6x6, format::TextureFormat::ASTC8x5, format::TextureFormat::ASTC8x6, format::TextureFormat::ASTC8x8, format::TextureFormat::ASTC10x5, format::TextureFormat::ASTC10x6, format::TextureFormat::ASTC10x8, format::TextureFormat::ASTC10x10, format::TextureFormat::ASTC12x10, format::TextureFormat::ASTC12x12};
+        for (size_t index{}; index < AstcFormats.size(); index++) {
+            auto guestFormat{format::GetFormat(AstcTextureFormats[index])};
+            EXPECT_EQ(guestFormat.vkFormat, AstcFormats[index].vkFormat);
+            EXPECT_EQ(guestFormat.decode, AstcFormats[index].decode);
+        }
+
+        EXPECT_THROW(format::GetFormat(static_cast<format::TextureFormat>(0x01)), exception);
+    }
+}
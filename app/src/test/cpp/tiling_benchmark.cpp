@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <benchmark/benchmark.h>
+#include <gpu/tiling.h>
+#include <thread_pool.h>
+
+namespace skyline::test {
+    using namespace gpu::texture;
+
+    constexpr u8 BenchmarkBlockHeight{16}; //!< The block height in GOBs that's used by titles for most render targets
+
+    /**
+     * @brief This benchmarks deswizzling or swizzling an entire 2D surface
+     * @param deswizzle If the surface is deswizzled rather than swizzled
+     * @param parallel If the copy is split across a thread pool
+     * @note The arguments of the benchmark are the width and height of the surface in texels and its bytes per texel
+     */
+    void CopySurface(benchmark::State &benchmark, bool deswizzle, bool parallel) {
+        Dimensions dimensions(static_cast<u32>(benchmark.range(0)), static_cast<u32>(benchmark.range(1)));
+        auto bpb{static_cast<u8>(benchmark.range(2))};
+        ThreadPool pool(4);
+
+        std::vector<u8> blockLinear(GetBlockLinearLevelSize(dimensions, bpb, BenchmarkBlockHeight, 1), 0xAB);
+        std::vector<u8> linear(static_cast<size_t>(dimensions.width) * dimensions.height * bpb, 0xCD);
+        for (auto _ : benchmark) {
+            if (deswizzle)
+                CopyBlockLinearToLinear(dimensions, bpb, dimensions.width, BenchmarkBlockHeight, 1, blockLinear.data(), linear.data(), 0, parallel ? &pool : nullptr);
+            else
+                CopyLinearToBlockLinear(dimensions, bpb, dimensions.width, BenchmarkBlockHeight, 1, linear.data(), blockLinear.data(), 0, parallel ? &pool : nullptr);
+            benchmark::ClobberMemory();
+        }
+
+        benchmark.SetBytesProcessed(static_cast<i64>(benchmark.iterations() * linear.size()));
+    }
+
+    BENCHMARK_CAPTURE(CopySurface, Deswizzle, true, false)->Args({1280, 720, 4})->Args({1920, 1080, 4})->Args({1920, 1080, 16})->Args({256, 256, 4});
+    BENCHMARK_CAPTURE(CopySurface, DeswizzleParallel, true, true)->Args({1280, 720, 4})->Args({1920, 1080, 4})->Args({1920, 1080, 16})->UseRealTime();
+    BENCHMARK_CAPTURE(CopySurface, Swizzle, false, false)->Args({1280, 720, 4})->Args({1920, 1080, 4})->Args({256, 256, 4});
+
+    /**
+     * @brief This benchmarks deswizzling a region of a 1080p RGBA8888 surface, such as a partial texture update
+     * @note The arguments of the benchmark are the X and Y positions of the region along with its width and height, unaligned positions require partial GOBs to be copied
+     */
+    void CopyRegion(benchmark::State &benchmark) {
+        Dimensions surface(1920, 1080);
+        constexpr u8 Bpb{4};
+        Origin origin{static_cast<u32>(benchmark.range(0)), static_cast<u32>(benchmark.range(1))};
+        Dimensions region(static_cast<u32>(benchmark.range(2)), static_cast<u32>(benchmark.range(3)));
+
+        std::vector<u8> blockLinear(GetBlockLinearLevelSize(surface, Bpb, BenchmarkBlockHeight, 1), 0xAB);
+        std::vector<u8> linear(static_cast<size_t>(region.width) * region.height * Bpb);
+        for (auto _ : benchmark) {
+            CopyBlockLinearToLinear(surface, origin, region, Bpb, BenchmarkBlockHeight, 1, blockLinear.data(), linear.data());
+            benchmark::ClobberMemory();
+        }
+
+        benchmark.SetBytesProcessed(static_cast<i64>(benchmark.iterations() * linear.size()));
+    }
+
+    BENCHMARK(CopyRegion)->Args({0, 0, 256, 256})->Args({3, 5, 256, 256})->Args({0, 0, 1920, 8});
+
+    /**
+     * @brief This benchmarks deswizzling an entire mipmapped 2D texture
+     * @note The argument of the benchmark is the width and height of the base level in texels
+     */
+    void CopyTexture(benchmark::State &benchmark) {
+        Format format{.bpb = 4, .blockHeight = 1, .blockWidth = 1, .vkFormat = vk::Format::eR8G8B8A8Unorm};
+        Dimensions dimensions(static_cast<u32>(benchmark.range(0)), static_cast<u32>(benchmark.range(0)));
+        auto levelCount{static_cast<u32>(std::bit_width(dimensions.width))};
+
+        size_t linearSize{};
+        for (u32 level{}; level < levelCount; level++)
+            linearSize += format.GetSize(std::max(dimensions.width >> level, 1U), std::max(dimensions.height >> level, 1U));
+
+        std::vector<u8> blockLinear(GetBlockLinearLayerSize(dimensions, format, BenchmarkBlockHeight, 1, levelCount), 0xAB);
+        std::vector<u8> linear(linearSize);
+        for (auto _ : benchmark) {
+            CopyBlockLinearToLinear(dimensions, format, BenchmarkBlockHeight, 1, levelCount, 1, blockLinear.data(), linear.data());
+            benchmark::ClobberMemory();
+        }
+
+        benchmark.SetBytesProcessed(static_cast<i64>(benchmark.iterations() * linear.size()));
+    }
+
+    BENCHMARK(CopyTexture)->Arg(256)->Arg(1024);
+}
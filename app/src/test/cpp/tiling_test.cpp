@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <bit>
+#include <random>
+#include <set>
+#include <gtest/gtest.h>
+#include <gpu/tiling.h>
+#include <thread_pool.h>
+
+namespace skyline::test {
+    using namespace gpu::texture;
+
+    /**
+     * @return A buffer of the supplied size filled with random bytes
+     */
+    std::vector<u8> RandomBytes(size_t size, u32 seed) {
+        std::mt19937 random(seed);
+        std::vector<u8> bytes(size);
+        for (auto &byte : bytes)
+            byte = static_cast<u8>(random());
+        return bytes;
+    }
+
+    /**
+     * @return An uncompressed format with the supplied bytes per texel
+     */
+    Format UncompressedFormat(u8 bpb) {
+        return Format{.bpb = bpb, .blockHeight = 1, .blockWidth = 1, .vkFormat = vk::Format::eUndefined};
+    }
+
+    /**
+     * @brief The block-linear deswizzler that Texture::SynchronizeHost used before the tiling functions, this is kept as a reference for them
+     * @note This writes entire GOBs, the output has a pitch of the ROB width in bytes and has to hold every ROB in full
+     * @note This drops the lines of a partial GOB at the end of the surface, so it's only a reference for surfaces with a height that's a multiple of a GOB
+     */
+    void LegacyDeswizzle(Dimensions dimensions, const Format &format, u32 surfaceWidth, u8 guestBlockHeight, const u8 *texture, u8 *output) {
+        constexpr u8 sectorWidth = 16; // The width of a sector in bytes
+        constexpr u8 sectorHeight = 2; // The height of a sector in lines
+        constexpr u8 gobWidth = 64; // The width of a GOB in bytes
+        constexpr u8 gobHeight = 8; // The height of a GOB in lines
+
+        auto blockHeight = guestBlockHeight; // The height of the blocks in GOBs
+        auto robHeight = gobHeight * blockHeight; // The height of a single ROB (Row of Blocks) in lines
+        auto surfaceHeight = dimensions.height / format.blockHeight; // The height of the surface in lines
+        auto surfaceHeightRobs = util::AlignUp(surfaceHeight, robHeight) / robHeight; // The height of the surface in ROBs (Row Of Blocks)
+        auto robWidthBytes = util::AlignUp((surfaceWidth / format.blockWidth) * format.bpb, gobWidth); // The width of a ROB in bytes
+        auto robWidthBlocks = robWidthBytes / gobWidth; // The width of a ROB in blocks (and GOBs because block width == 1 on the Tegra X1)
+        auto robBytes = robWidthBytes * robHeight; // The size of a ROB in bytes
+        auto gobYOffset = robWidthBytes * gobHeight; // The offset of the next Y-axis GOB from the current one in linear space
+
+        auto inputSector = texture; // The address of the input sector
+        auto outputRob = output; // The address of the output block
+
+        for (u32 rob = 0, y = 0, paddingY = 0; rob < surfaceHeightRobs; rob++) { // Every Surface contains `surfaceHeightRobs` ROBs
+            auto outputBlock = outputRob; // We iterate through a block independently of the ROB
+            for (u32 block = 0; block < robWidthBlocks; block++) { // Every ROB contains `surfaceWidthBlocks` Blocks
+                auto outputGob = outputBlock; // We iterate through a GOB independently of the block
+                for (u32 gobY = 0; gobY < blockHeight; gobY++) { // Every Block contains `blockHeight` Y-axis GOBs
+                    for (u32 index = 0; index < sectorWidth * sectorHeight; index++) { // Every Y-axis GOB contains `sectorWidth * sectorHeight` sectors
+                        u32 xT = ((index << 3) & 0b10000) | ((index << 1) & 0b100000); // Morton-Swizzle on the X-axis
+                        u32 yT = ((index >> 1) & 0b110) | (index & 0b1); // Morton-Swizzle on the Y-axis
+                        std::memcpy(outputGob + (yT * robWidthBytes) + xT, inputSector, sectorWidth);
+                        inputSector += sectorWidth; // `sectorWidth` bytes are of sequential image data
+                    }
+                    outputGob += gobYOffset; // Increment the output GOB to the next Y-axis GOB
+                }
+                inputSector += paddingY; // Increment the input sector to the next sector
+                outputBlock += gobWidth; // Increment the output block to the next block (As Block Width = 1 GOB Width)
+            }
+            outputRob += robBytes; // Increment the output block to the next ROB
+
+            y += robHeight; // Increment the Y position to the next ROB
+            blockHeight = static_cast<u8>(std::min(static_cast<u32>(blockHeight), (surfaceHeight - y) / gobHeight)); // Calculate the amount of Y GOBs which aren't padding
+            paddingY = (guestBlockHeight - blockHeight) * (sectorWidth * sectorWidth * sectorHeight); // Calculate the amount of padding between contiguous sectors
+        }
+    }
+
+    /**
+     * @brief This checks that CopyBlockLinearToLinear produces the same output as the legacy deswizzler for every format size, block height and width up to three GOBs along with a range of heights around the block height
+     */
+    TEST(Tiling, MatchesLegacyDeswizzler) {
+        for (u8 bpb : {1, 2, 4, 8, 16}) {
+            auto format{UncompressedFormat(bpb)};
+            for (u8 blockHeight : {1, 2, 4, 8, 16, 32}) {
+                std::set<u32> heightsGobs{1, std::max(blockHeight - 1U, 1U), blockHeight, blockHeight + 1U, (blockHeight * 2U) + 1};
+                for (auto heightGobs : heightsGobs) {
+                    for (u32 width{1}; width * bpb <= constant::GobWidth * 3; width++) {
+                        Dimensions dimensions(width, heightGobs * constant::GobHeight);
+                        auto input{RandomBytes(GetBlockLinearLevelSize(dimensions, bpb, blockHeight, 1), width * heightGobs)};
+
+                        auto pitch{util::AlignUp(width * bpb, constant::GobWidth)};
+                        std::vector<u8> expected(static_cast<size_t>(pitch) * util::AlignUp(dimensions.height, constant::GobHeight * blockHeight));
+                        LegacyDeswizzle(dimensions, format, width, blockHeight, input.data(), expected.data());
+
+                        std::vector<u8> output(static_cast<size_t>(pitch) * dimensions.height);
+                        CopyBlockLinearToLinear(dimensions, bpb, width, blockHeight, 1, input.data(), output.data(), pitch);
+
+                        for (u32 line{}; line < dimensions.height; line++)
+                            ASSERT_EQ(std::memcmp(expected.data() + (line * pitch), output.data() + (line * pitch), width * bpb), 0) << "Line " << line << " differs for a " << width << "x" << dimensions.height << " surface with " << static_cast<u32>(bpb) << " bytes per texel and blocks of " << static_cast<u32>(blockHeight) << " GOBs";
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief This checks that mip levels of compressed formats are laid out with their texel dimensions halved before they're rounded up to format blocks
+     */
+    TEST(Tiling, CompressedMipLevels) {
+        Format bc1{.bpb = 8, .blockHeight = 4, .blockWidth = 4, .vkFormat = vk::Format::eBc1RgbaUnormBlock};
+        Dimensions dimensions(20, 20);
+        constexpr u8 BlockHeight{2};
+        const std::array<Dimensions, 5> levels{Dimensions(5, 5), Dimensions(3, 3), Dimensions(2, 2), Dimensions(1, 1), Dimensions(1, 1)}; //!< The dimensions of each level in blocks
+
+        std::array<size_t, levels.size()> levelOffsets{}; //!< The offsets of each level in the block-linear layer
+        std::array<u8, levels.size()> levelBlockHeights{};
+        size_t layerSize{}, linearSize{};
+        for (size_t level{}; level < levels.size(); level++) {
+            u8 blockHeight{BlockHeight}, blockDepth{1};
+            GetBlockLinearLevelBlockSize(levels[level], blockHeight, blockDepth);
+            levelOffsets[level] = layerSize;
+            levelBlockHeights[level] = blockHeight;
+            layerSize += GetBlockLinearLevelSize(levels[level], bc1.bpb, blockHeight, blockDepth);
+            linearSize += static_cast<size_t>(levels[level].width) * levels[level].height * bc1.bpb;
+        }
+        layerSize = util::AlignUp(layerSize, constant::GobSize * levelBlockHeights[0]); // Layers are aligned to a block of the base level
+        ASSERT_EQ(GetBlockLinearLayerSize(dimensions, bc1, BlockHeight, 1, levels.size()), layerSize);
+
+        auto input{RandomBytes(layerSize, 20)};
+        std::vector<u8> output(linearSize);
+        CopyBlockLinearToLinear(dimensions, bc1, BlockHeight, 1, levels.size(), 1, input.data(), output.data());
+
+        auto linearLevel{output.data()};
+        for (size_t level{}; level < levels.size(); level++) {
+            std::vector<u8> expected(static_cast<size_t>(levels[level].width) * levels[level].height * bc1.bpb);
+            CopyBlockLinearToLinear(levels[level], bc1.bpb, levels[level].width, levelBlockHeights[level], 1, input.data() + levelOffsets[level], expected.data());
+            ASSERT_EQ(std::memcmp(expected.data(), linearLevel, expected.size()), 0) << "Level " << level << " differs";
+            linearLevel += expected.size();
+        }
+    }
+
+    /**
+     * @brief This generates random surfaces to check properties of the tiling functions against
+     */
+    class RandomSurfaceGenerator {
+      private:
+        std::mt19937 random;
+
+      public:
+        RandomSurfaceGenerator(u32 seed) : random(seed) {}
+
+        /**
+         * @return A random value in the range [min, max]
+         */
+        u32 Pick(u32 min, u32 max) {
+            return std::uniform_int_distribution<u32>(min, max)(random);
+        }
+
+        /**
+         * @return A random power of two in the range [1, max]
+         */
+        u8 PickPowerOfTwo(u8 max) {
+            return static_cast<u8>(1U << Pick(0, static_cast<u32>(std::countr_zero(max))));
+        }
+
+        u8 PickBpb() {
+            return PickPowerOfTwo(16);
+        }
+
+        /**
+         * @return Random dimensions which are 3D for a quarter of the surfaces
+         */
+        Dimensions PickDimensions(u32 maxSize) {
+            return Dimensions(Pick(1, maxSize), Pick(1, maxSize), (Pick(0, 3) == 0) ? Pick(2, 8) : 1);
+        }
+
+        /**
+         * @return A random region inside of the surface
+         */
+        std::pair<Origin, Dimensions> PickRegion(Dimensions surface) {
+            Origin origin{Pick(0, surface.width - 1), Pick(0, surface.height - 1), Pick(0, surface.depth - 1)};
+            Dimensions region(Pick(1, surface.width - origin.x), Pick(1, surface.height - origin.y), Pick(1, surface.depth - origin.z));
+            return {origin, region};
+        }
+    };
+
+    /**
+     * @brief This checks that deswizzling a swizzled surface returns the original surface, for regions narrower than the block-linear surface and for surfaces large enough to be split across a thread pool
+     */
+    TEST(Tiling, SwizzleRoundTrip) {
+        RandomSurfaceGenerator generator(0x711E);
+        ThreadPool pool(4);
+
+        for (size_t iteration{}; iteration < 500; iteration++) {
+            auto bpb{generator.PickBpb()};
+            auto dimensions{(iteration % 50 == 0) ? Dimensions(generator.Pick(512, 1024), generator.Pick(512, 1024)) : generator.PickDimensions(300)};
+            auto surfaceWidth{dimensions.width + ((generator.Pick(0, 1) == 0) ? 0 : generator.Pick(1, 64))};
+            auto blockHeight{generator.PickPowerOfTwo(32)};
+            auto blockDepth{(dimensions.depth > 1) ? generator.PickPowerOfTwo(4) : u8{1}};
+
+            auto input{RandomBytes(static_cast<size_t>(dimensions.width) * dimensions.height * dimensions.depth * bpb, static_cast<u32>(iteration))};
+            std::vector<u8> blockLinear(GetBlockLinearLevelSize(Dimensions(surfaceWidth, dimensions.height, dimensions.depth), bpb, blockHeight, blockDepth));
+            std::vector<u8> output(input.size());
+
+            CopyLinearToBlockLinear(dimensions, bpb, surfaceWidth, blockHeight, blockDepth, input.data(), blockLinear.data(), 0, &pool);
+            CopyBlockLinearToLinear(dimensions, bpb, surfaceWidth, blockHeight, blockDepth, blockLinear.data(), output.data(), 0, &pool);
+
+            ASSERT_EQ(input, output) << "Iteration " << iteration << ": " << dimensions.width << "x" << dimensions.height << "x" << dimensions.depth << " in a " << surfaceWidth << " wide surface with " << static_cast<u32>(bpb) << " bytes per texel and " << static_cast<u32>(blockHeight) << "x" << static_cast<u32>(blockDepth) << " GOB blocks";
+        }
+    }
+
+    /**
+     * @brief This checks that copies of regions of a block-linear surface match the same region of a copy of the entire surface, and that writing a region doesn't touch anything outside of it
+     */
+    TEST(Tiling, BlockLinearRegions) {
+        RandomSurfaceGenerator generator(0x2E610);
+
+        for (size_t iteration{}; iteration < 500; iteration++) {
+            auto bpb{generator.PickBpb()};
+            auto surface{generator.PickDimensions(200)};
+            auto [origin, region] = generator.PickRegion(surface);
+            auto blockHeight{generator.PickPowerOfTwo(32)};
+            auto blockDepth{(surface.depth > 1) ? generator.PickPowerOfTwo(4) : u8{1}};
+
+            auto blockLinear{RandomBytes(GetBlockLinearLevelSize(surface, bpb, blockHeight, blockDepth), static_cast<u32>(iteration))};
+            size_t surfacePitch{static_cast<size_t>(surface.width) * bpb}, surfaceSliceSize{surfacePitch * surface.height};
+            std::vector<u8> full(surfaceSliceSize * surface.depth);
+            CopyBlockLinearToLinear(surface, bpb, surface.width, blockHeight, blockDepth, blockLinear.data(), full.data());
+
+            // The region is copied with a pitch wider than it to check that the pitch is respected
+            size_t regionPitch{(static_cast<size_t>(region.width) * bpb) + generator.Pick(0, 16)};
+            std::vector<u8> regionOutput(regionPitch * region.height * region.depth);
+            CopyBlockLinearToLinear(surface, origin, region, bpb, blockHeight, blockDepth, blockLinear.data(), regionOutput.data(), regionPitch);
+
+            auto RegionLine = [&](std::vector<u8> &linear, u32 y, u32 z) {
+                return linear.data() + ((origin.z + z) * surfaceSliceSize) + ((origin.y + y) * surfacePitch) + (origin.x * bpb);
+            };
+
+            for (u32 z{}; z < region.depth; z++)
+                for (u32 y{}; y < region.height; y++)
+                    ASSERT_EQ(std::memcmp(RegionLine(full, y, z), regionOutput.data() + ((z * region.height) + y) * regionPitch, region.width * bpb), 0) << "Iteration " << iteration << ": line " << y << " of slice " << z << " differs";
+
+            // Writing a region into the block-linear surface should only change the region
+            auto regionInput{RandomBytes(regionOutput.size(), static_cast<u32>(iteration) + 1)};
+            CopyLinearToBlockLinear(surface, origin, region, bpb, blockHeight, blockDepth, regionInput.data(), blockLinear.data(), regionPitch);
+
+            for (u32 z{}; z < region.depth; z++)
+                for (u32 y{}; y < region.height; y++)
+                    std::memcpy(RegionLine(full, y, z), regionInput.data() + ((z * region.height) + y) * regionPitch, region.width * bpb);
+
+            std::vector<u8> modified(full.size());
+            CopyBlockLinearToLinear(surface, bpb, surface.width, blockHeight, blockDepth, blockLinear.data(), modified.data());
+            ASSERT_EQ(full, modified) << "Iteration " << iteration << ": writing a region had a different effect on the surface";
+        }
+    }
+
+    /**
+     * @brief This checks that regions written to a pitch-linear surface are read back unchanged and that nothing outside of them is written
+     */
+    TEST(Tiling, PitchLinearRegions) {
+        RandomSurfaceGenerator generator(0x917C4);
+
+        for (size_t iteration{}; iteration < 500; iteration++) {
+            auto bpb{generator.PickBpb()};
+            auto surface{generator.PickDimensions(200)};
+            surface.depth = 1;
+            auto [origin, region] = generator.PickRegion(surface);
+            size_t pitch{(static_cast<size_t>(surface.width) * bpb) + generator.Pick(0, 64)};
+
+            auto pitchLinear{RandomBytes(pitch * surface.height, static_cast<u32>(iteration))};
+            auto expected{pitchLinear};
+            auto input{RandomBytes(static_cast<size_t>(region.width) * region.height * bpb, static_cast<u32>(iteration) + 1)};
+            CopyLinearToPitchLinear(origin, region, bpb, pitch, input.data(), pitchLinear.data());
+
+            size_t lineSize{static_cast<size_t>(region.width) * bpb};
+            for (u32 y{}; y < region.height; y++)
+                std::memcpy(expected.data() + ((origin.y + y) * pitch) + (origin.x * bpb), input.data() + (y * lineSize), lineSize);
+            ASSERT_EQ(expected, pitchLinear) << "Iteration " << iteration << ": writing a region had a different effect on the surface";
+
+            std::vector<u8> output(input.size());
+            CopyPitchLinearToLinear(origin, region, bpb, pitch, pitchLinear.data(), output.data());
+            ASSERT_EQ(input, output) << "Iteration " << iteration << ": the region differs after being read back";
+        }
+    }
+
+    /**
+     * @brief This checks that every mip level of every layer of a texture survives being swizzled and deswizzled for both uncompressed and block-compressed formats
+     */
+    TEST(Tiling, TextureRoundTrip) {
+        RandomSurfaceGenerator generator(0x3E7E1);
+
+        for (size_t iteration{}; iteration < 200; iteration++) {
+            auto compressed{generator.Pick(0, 1) == 1};
+            Format format{.bpb = compressed ? static_cast<u8>(generator.Pick(0, 1) ? 16 : 8) : generator.PickBpb(), .blockHeight = static_cast<u16>(compressed ? 4 : 1), .blockWidth = static_cast<u16>(compressed ? 4 : 1), .vkFormat = vk::Format::eUndefined};
+            auto dimensions{generator.PickDimensions(256)};
+            auto levelCount{generator.Pick(1, static_cast<u32>(std::bit_width(std::max({dimensions.width, dimensions.height, dimensions.depth}))))};
+            auto layerCount{generator.Pick(1, 3)};
+            auto blockHeight{generator.PickPowerOfTwo(32)};
+            auto blockDepth{(dimensions.depth > 1) ? generator.PickPowerOfTwo(4) : u8{1}};
+
+            size_t linearLayerSize{};
+            for (u32 level{}; level < levelCount; level++) {
+                Dimensions levelDimensions(std::max(dimensions.width >> level, 1U), std::max(dimensions.height >> level, 1U), std::max(dimensions.depth >> level, 1U));
+                linearLayerSize += format.GetSize(levelDimensions);
+            }
+
+            auto input{RandomBytes(linearLayerSize * layerCount, static_cast<u32>(iteration))};
+            std::vector<u8> blockLinear(GetBlockLinearLayerSize(dimensions, format, blockHeight, blockDepth, levelCount) * layerCount);
+            std::vector<u8> output(input.size());
+
+            CopyLinearToBlockLinear(dimensions, format, blockHeight, blockDepth, levelCount, layerCount, input.data(), blockLinear.data());
+            CopyBlockLinearToLinear(dimensions, format, blockHeight, blockDepth, levelCount, layerCount, blockLinear.data(), output.data());
+
+            ASSERT_EQ(input, output) << "Iteration " << iteration << ": " << dimensions.width << "x" << dimensions.height << "x" << dimensions.depth << " with " << levelCount << " levels and " << layerCount << " layers";
+        }
+    }
+}